@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "graphics/mesh/animmath.h"
+#include "bench.h"
+
+using zenkit::AnimationSample;
+
+// humanoid skeletons in the game have 50-70 nodes
+static constexpr size_t BoneCount = 64;
+
+static glm::quat normalize(float x, float y, float z, float w) {
+  const float len = std::sqrt(x*x+y*y+z*z+w*w);
+  glm::quat   q;
+  q.x = x/len;
+  q.y = y/len;
+  q.z = z/len;
+  q.w = w/len;
+  return q;
+  }
+
+static glm::quat randomRotation(std::mt19937& rnd) {
+  std::normal_distribution<float> n(0.f,1.f);
+  return normalize(n(rnd),n(rnd),n(rnd),n(rnd));
+  }
+
+static void benchNlerp(std::mt19937& rnd) {
+  // two neighbouring key-frames: small rotation between them, random sign of quaternion
+  std::vector<AnimationSample> x(BoneCount), y(BoneCount), a(BoneCount), b(BoneCount);
+  std::uniform_real_distribution<float> delta(-0.05f,0.05f);
+  for(size_t i=0; i<BoneCount; ++i) {
+    x[i].rotation = randomRotation(rnd);
+    // odd bones: same orientation, opposite quaternion sign
+    const float sign = (i%2==0) ? 1.f : -1.f;
+    auto&       q    = x[i].rotation;
+    y[i].rotation = normalize(sign*(q.x+delta(rnd)), sign*(q.y+delta(rnd)), sign*(q.z+delta(rnd)), sign*(q.w+delta(rnd)));
+    x[i].position = glm::vec3(float(i),0.f,0.f);
+    y[i].position = glm::vec3(float(i),1.f,0.f);
+    }
+
+  const float t = 0.37f;
+  const double slerp = Bench::measure([&]() {
+    for(size_t i=0; i<BoneCount; ++i)
+      a[i] = mix(x[i],y[i],t);
+    Bench::keep(a[0].rotation.x);
+    });
+  const double nlerp = Bench::measure([&]() {
+    mix(b.data(),x.data(),y.data(),BoneCount,t);
+    Bench::keep(b[0].rotation.x);
+    });
+
+  // angular error of nlerp against slerp, in degrees
+  float maxErr = 0;
+  for(size_t i=0; i<BoneCount; ++i) {
+    auto& p = a[i].rotation;
+    auto& q = b[i].rotation;
+    float dot = std::fabs(p.x*q.x+p.y*q.y+p.z*q.z+p.w*q.w);
+    maxErr = std::max(maxErr, 2.f*std::acos(std::min(dot,1.f))*180.f/float(M_PI));
+    }
+
+  char name[64] = {};
+  std::snprintf(name,sizeof(name),"key-frame mix x%zu, slerp per bone",BoneCount);
+  Bench::report(name,slerp);
+  std::snprintf(name,sizeof(name),"key-frame mix x%zu, batched nlerp",BoneCount);
+  Bench::report(name,nlerp,slerp);
+  std::printf("  %-44s %10.1f / %.1f M bones/s, max error %.4f deg\n", "  throughput",
+              double(BoneCount)*1e3/slerp, double(BoneCount)*1e3/nlerp, double(maxErr));
+  }
+
+struct Node {
+  size_t parent = size_t(-1);
+  };
+
+// Pose::implMkSkeleton before flat order: scan all nodes for children of every parent
+static void mkRecursive(const std::vector<Node>& nodes, const AnimationSample* smp,
+                        std::vector<Tempest::Matrix4x4>& tr, const Tempest::Matrix4x4& mt, size_t parent) {
+  for(size_t i=0; i<nodes.size(); ++i) {
+    if(nodes[i].parent!=parent)
+      continue;
+    tr[i] = mt*mkMatrix(smp[i]);
+    mkRecursive(nodes,smp,tr,tr[i],i);
+    }
+  }
+
+// same walk as Skeleton::mkOrder + Pose::implMkSkeleton
+static std::vector<uint16_t> mkOrder(const std::vector<Node>& nodes) {
+  std::vector<uint16_t> order;
+  for(size_t i=0; i<nodes.size(); ++i)
+    if(nodes[i].parent==size_t(-1))
+      order.push_back(uint16_t(i));
+  for(size_t r=0; r<order.size(); ++r)
+    for(size_t i=0; i<nodes.size(); ++i)
+      if(nodes[i].parent==order[r])
+        order.push_back(uint16_t(i));
+  return order;
+  }
+
+static void mkFlat(const std::vector<Node>& nodes, const std::vector<uint16_t>& order, const AnimationSample* smp,
+                   std::vector<Tempest::Matrix4x4>& tr, const Tempest::Matrix4x4& mt) {
+  for(size_t i:order) {
+    const size_t parent = nodes[i].parent;
+    auto         mat    = mkMatrix(smp[i]);
+    if(parent<nodes.size())
+      tr[i] = tr[parent]*mat; else
+      tr[i] = mt*mat;
+    }
+  }
+
+static void benchBoneOrder(std::mt19937& rnd) {
+  // random tree, stored with children before parents: the unordered case
+  std::vector<size_t> perm(BoneCount);
+  std::iota(perm.begin(),perm.end(),0);
+  std::shuffle(perm.begin()+1,perm.end(),rnd);
+  std::vector<Node> nodes(BoneCount);
+  for(size_t i=1; i<BoneCount; ++i)
+    nodes[perm[i]].parent = perm[rnd()%i];
+
+  std::vector<AnimationSample> smp(BoneCount);
+  for(auto& i:smp) {
+    i.rotation = randomRotation(rnd);
+    i.position = glm::vec3(0.f,10.f,0.f);
+    }
+
+  Tempest::Matrix4x4 root;
+  root.identity();
+  std::vector<Tempest::Matrix4x4> trA(BoneCount), trB(BoneCount);
+
+  const double recursive = Bench::measure([&]() {
+    mkRecursive(nodes,smp.data(),trA,root,size_t(-1));
+    Bench::keep(trA[0]);
+    });
+  const auto   order = mkOrder(nodes);
+  const double flat  = Bench::measure([&]() {
+    mkFlat(nodes,order,smp.data(),trB,root);
+    Bench::keep(trB[0]);
+    });
+
+  float maxDiff = 0;
+  for(size_t i=0; i<BoneCount; ++i)
+    for(int c=0; c<4; ++c)
+      for(int r=0; r<4; ++r)
+        maxDiff = std::max(maxDiff, std::fabs(trA[i].at(c,r)-trB[i].at(c,r)));
+
+  char name[64] = {};
+  std::snprintf(name,sizeof(name),"skeleton x%zu, recursive parent scan",BoneCount);
+  Bench::report(name,recursive);
+  std::snprintf(name,sizeof(name),"skeleton x%zu, flat order",BoneCount);
+  Bench::report(name,flat,recursive);
+  if(maxDiff>1e-4f)
+    std::printf("  MISMATCH: matrices differ by %f\n",double(maxDiff));
+  }
+
+void benchAnimation() {
+  Bench::section("Pose: key-frame interpolation and bone order");
+  std::mt19937 rnd(8);
+  benchNlerp(rnd);
+  benchBoneOrder(rnd);
+  }
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+class Bench final {
+  public:
+    // calls func until minTime elapsed; returns average time per call in nanoseconds
+    template<class F>
+    static double measure(const F& func, std::chrono::milliseconds minTime = std::chrono::milliseconds(250)) {
+      using clock = std::chrono::steady_clock;
+      func(); // warm-up
+      uint64_t   count = 0;
+      const auto start = clock::now();
+      auto       now   = start;
+      do {
+        func();
+        ++count;
+        now = clock::now();
+        } while(now-start < minTime);
+      return std::chrono::duration<double,std::nano>(now-start).count()/double(count);
+      }
+
+    template<class T>
+    static void keep(const T& v) {
+      static volatile uint8_t sink = 0;
+      sink = sink ^ *reinterpret_cast<const volatile uint8_t*>(&v);
+      }
+
+    // value of '-name value' from command line, or nullptr
+    static const char* option(const char* name) {
+      for(int i=1; i+1<argc; ++i)
+        if(std::strcmp(argv[i],name)==0)
+          return argv[i+1];
+      return nullptr;
+      }
+
+    static void section(const char* name) {
+      std::printf("\n== %s\n", name);
+      }
+
+    static void report(const char* name, double ns) {
+      if(ns>=1e6)
+        std::printf("  %-44s %10.3f ms\n", name, ns/1e6); else
+      if(ns>=1e3)
+        std::printf("  %-44s %10.3f us\n", name, ns/1e3); else
+        std::printf("  %-44s %10.3f ns\n", name, ns);
+      }
+
+    static void report(const char* name, double ns, double baseNs) {
+      report(name, ns);
+      std::printf("  %-44s %10.2fx\n", "  speedup", baseNs/ns);
+      }
+
+    static inline int          argc = 0;
+    static inline const char** argv = nullptr;
+  };
+
+void benchWorkers();
+void benchNpcBodies();
+void benchMem32();
+void benchMixer();
+void benchIdTable();
+void benchAnimation();
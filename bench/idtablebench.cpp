@@ -0,0 +1,89 @@
+#include <random>
+#include <vector>
+
+#include "world/idtable.h"
+#include "bench.h"
+
+// stand-ins for Npc/Item: save writes npc references as npcId, script item references as itmId of Item::handle
+struct BenchItem {
+  int handle = 0;
+  };
+
+struct BenchNpc {
+  const BenchNpc* refs[4] = {}; // target, currentOther, lastHit, victim
+  };
+
+static uint32_t linearId(const std::vector<std::unique_ptr<BenchNpc>>& arr, const BenchNpc* ptr) {
+  for(size_t i=0; i<arr.size(); ++i)
+    if(arr[i].get()==ptr)
+      return uint32_t(i);
+  return uint32_t(-1);
+  }
+
+static uint32_t linearId(const std::vector<std::unique_ptr<BenchItem>>& arr, const void* ptr) {
+  for(size_t i=0; i<arr.size(); ++i)
+    if(&arr[i]->handle==ptr)
+      return uint32_t(i);
+  return uint32_t(-1);
+  }
+
+void benchIdTable() {
+  Bench::section("IdTable: WorldObjects save, npc/item references");
+
+  std::mt19937 rnd(21);
+  for(size_t npcCount:{1000u, 4000u, 8000u}) {
+    std::vector<std::unique_ptr<BenchNpc>>  npcs (npcCount);
+    std::vector<std::unique_ptr<BenchItem>> items(npcCount*4);
+    for(auto& i:npcs)
+      i.reset(new BenchNpc());
+    for(auto& i:items)
+      i.reset(new BenchItem());
+    for(auto& i:npcs)
+      for(auto& r:i->refs)
+        r = (rnd()%2==0) ? npcs[rnd()%npcs.size()].get() : nullptr;
+    // script instances, that point to items (one per 10 npcs)
+    std::vector<const void*> itemRefs(npcCount/10);
+    for(auto& i:itemRefs)
+      i = &items[rnd()%items.size()]->handle;
+
+    auto npcKey = [](const BenchNpc&  n) -> const void* { return &n; };
+    auto itmKey = [](const BenchItem& i) -> const void* { return &i.handle; };
+
+    uint64_t sumLinear = 0, sumTable = 0;
+    const double linear = Bench::measure([&]() {
+      sumLinear = 0;
+      for(auto& n:npcs)
+        for(auto r:n->refs)
+          sumLinear += (r==nullptr ? uint32_t(-1) : linearId(npcs,r));
+      for(auto r:itemRefs)
+        sumLinear += linearId(items,r);
+      });
+
+    IdTable npcIds, itmIds;
+    auto save = [&]() {
+      sumTable = 0;
+      for(auto& n:npcs)
+        for(auto r:n->refs)
+          sumTable += (r==nullptr ? uint32_t(-1) : npcIds.find(npcs,r,npcKey));
+      for(auto r:itemRefs)
+        sumTable += itmIds.find(items,r,itmKey);
+      };
+    const double warm = Bench::measure(save);
+    // first save after load/spawn: both tables are rebuilt
+    const double cold = Bench::measure([&]() {
+      npcIds.invalidate();
+      itmIds.invalidate();
+      save();
+      });
+
+    char name[64] = {};
+    std::snprintf(name,sizeof(name),"%5zu npcs, %5zu items: linear scan",npcs.size(),items.size());
+    Bench::report(name,linear);
+    std::snprintf(name,sizeof(name),"%5zu npcs, %5zu items: IdTable, rebuilt",npcs.size(),items.size());
+    Bench::report(name,cold,linear);
+    std::snprintf(name,sizeof(name),"%5zu npcs, %5zu items: IdTable, valid",npcs.size(),items.size());
+    Bench::report(name,warm,linear);
+    if(sumLinear!=sumTable)
+      std::printf("  MISMATCH: ids differ\n");
+    }
+  }
@@ -0,0 +1,55 @@
+#include <cstring>
+#include <cstdio>
+
+#include "bench.h"
+
+struct Entry {
+  const char* name;
+  void      (*run)();
+  };
+
+static const Entry benches[] = {
+  {"workers", benchWorkers},
+  {"npcbody", benchNpcBodies},
+  {"mem32",   benchMem32},
+  {"mixer",   benchMixer},
+  {"idtable", benchIdTable},
+  {"anim",    benchAnimation},
+  };
+
+int main(int argc, const char** argv) {
+  Bench::argc = argc;
+  Bench::argv = argv;
+
+  // names select benchmarks; '-option value' pairs are read by benchmarks themselves
+  bool all = true;
+  for(int i=1; i<argc; ++i) {
+    if(argv[i][0]=='-')
+      ++i; else
+      all = false;
+    }
+
+  bool any = false;
+  for(auto& b:benches) {
+    bool enabled = all;
+    for(int i=1; i<argc; ++i) {
+      if(argv[i][0]=='-')
+        ++i;
+      else if(std::strcmp(argv[i],b.name)==0)
+        enabled = true;
+      }
+    if(!enabled)
+      continue;
+    b.run();
+    any = true;
+    }
+
+  if(!any) {
+    std::printf("usage: %s [bench...] [-mem32trace file]\navailable:", argv[0]);
+    for(auto& b:benches)
+      std::printf(" %s", b.name);
+    std::printf("\n");
+    return 1;
+    }
+  return 0;
+  }
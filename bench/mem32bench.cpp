@@ -0,0 +1,265 @@
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "game/compatibility/mem32.h"
+#include "bench.h"
+
+using TraceOp = Mem32::TraceOp;
+
+static std::vector<TraceOp> loadTrace(const char* path) {
+  std::vector<TraceOp> ret;
+  std::FILE* f = std::fopen(path,"rb");
+  if(f==nullptr)
+    return ret;
+  TraceOp op;
+  while(std::fread(&op,sizeof(op),1,f)==1)
+    ret.push_back(op);
+  std::fclose(f);
+  return ret;
+  }
+
+// Ikarus-like access pattern: pinned engine structs, small MEM_Alloc'ed objects with read-heavy field access,
+// zCArray-style growth via realloc and MEM_CopyBytes; results are taken from a live allocator, as in a recording
+static std::vector<TraceOp> syntheticTrace() {
+  std::vector<TraceOp> ops;
+  std::mt19937         rnd(18);
+  Mem32                mem;
+  std::vector<uint8_t> pinned(0x1000);
+
+  auto push = [&](Mem32::TraceCode code, uint32_t a, uint32_t b, uint32_t c) {
+    TraceOp op;
+    op.code = code;
+    op.a    = a;
+    op.b    = b;
+    op.c    = c;
+    ops.push_back(op);
+    };
+
+  struct Block { uint32_t addr, size; };
+  std::vector<Block> blocks;
+
+  const uint32_t pinAddr[] = {0x00401000, 0x00ab0884, 0x00ab40c0};
+  for(auto a:pinAddr)
+    push(Mem32::T_PinAt, a, 4, mem.pin(pinned.data(), a, 4));
+  for(int i=0; i<4; ++i) {
+    const uint32_t sz = 0x100u << i;
+    const uint32_t a  = mem.pin(pinned.data(), sz);
+    push(Mem32::T_Pin, 0, sz, a);
+    blocks.push_back({a,sz});
+    }
+  const uint32_t symbols = 60000*0x3c;
+  blocks.push_back({mem.alloc(symbols),symbols});
+  push(Mem32::T_Alloc, 0, symbols, blocks.back().addr);
+
+  auto field = [&](const Block& b) { return b.addr + 4*uint32_t(rnd()%(b.size/4)); };
+
+  for(int frame=0; frame<2000; ++frame) {
+    // new script objects
+    for(int i=0; i<4; ++i) {
+      const uint32_t sz = 8*(2 + uint32_t(rnd()%30));
+      const uint32_t a  = mem.alloc(sz);
+      push(Mem32::T_Alloc, 0, sz, a);
+      blocks.push_back({a,sz});
+      }
+    // field access, mostly reads
+    for(int i=0; i<256; ++i) {
+      auto& b = (rnd()%4==0) ? blocks[rnd()%5] : blocks[blocks.size()-1-rnd()%std::min<size_t>(blocks.size(),64)];
+      const uint32_t at = field(b);
+      if(rnd()%8==0) {
+        const int32_t v = int32_t(rnd());
+        mem.writeInt(at,v);
+        push(Mem32::T_Write, at, uint32_t(v), 0);
+        } else {
+        mem.readInt(at);
+        push(Mem32::T_Read, at, 0, 0);
+        }
+      }
+    // array growth
+    if(frame%8==0 && blocks.size()>8) {
+      auto& b = blocks[5+rnd()%(blocks.size()-5)];
+      const uint32_t sz = b.size*2;
+      const uint32_t a  = mem.realloc(b.addr,sz);
+      push(Mem32::T_Realloc, b.addr, sz, a);
+      b = {a,sz};
+      }
+    // copy between objects
+    if(frame%4==0 && blocks.size()>8) {
+      auto& s = blocks[5+rnd()%(blocks.size()-5)];
+      auto& d = blocks[5+rnd()%(blocks.size()-5)];
+      const uint32_t sz = std::min(s.size,d.size);
+      mem.copyBytes(s.addr,d.addr,sz);
+      push(Mem32::T_Copy, s.addr, d.addr, sz);
+      }
+    // release old objects
+    while(blocks.size()>512) {
+      const size_t id = 5+rnd()%(blocks.size()-5);
+      mem.free(blocks[id].addr);
+      push(Mem32::T_Free, blocks[id].addr, 0, 0);
+      blocks[id] = blocks.back();
+      blocks.pop_back();
+      }
+    }
+  return ops;
+  }
+
+// returns count of allocations, that landed on a different address, than recorded
+static size_t replay(const std::vector<TraceOp>& ops, std::vector<uint8_t>& pinned) {
+  Mem32  mem;
+  size_t mismatch = 0;
+  for(auto& op:ops) {
+    switch(op.code) {
+      case Mem32::T_PinAt:
+        mismatch += mem.pin(pinned.data(), op.a, op.b)!=op.c ? 1 : 0;
+        break;
+      case Mem32::T_Pin:
+        mismatch += mem.pin(pinned.data(), op.b)!=op.c ? 1 : 0;
+        break;
+      case Mem32::T_AllocAt:
+        mismatch += mem.alloc(op.a, op.b)!=op.c ? 1 : 0;
+        break;
+      case Mem32::T_Alloc:
+        mismatch += mem.alloc(op.b)!=op.c ? 1 : 0;
+        break;
+      case Mem32::T_Free:
+        mem.free(op.a);
+        break;
+      case Mem32::T_Realloc:
+        mismatch += mem.realloc(op.a, op.b)!=op.c ? 1 : 0;
+        break;
+      case Mem32::T_Read:
+        Bench::keep(mem.readInt(op.a));
+        break;
+      case Mem32::T_Write:
+        mem.writeInt(op.a, int32_t(op.b));
+        break;
+      case Mem32::T_Copy:
+        mem.copyBytes(op.a, op.b, op.c);
+        break;
+      }
+    }
+  return mismatch;
+  }
+
+// random alloc/free/realloc/read/write/copy against a plain map of blocks;
+// blocks are memAlign-granular, so the model keeps rounded sizes, same as realloc preserves padding bytes
+static size_t referenceCheck() {
+  Mem32        mem;
+  std::mt19937 rnd(5);
+  std::map<uint32_t,std::vector<int32_t>> live;
+  size_t bad = 0;
+
+  auto overlaps = [&](uint32_t a, uint32_t size) {
+    auto next = live.lower_bound(a);
+    if(next!=live.end() && next->first < a+size)
+      return true;
+    if(next!=live.begin()) {
+      auto prev = std::prev(next);
+      if(prev->first+4*prev->second.size() > a)
+        return true;
+      }
+    return false;
+    };
+  auto rounded = [](uint32_t sz) {
+    return ((sz+Mem32::memAlign-1)/Mem32::memAlign)*Mem32::memAlign;
+    };
+  auto pick = [&]() {
+    auto it = live.begin();
+    std::advance(it, rnd()%live.size());
+    return it;
+    };
+
+  for(int i=0; i<200000; ++i) {
+    const uint32_t op = uint32_t(rnd()%12);
+    if(op<3 || live.size()<2) {
+      const uint32_t sz = 4*(1+uint32_t(rnd()%64));
+      const uint32_t a  = mem.alloc(sz);
+      if(a==0 || overlaps(a,sz)) {
+        ++bad;
+        continue;
+        }
+      live[a] = std::vector<int32_t>(rounded(sz)/4,0);
+      }
+    else if(op<5) {
+      auto it = pick();
+      mem.free(it->first);
+      live.erase(it);
+      }
+    else if(op<6) {
+      auto           it   = pick();
+      const uint32_t prev = it->first;
+      auto           v    = std::move(it->second);
+      const uint32_t sz   = 4*(1+uint32_t(rnd()%96));
+      live.erase(it);
+      const uint32_t a = mem.realloc(prev,sz);
+      if(a==0 || overlaps(a,sz)) {
+        ++bad;
+        continue;
+        }
+      v.resize(rounded(sz)/4,0);
+      live[a] = std::move(v);
+      }
+    else if(op<7) {
+      auto s  = pick();
+      auto d  = pick();
+      const uint32_t sOff = uint32_t(rnd()%s->second.size());
+      const uint32_t dOff = uint32_t(rnd()%d->second.size());
+      const uint32_t cnt  = uint32_t(std::min(s->second.size()-sOff, d->second.size()-dOff));
+      mem.copyBytes(s->first+4*sOff, d->first+4*dOff, 4*cnt);
+      const std::vector<int32_t> tmp(s->second.begin()+sOff, s->second.begin()+sOff+cnt);
+      std::copy(tmp.begin(), tmp.end(), d->second.begin()+dOff);
+      }
+    else {
+      auto it = pick();
+      const uint32_t at = uint32_t(rnd()%it->second.size());
+      if(op<9) {
+        const int32_t v = int32_t(rnd());
+        mem.writeInt(it->first+4*at,v);
+        it->second[at] = v;
+        }
+      else if(mem.readInt(it->first+4*at)!=it->second[at]) {
+        ++bad;
+        }
+      }
+    }
+
+  for(auto& [a,v]:live)
+    for(size_t i=0; i<v.size(); ++i)
+      if(mem.readInt(a+4*uint32_t(i))!=v[i])
+        ++bad;
+  return bad;
+  }
+
+void benchMem32() {
+  Bench::section("Mem32: Ikarus access trace");
+
+  const char*          path = Bench::option("-mem32trace");
+  std::vector<TraceOp> ops;
+  if(path!=nullptr) {
+    ops = loadTrace(path);
+    std::printf("  trace: %s, %zu ops\n", path, ops.size());
+    }
+  if(ops.empty()) {
+    ops = syntheticTrace();
+    std::printf("  trace: synthetic, %zu ops (record one with Gothic2Notr -mem32trace <file>)\n", ops.size());
+    }
+
+  uint32_t maxPin = 4;
+  for(auto& op:ops)
+    if(op.code==Mem32::T_PinAt || op.code==Mem32::T_Pin)
+      maxPin = std::max(maxPin, op.b);
+  std::vector<uint8_t> pinned(maxPin);
+
+  size_t mismatch = 0;
+  const double ns = Bench::measure([&]() {
+    mismatch = replay(ops,pinned);
+    });
+  Bench::report("replay, full trace",ns);
+  Bench::report("replay, per op",ns/double(ops.size()));
+  if(mismatch>0)
+    std::printf("  MISMATCH: %zu allocations differ from recording\n",mismatch);
+
+  const size_t bad = referenceCheck();
+  std::printf("  reference-model check: %s (%zu errors)\n", bad==0 ? "ok" : "FAILED", bad);
+  }
@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "dmusic/mixkernels.h"
+#include "bench.h"
+
+using namespace Dx8;
+
+// one Mixer::implMix block: every voice accumulated into stereo float mix, then converted to pcm16
+struct Voice {
+  std::vector<float> pcm;
+  std::vector<float> curve; // empty, if no volume curve is active
+  float              volume  = 1.f;
+  float              volLast = 1.f;
+  };
+
+// per-sample loops, as Mixer::implMix was written before the kernels
+static void mixScalar(const std::vector<Voice>& voices, std::vector<float>& mix, int16_t* out, float volume, size_t cnt) {
+  const size_t cnt2 = cnt*2;
+  std::fill(mix.begin(),mix.end(),0.f);
+  for(auto& i:voices) {
+    const float insVolume = i.volume*i.volume;
+    if(!i.curve.empty()) {
+      for(size_t r=0; r<cnt2; ++r) {
+        float v = i.curve[r/2];
+        mix[r] += i.pcm[r]*insVolume*(v*v);
+        }
+      } else {
+      for(size_t r=0; r<cnt2; ++r) {
+        float v = i.volLast;
+        mix[r] += i.pcm[r]*insVolume*(v*v);
+        }
+      }
+    }
+  for(size_t i=0; i<cnt2; ++i) {
+    float v = mix[i]*volume;
+    out[i] = (v < -1.00004566f ? int16_t(-32768) : (v > 1.00001514f ? int16_t(32767) : int16_t(v * 32767.5f)));
+    }
+  }
+
+static void mixKernels(const std::vector<Voice>& voices, std::vector<float>& mix, std::vector<float>& gain,
+                       int16_t* out, float volume, size_t cnt) {
+  const size_t cnt2 = cnt*2;
+  std::fill(mix.begin(),mix.end(),0.f);
+  for(auto& i:voices) {
+    const float insVolume = i.volume*i.volume;
+    if(!i.curve.empty()) {
+      for(size_t r=0; r<cnt; ++r)
+        gain[r] = insVolume*(i.curve[r]*i.curve[r]);
+      MixKernels::mixFrameGain(mix.data(),i.pcm.data(),gain.data(),cnt);
+      } else {
+      MixKernels::mixConstGain(mix.data(),i.pcm.data(),insVolume*(i.volLast*i.volLast),cnt2);
+      }
+    }
+  MixKernels::toPcm16(out,mix.data(),volume,cnt2);
+  }
+
+void benchMixer() {
+  Bench::section("Dx8 Mixer: offline render, scalar vs kernels");
+
+  // SoundFont::SampleRate, stereo
+  const size_t blockSize = 2048;
+  const float  blockMs   = float(blockSize)*1000.f/44100.f;
+
+  std::mt19937 rnd(20);
+  std::uniform_real_distribution<float> smp(-0.25f,0.25f);
+  std::uniform_real_distribution<float> gain(0.3f,1.f);
+
+  for(size_t count:{4u, 16u, 64u}) {
+    std::vector<Voice> voices(count);
+    for(size_t v=0; v<count; ++v) {
+      auto& vc = voices[v];
+      vc.pcm.resize(blockSize*2);
+      for(auto& i:vc.pcm)
+        i = smp(rnd);
+      vc.volume  = gain(rnd);
+      vc.volLast = gain(rnd);
+      // every third instrument has an active volume curve (fade)
+      if(v%3==0) {
+        vc.curve.resize(blockSize);
+        for(size_t i=0; i<blockSize; ++i)
+          vc.curve[i] = vc.volLast*(1.f - float(i)/float(blockSize));
+        }
+      }
+
+    std::vector<float>   mix(blockSize*2), gainBuf(blockSize);
+    std::vector<int16_t> outA(blockSize*2), outB(blockSize*2);
+
+    const double scalar = Bench::measure([&]() {
+      mixScalar(voices,mix,outA.data(),0.8f,blockSize);
+      Bench::keep(outA[0]);
+      });
+    const double simd = Bench::measure([&]() {
+      mixKernels(voices,mix,gainBuf,outB.data(),0.8f,blockSize);
+      Bench::keep(outB[0]);
+      });
+
+    int maxDiff = 0;
+    for(size_t i=0; i<outA.size(); ++i)
+      maxDiff = std::max(maxDiff, std::abs(int(outA[i])-int(outB[i])));
+
+    char name[64] = {};
+    std::snprintf(name,sizeof(name),"%2zu voices, %zu frames, scalar",count,blockSize);
+    Bench::report(name,scalar);
+    std::snprintf(name,sizeof(name),"%2zu voices, %zu frames, kernels",count,blockSize);
+    Bench::report(name,simd,scalar);
+    std::printf("  %-44s %10.1f / %.1f voices per ms (%.1fms of audio per block)\n", "  throughput",
+                double(count)*1e6/scalar, double(count)*1e6/simd, double(blockMs));
+    if(maxDiff>1)
+      std::printf("  MISMATCH: pcm16 output differs by %d\n",maxDiff);
+    }
+  }
@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "physics/bodygrid.h"
+#include "bench.h"
+
+// same cell size and body sizes as DynamicWorld::NpcBodyList
+static constexpr float CellSize = 256.f;
+
+struct BenchBody {
+  Tempest::Vec3 pos    = {};
+  float         r      = 40.f;
+  float         h      = 180.f;
+  uint64_t      cell   = 0;
+  size_t        inCell = 0;
+  };
+
+static bool overlaps(const BenchBody& a, const BenchBody& b) {
+  if(&a==&b)
+    return false;
+  const float dx = a.pos.x-b.pos.x, dy = a.pos.y-b.pos.y, dz = a.pos.z-b.pos.z;
+  const float r  = a.r+b.r;
+  if(dx*dx+dz*dz>r*r)
+    return false;
+  return !(dy>b.h || dy<-a.h);
+  }
+
+static bool onRay(const BenchBody& b, const Tempest::Vec3& s, const Tempest::Vec3& e) {
+  const auto  ln   = e-s;
+  const float len2 = Tempest::Vec3::dotProduct(ln,ln);
+  float       proj = Tempest::Vec3::dotProduct(ln,b.pos-s)/(len2<=0 ? 1.f : len2);
+  proj = std::max(0.f,std::min(proj,1.f));
+  const auto dp = ln*proj + s - b.pos;
+  return dp.x*dp.x+dp.z*dp.z <= b.r*b.r && dp.y>=0 && dp.y<=b.h;
+  }
+
+void benchNpcBodies() {
+  Bench::section("NpcBodyList: brute-force vs grid, 3000 bodies");
+
+  // half of population in a few towns/camps, rest spread over ~600x600m
+  std::mt19937 rnd(42);
+  std::uniform_real_distribution<float> world(-30000.f,30000.f);
+  std::normal_distribution<float>       town(0.f,2500.f);
+  const Tempest::Vec3 towns[] = {{-12000,0,8000},{15000,0,-4000},{2000,0,-20000},{-20000,0,-15000}};
+
+  std::vector<BenchBody> bodies(3000);
+  for(size_t i=0; i<bodies.size(); ++i) {
+    auto& b = bodies[i];
+    if(i%2==0) {
+      auto& t = towns[i%std::size(towns)];
+      b.pos = Tempest::Vec3(t.x+town(rnd), 0, t.z+town(rnd));
+      } else {
+      b.pos = Tempest::Vec3(world(rnd), 0, world(rnd));
+      }
+    }
+
+  BodyGrid<BenchBody> grid(CellSize);
+  for(auto& b:bodies)
+    grid.link(b);
+
+  // collision test for every body, as done for each moving npc per tick
+  size_t hitsBrute = 0, hitsGrid = 0;
+  const double collBrute = Bench::measure([&]() {
+    hitsBrute = 0;
+    for(auto& a:bodies)
+      for(auto& b:bodies)
+        hitsBrute += overlaps(a,b) ? 1 : 0;
+    });
+  const double collGrid = Bench::measure([&]() {
+    hitsGrid = 0;
+    const float dX = 2*40.f;
+    for(auto& a:bodies)
+      grid.forEach(a.pos.x-dX,a.pos.z-dX,a.pos.x+dX,a.pos.z+dX,[&](const BenchBody* b) {
+        hitsGrid += overlaps(a,*b) ? 1 : 0;
+        });
+    });
+  Bench::report("hasCollision x3000, brute-force",collBrute);
+  Bench::report("hasCollision x3000, grid",collGrid,collBrute);
+  if(hitsBrute!=hitsGrid)
+    std::printf("  MISMATCH: brute=%zu grid=%zu\n",hitsBrute,hitsGrid);
+
+  // short rays: melee/arrow range from a body position
+  struct Ray { Tempest::Vec3 s, e; };
+  std::vector<Ray> rays(1000);
+  std::uniform_real_distribution<float> dir(-1500.f,1500.f);
+  for(size_t i=0; i<rays.size(); ++i) {
+    auto s = bodies[(i*7)%bodies.size()].pos + Tempest::Vec3(0,100,0);
+    rays[i] = {s, s+Tempest::Vec3(dir(rnd),0,dir(rnd))};
+    }
+
+  size_t raysBrute = 0, raysGrid = 0;
+  const double rayBrute = Bench::measure([&]() {
+    raysBrute = 0;
+    for(auto& r:rays)
+      for(auto& b:bodies)
+        raysBrute += onRay(b,r.s,r.e) ? 1 : 0;
+    });
+  const double rayGrid = Bench::measure([&]() {
+    raysGrid = 0;
+    for(auto& r:rays) {
+      const float pad = 40.f;
+      grid.forEach(std::min(r.s.x,r.e.x)-pad,std::min(r.s.z,r.e.z)-pad,
+                   std::max(r.s.x,r.e.x)+pad,std::max(r.s.z,r.e.z)+pad,[&](const BenchBody* b) {
+        raysGrid += onRay(*b,r.s,r.e) ? 1 : 0;
+        });
+      }
+    });
+  Bench::report("rayTest x1000, brute-force",rayBrute);
+  Bench::report("rayTest x1000, grid",rayGrid,rayBrute);
+  if(raysBrute!=raysGrid)
+    std::printf("  MISMATCH: brute=%zu grid=%zu\n",raysBrute,raysGrid);
+
+  // grid upkeep: every body walks ~5cm per tick
+  float step = 5.f;
+  const double move = Bench::measure([&]() {
+    for(auto& b:bodies) {
+      b.pos.x += step;
+      grid.onMove(b);
+      }
+    step = -step;
+    });
+  Bench::report("onMove x3000",move);
+  std::printf("  occupied cells: %zu\n",grid.cellCount());
+  }
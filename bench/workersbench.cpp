@@ -0,0 +1,90 @@
+#include <atomic>
+#include <concepts>
+#include <vector>
+
+#include "utils/workers.h"
+#include "bench.h"
+
+// Workers::async is probed with a concept, so this file also builds against a pool that only has
+// parallelFor/parallelTasks; that gives the 'before' numbers for the same workload
+template<class W>
+concept HasAsync = requires(std::vector<typename W::Task>& deps) {
+  { W::async([](){}) } -> std::same_as<typename W::Task>;
+  W::waitAll(deps);
+  };
+
+static void benchParallelFor(size_t size) {
+  std::vector<uint32_t> data(size);
+  for(size_t i=0; i<size; ++i)
+    data[i] = uint32_t(i);
+
+  auto work = [](uint32_t& v) { v = v*1664525u + 1013904223u; };
+
+  const double serial = Bench::measure([&]() {
+    for(auto& i:data)
+      work(i);
+    Bench::keep(data[0]);
+    });
+  const double parallel = Bench::measure([&]() {
+    Workers::parallelFor(data,work);
+    Bench::keep(data[0]);
+    });
+
+  char name[64] = {};
+  std::snprintf(name,sizeof(name),"serial      %8zu elts",size);
+  Bench::report(name,serial);
+  std::snprintf(name,sizeof(name),"parallelFor %8zu elts",size);
+  Bench::report(name,parallel,serial);
+  }
+
+static void benchParallelTasks() {
+  std::atomic<uint32_t> cnt{0};
+  const size_t threads = Workers::maxThreads();
+  const double ns = Bench::measure([&]() {
+    Workers::parallelTasks(threads,[&](size_t) { cnt.fetch_add(1,std::memory_order_relaxed); });
+    });
+  Bench::report("parallelTasks(maxThreads), empty",ns);
+  Bench::keep(cnt);
+  }
+
+template<class W>
+static void benchAsync() {
+  if constexpr(HasAsync<W>) {
+    std::atomic<uint32_t> cnt{0};
+    auto inc = [&]() { cnt.fetch_add(1,std::memory_order_relaxed); };
+
+    const double single = Bench::measure([&]() {
+      W::async(inc).wait();
+      });
+    Bench::report("async + wait, single task",single);
+
+    std::vector<typename W::Task> tasks;
+    const double batch = Bench::measure([&]() {
+      tasks.clear();
+      for(int i=0; i<256; ++i)
+        tasks.push_back(W::async(inc));
+      W::waitAll(tasks);
+      });
+    Bench::report("async x256 + waitAll (per task)",batch/256.0);
+
+    const double chain = Bench::measure([&]() {
+      auto t = W::async(inc);
+      for(int i=1; i<64; ++i)
+        t = W::async({t},inc);
+      t.wait();
+      });
+    Bench::report("continuation chain x64 (per link)",chain/64.0);
+    Bench::keep(cnt);
+    } else {
+    std::printf("  async: not available in this Workers build\n");
+    }
+  }
+
+void benchWorkers() {
+  Bench::section("Workers");
+  std::printf("  threads: %u\n",unsigned(Workers::maxThreads()));
+  for(size_t sz:{256u, 4096u, 65536u, 1048576u})
+    benchParallelFor(sz);
+  benchParallelTasks();
+  benchAsync<Workers>();
+  }
@@ -5,6 +5,7 @@
 #include "world/objects/npc.h"
 #include "world/objects/interactive.h"
 #include "world/world.h"
+#include "physics/loscache.h"
 #include "game/definitions/cameradefinitions.h"
 #include "game/serialize.h"
 #include "utils/gthfont.h"
@@ -744,7 +745,7 @@ Vec3 Camera::calcCameraColision(const Vec3& target, const Vec3& origin, const Ve
 
   //static float minDist = 20;
   static float padding = 50;
-  static int n = 1, nn=1;
+  static constexpr int n = 1, nn=1;
 
   Matrix4x4 vinv=projective();
   vinv.mul(mkView(origin,rotSpin));
@@ -753,28 +754,37 @@ Vec3 Camera::calcCameraColision(const Vec3& target, const Vec3& origin, const Ve
   auto& physic = *world->physic();
   auto  dview  = (origin - target);
 
+  DynamicWorld::RaySegment     ray[(2*n+1)*(2*n+1)];
+  DynamicWorld::RayBatchResult hit[(2*n+1)*(2*n+1)];
+
   raysCasted = 0;
-  float distM = dist;
   for(int i=-n;i<=n;++i)
     for(int r=-n;r<=n;++r) {
-      raysCasted++;
       float u = float(i)/float(nn),v = float(r)/float(nn);
       Tempest::Vec3 r1 = {u,v,depthNear};
       vinv.project(r1);
       auto dr = (r1 - target);
       dr = dr * (dist+padding) / (dr.length()+0.00001f);
 
-      auto rc = physic.ray(target, target+dr);
-      if(!rc.hasCol)
-        continue;
+      ray[raysCasted].from = target;
+      ray[raysCasted].to   = target+dr;
+      raysCasted++;
+      }
+  physic.rayBatch(ray,size_t(raysCasted),hit);
 
-      auto  tr    = (rc.v - target);
-      float dist1 = Vec3::dotProduct(dview,tr)/dist;
+  float distM = dist;
+  for(int i=0; i<raysCasted; ++i) {
+    auto& rc = hit[i];
+    if(!rc.hasCol)
+      continue;
 
-      dist1 = std::max<float>(dist1-padding, 0);
-      if(dist1<distM)
-        distM = dist1;
-      }
+    auto  tr    = (rc.v - target);
+    float dist1 = Vec3::dotProduct(dview,tr)/dist;
+
+    dist1 = std::max<float>(dist1-padding, 0);
+    if(dist1<distM)
+      distM = dist1;
+    }
 
   auto  dp = Vec3::normalize(origin-target)*distM;
   static float dd = 100.f;
@@ -837,6 +847,13 @@ void Camera::debugDraw(DbgPainter& p) {
   string_frm buf("RaysCasted: ",raysCasted);
   p.drawText(8,y,buf); y += fnt.pixelSize();
 
+  if(auto w = Gothic::inst().world()) {
+    auto st  = w->physic()->losCache().stats();
+    auto pct = st.queries>0 ? int(st.hits*100/st.queries) : 0;
+    buf = string_frm("LosCache : ",size_t(st.hits),'/',size_t(st.queries)," (",pct,"%) entries: ",st.size," dropped: ",size_t(st.dropped));
+    p.drawText(8,y,buf); y += fnt.pixelSize();
+    }
+
   buf = string_frm("PlayerPos : ",dst.target.x, ' ', dst.target.y, ' ', dst.target.z);
   p.drawText(8,y,buf); y += fnt.pixelSize();
 
@@ -121,6 +121,12 @@ CommandLine::CommandLine(int argc, const char** argv) {
       if(i<argc)
         isMeshSh = (std::string_view(argv[i])!="0" && std::string_view(argv[i])!="false");
       }
+    else if(arg=="-mem32trace") {
+      // not to document - records Ikarus memory access, for OpenGothicBench
+      ++i;
+      if(i<argc)
+        mem32Trace = argv[i];
+      }
     else if(arg=="-bl") {
       // not to document - debug only
       ++i;
@@ -45,6 +45,7 @@ class CommandLine {
     bool                doForceG2NR()      const { return forceG2NR;    }
     uint32_t            fxaaPreset()       const { return fxaaPresetId; }
     std::string_view    defaultSave()      const { return saveDef;      }
+    std::string_view    mem32TracePath()   const { return mem32Trace;   }
 
     std::string         wrldDef;
 
@@ -56,6 +57,7 @@ class CommandLine {
     std::u16string      gscript;
     std::u16string      gcutscene;
     std::string         saveDef;
+    std::string         mem32Trace;
     bool                devmode      = false;
     bool                noMenu       = false;
     bool                isWindow     = false;
@@ -5,8 +5,10 @@
 #include <Tempest/Sound>
 #include <Tempest/Log>
 #include <cmath>
+#include <cstring>
 #include <set>
 
+#include "mixkernels.h"
 #include "soundfont.h"
 #include "wave.h"
 
@@ -31,8 +33,11 @@ Mixer::~Mixer() {
   }
 
 void Mixer::setMusic(const Music& m,DMUS_EMBELLISHT_TYPES e) {
-  if(current==m.impl)
+  if(current==m.impl) {
+    // cached music can be re-selected, before pending switch has happened
+    nextMus = nullptr;
     return;
+    }
 
   nextMus = m.impl;
   embellishment.store(e);
@@ -324,7 +329,7 @@ void Mixer::implMix(PatternInternal &pptn, float volume, int16_t *out, size_t cn
     std::memset(pcm.data(),0,cnt2*sizeof(pcm[0]));
     ins.font.mix(pcm.data(),cnt);
 
-    float insVolume = std::pow(ins.volume,2.f);
+    const float insVolume = ins.volume*ins.volume;
     if(ins.key==5 || ins.key==6) {
       // HACK
       // insVolume*=0.10f;
@@ -332,22 +337,16 @@ void Mixer::implMix(PatternInternal &pptn, float volume, int16_t *out, size_t cn
     const bool hasVol = hasVolumeCurves(pptn,i);
     if(hasVol) {
       volFromCurve(pptn,i,vol);
-      for(size_t r=0;r<cnt2;++r) {
-        float v = vol[r/2];
-        pcmMix[r] += pcm[r]*insVolume*(v*v);
-        }
+      for(auto& v:vol)
+        v = insVolume*(v*v);
+      MixKernels::mixFrameGain(pcmMix.data(),pcm.data(),vol.data(),cnt);
       } else {
-      for(size_t r=0;r<cnt2;++r) {
-        float v = i.volLast;
-        pcmMix[r] += pcm[r]*insVolume*(v*v);
-        }
+      const float v = i.volLast;
+      MixKernels::mixConstGain(pcmMix.data(),pcm.data(),insVolume*(v*v),cnt2);
       }
     }
 
-  for(size_t i=0;i<cnt2;++i) {
-    float v = pcmMix[i]*volume;
-    out[i] = (v < -1.00004566f ? int16_t(-32768) : (v > 1.00001514f ? int16_t(32767) : int16_t(v * 32767.5f)));
-    }
+  MixKernels::toPcm16(out,pcmMix.data(),volume,cnt2);
   }
 
 void Mixer::volFromCurve(PatternInternal &part,Instr& inst,std::vector<float> &v) {
@@ -372,15 +371,16 @@ void Mixer::volFromCurve(PatternInternal &part,Instr& inst,std::vector<float> &v
     const size_t begin = size_t(std::max<int64_t>(s,0));
     const size_t size  = std::min(size_t(e),v.size());
     const float  range = float(e-s);
+    const float  invR  = range>0 ? 1.f/range : 0.f;
     const float  diffV = i.endV-i.startV;
     const float  shift = i.startV;
     const float  endV  = i.endV;
 
     switch(i.shape) {
       case DMUS_CURVES_LINEAR: {
+        const float k = diffV*invR;
         for(size_t i=begin;i<size;++i) {
-          float val = (float(i)-float(s))/range;
-          v[i] = val*diffV+shift;
+          v[i] = (float(i)-float(s))*k+shift;
           }
         break;
         }
@@ -392,21 +392,21 @@ void Mixer::volFromCurve(PatternInternal &part,Instr& inst,std::vector<float> &v
         }
       case DMUS_CURVES_EXP: {
         for(size_t i=begin;i<size;++i) {
-          float val = (float(i)-float(s))/range;
-          v[i] = std::pow(val,2.f)*diffV+shift;
+          float val = (float(i)-float(s))*invR;
+          v[i] = (val*val)*diffV+shift;
           }
         break;
         }
       case DMUS_CURVES_LOG: {
         for(size_t i=begin;i<size;++i) {
-          float val = (float(i)-float(s))/range;
+          float val = (float(i)-float(s))*invR;
           v[i] = std::sqrt(val)*diffV+shift;
           }
         break;
         }
       case DMUS_CURVES_SINE: {
         for(size_t i=begin;i<size;++i) {
-          float linear = (float(i)-float(s))/range;
+          float linear = (float(i)-float(s))*invR;
           float val    = std::sin(float(M_PI)*linear*0.5f);
           v[i] = val*diffV+shift;
           }
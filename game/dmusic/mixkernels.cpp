@@ -0,0 +1,62 @@
+#include "mixkernels.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP>=2)
+#include <emmintrin.h>
+#define DX8_MIXER_SSE2 1
+#endif
+
+using namespace Dx8;
+
+void MixKernels::mixConstGain(float* dst, const float* src, float gain, size_t cnt2) {
+  size_t i = 0;
+#if defined(DX8_MIXER_SSE2)
+  const __m128 g = _mm_set1_ps(gain);
+  for(; i+8<=cnt2; i+=8) {
+    __m128 a = _mm_add_ps(_mm_loadu_ps(dst+i),  _mm_mul_ps(_mm_loadu_ps(src+i),  g));
+    __m128 b = _mm_add_ps(_mm_loadu_ps(dst+i+4),_mm_mul_ps(_mm_loadu_ps(src+i+4),g));
+    _mm_storeu_ps(dst+i,  a);
+    _mm_storeu_ps(dst+i+4,b);
+    }
+#endif
+  for(; i<cnt2; ++i)
+    dst[i] += src[i]*gain;
+  }
+
+void MixKernels::mixFrameGain(float* dst, const float* src, const float* gain, size_t cnt) {
+  size_t i = 0;
+#if defined(DX8_MIXER_SSE2)
+  for(; i+4<=cnt; i+=4) {
+    const __m128 g  = _mm_loadu_ps(gain+i);
+    const __m128 g0 = _mm_unpacklo_ps(g,g);
+    const __m128 g1 = _mm_unpackhi_ps(g,g);
+    float* d = dst+i*2;
+    const float* s = src+i*2;
+    _mm_storeu_ps(d,  _mm_add_ps(_mm_loadu_ps(d),  _mm_mul_ps(_mm_loadu_ps(s),  g0)));
+    _mm_storeu_ps(d+4,_mm_add_ps(_mm_loadu_ps(d+4),_mm_mul_ps(_mm_loadu_ps(s+4),g1)));
+    }
+#endif
+  for(; i<cnt; ++i) {
+    dst[i*2  ] += src[i*2  ]*gain[i];
+    dst[i*2+1] += src[i*2+1]*gain[i];
+    }
+  }
+
+void MixKernels::toPcm16(int16_t* out, const float* src, float volume, size_t cnt2) {
+  size_t i = 0;
+#if defined(DX8_MIXER_SSE2)
+  const __m128 k  = _mm_set1_ps(volume*32767.5f);
+  const __m128 lo = _mm_set1_ps(-32768.f);
+  const __m128 hi = _mm_set1_ps( 32767.f);
+  for(; i+8<=cnt2; i+=8) {
+    __m128  a  = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src+i),  k),lo),hi);
+    __m128  b  = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src+i+4),k),lo),hi);
+    __m128i ia = _mm_cvttps_epi32(a);
+    __m128i ib = _mm_cvttps_epi32(b);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out+i),_mm_packs_epi32(ia,ib));
+    }
+#endif
+  for(; i<cnt2; ++i) {
+    float v = src[i]*volume;
+    out[i] = (v < -1.00004566f ? int16_t(-32768) : (v > 1.00001514f ? int16_t(32767) : int16_t(v * 32767.5f)));
+    }
+  }
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Dx8 {
+
+// stereo accumulation and pcm16 output of Mixer; SSE2, where available
+class MixKernels final {
+  public:
+    // dst[2i+c] += src[2i+c]*gain
+    static void mixConstGain(float* dst, const float* src, float gain, size_t cnt2);
+    // dst[2i+c] += src[2i+c]*gain[i]; gain is per stereo frame
+    static void mixFrameGain(float* dst, const float* src, const float* gain, size_t cnt);
+    // out = saturate(src*volume); same rounding as int16_t(v*32767.5f) with clamp to [-1,1]
+    static void toPcm16(int16_t* out, const float* src, float volume, size_t cnt2);
+  };
+
+}
@@ -154,6 +154,7 @@ struct SoundFont::Instance {
     fnt    = shData->hydra.toTsf();
     preset = tsf_get_presetindex(fnt, bank, patch);
     tsf_set_output(fnt,TSF_STEREO_INTERLEAVED,44100,0);
+    preallocVoices();
     }
 
   ~Instance(){
@@ -164,6 +165,19 @@ struct SoundFont::Instance {
     return Hydra::hasNotes(fnt);
     }
 
+  // voice pool: tsf grows it by 4 with realloc in note_on, which is on audio thread
+  void preallocVoices() {
+    if(fnt->voiceNum>=int(PoolSize))
+      return;
+    auto* v = reinterpret_cast<tsf_voice*>(TSF_REALLOC(fnt->voices,PoolSize*sizeof(tsf_voice)));
+    if(v==nullptr)
+      return;
+    for(int i=fnt->voiceNum; i<int(PoolSize); ++i)
+      v[i].playingPreset = -1;
+    fnt->voices   = v;
+    fnt->voiceNum = int(PoolSize);
+    }
+
   void setPan(float p){
     tsf_channel_set_pan(fnt,0,p);
     tsf_channel_set_pan(fnt,1,p);
@@ -186,6 +200,8 @@ struct SoundFont::Instance {
     return true;
     }
 
+  static constexpr size_t PoolSize = 16;
+
   std::bitset<256> alloc;
   tsf*             fnt=nullptr;
   int              preset=0;
@@ -233,8 +249,11 @@ struct SoundFont::Impl {
     }
 
   void mix(float *samples, size_t count) {
-    for(auto& i:inst)
+    for(auto& i:inst) {
+      if(!i->hasNotes())
+        continue;
       tsf_render_float(i->fnt,samples,int(count),true);
+      }
     }
 
   std::shared_ptr<Data>                  shData;
@@ -8,6 +8,7 @@
 #include <zenkit/vobs/Misc.hh>
 
 #include "game/gamescript.h"
+#include "commandline.h"
 #include "gothic.h"
 
 using namespace Tempest;
@@ -73,6 +74,8 @@ const std::string& Ikarus::memory_instance::get_string(const zenkit::DaedalusSym
 
 Ikarus::Ikarus(GameScript& /*owner*/, zenkit::DaedalusVm& vm) : vm(vm) {
   Log::i("DMA mod detected: Ikarus");
+  if(auto trace = CommandLine::inst().mem32TracePath(); !trace.empty())
+    allocator.startTrace(std::string(trace).c_str());
 
   // built-in data with assumed address
   versionHint = 504628679; // G2
@@ -110,6 +110,7 @@ void LeGo::tick(uint64_t dt) {
       }
 
     if(auto* sym = vm.find_symbol_by_index(i.fncID)) {
+      ScriptProfiler::Scope scope(owner.profiler(),sym->index());
       try {
       if(i.hasData)
         vm.call_function(sym, i.data); else
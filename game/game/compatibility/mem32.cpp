@@ -5,6 +5,7 @@
 #include <cstring>
 #include <algorithm>
 #include <cstddef>
+#include <bit>
 
 using namespace Tempest;
 
@@ -14,11 +15,16 @@ Mem32::Mem32() {
    *  [0x80000000 .. 0xc0000000] - (1GB) extra space(reserved for opengothic use; pinned memory)
    *  [0xc0000000 .. 0xffffffff] - (1GB) kernel space
    */
-  region.emplace_back(Region(0x1000,0x80000000));
+  Region rgn(0x1000,0x80000000);
+  region.emplace(rgn.address,rgn);
+  addFree(rgn);
   }
 
 Mem32::~Mem32() {
-  for(auto& rgn:region) {
+  if(trace!=nullptr)
+    std::fclose(trace);
+  for(auto& i:region) {
+    auto& rgn = i.second;
     if(rgn.status==S_Allocated && rgn.real!=nullptr) {
       std::free(rgn.real);
       rgn.real = nullptr;
@@ -26,86 +32,132 @@ Mem32::~Mem32() {
     }
   }
 
+bool Mem32::startTrace(const char* path) {
+  if(trace!=nullptr)
+    std::fclose(trace);
+  trace = std::fopen(path,"wb");
+  if(trace==nullptr) {
+    Log::e("mem32: unable to open trace file: \"", path, "\"");
+    return false;
+    }
+  Log::i("mem32: recording access trace to \"", path, "\"");
+  return true;
+  }
+
+void Mem32::record(TraceCode code, uint32_t a, uint32_t b, uint32_t c) {
+  TraceOp op;
+  op.code = code;
+  op.a    = a;
+  op.b    = b;
+  op.c    = c;
+  std::fwrite(&op,sizeof(op),1,trace);
+  }
+
 Mem32::ptr32_t Mem32::pin(void* mem, ptr32_t address, uint32_t size, const char* comment) {
+  ptr32_t ret = 0;
   if(auto rgn = implAllocAt(address,size)) {
     rgn->size    = size;
     rgn->real    = mem;
     rgn->status  = S_Pin;
     rgn->comment = comment;
-    return address;
+    ret = rgn->address;
     }
-  return 0;
+  if(trace!=nullptr)
+    record(T_PinAt,address,size,ret);
+  return ret;
   }
 
 Mem32::ptr32_t Mem32::pin(void* mem, uint32_t size, const char* comment) {
+  ptr32_t ret = 0;
   if(auto rgn = implAlloc(size)) {
     rgn->size    = size;
     rgn->real    = mem;
     rgn->status  = S_Pin;
     rgn->comment = comment;
-    return rgn->address;
+    ret = rgn->address;
     }
-  return 0;
+  if(trace!=nullptr)
+    record(T_Pin,0,size,ret);
+  return ret;
   }
 
 Mem32::ptr32_t Mem32::alloc(ptr32_t address, uint32_t size, const char* comment) {
-  if(auto rgn = implAllocAt(address,size)) {
-    rgn->real = std::calloc(size,1);
-    if(rgn->real==nullptr) {
-      compactage();
-      return 0;
-      }
-    rgn->size    = size;
-    rgn->status  = S_Allocated;
-    rgn->comment = comment;
-    return address;
-    }
-  return 0;
+  const ptr32_t ret = implAllocData(address,size,comment);
+  if(trace!=nullptr)
+    record(T_AllocAt,address,size,ret);
+  return ret;
   }
 
 Mem32::ptr32_t Mem32::alloc(uint32_t size) {
-  if(auto rgn = implAlloc(size)) {
-    rgn->real = std::calloc(size,1);
+  const ptr32_t ret = implAllocData(0,size,nullptr);
+  if(trace!=nullptr)
+    record(T_Alloc,0,size,ret);
+  return ret;
+  }
+
+Mem32::ptr32_t Mem32::implAllocData(ptr32_t address, uint32_t size, const char* comment) {
+  if(auto rgn = implAllocAt(address,size)) {
+    rgn->real = std::calloc(rgn->size,1);
     if(rgn->real==nullptr) {
-      compactage();
+      release(region.find(rgn->address));
       return 0;
       }
-    rgn->status = S_Allocated;
+    rgn->status  = S_Allocated;
+    rgn->comment = comment;
     return rgn->address;
     }
   return 0;
   }
 
 void Mem32::free(ptr32_t address) {
+  if(trace!=nullptr)
+    record(T_Free,address,0,0);
   if(address==0)
     return;
-  for(size_t i=0; i<region.size(); ++i) {
-    if(region[i].address!=address)
-      continue;
-    std::free(region[i].real);
-    region[i].real   = nullptr;
-    region[i].status = S_Unused;
-    compactage();
+  auto it = region.find(address);
+  if(it==region.end()) {
+    Log::e("mem_free: heap block wan't allocated by script: ", reinterpret_cast<void*>(uint64_t(address)));
     return;
     }
-  Log::e("mem_free: heap block wan't allocated by script: ", reinterpret_cast<void*>(uint64_t(address)));
+  if(it->second.status==S_Unused)
+    return;
+  if(it->second.status==S_Allocated)
+    std::free(it->second.real);
+  release(it);
   }
 
-void Mem32::compactage() {
-  for(size_t i=0; i+1<region.size(); ) {
-    auto& a = region[i+0];
-    auto& b = region[i+1];
-    if(a.status==S_Unused && a.status==b.status && a.address+a.size==b.address) {
-      a.size += b.size;
-      b.size = 0;
-      region.erase(region.begin()+ptrdiff_t(i+1));
-      } else {
-      ++i;
+void Mem32::release(Iterator it) {
+  lastHit = nullptr;
+
+  auto& rgn = it->second;
+  rgn.real    = nullptr;
+  rgn.comment = nullptr;
+  rgn.status  = S_Unused;
+
+  auto next = std::next(it);
+  if(next!=region.end() && next->second.status==S_Unused && rgn.address+rgn.size==next->second.address) {
+    delFree(next->second);
+    rgn.size += next->second.size;
+    region.erase(next);
+    }
+
+  if(it!=region.begin()) {
+    auto  prev = std::prev(it);
+    auto& p    = prev->second;
+    if(p.status==S_Unused && p.address+p.size==rgn.address) {
+      delFree(p);
+      p.size += rgn.size;
+      region.erase(it);
+      it = prev;
       }
     }
+
+  addFree(it->second);
   }
 
 void Mem32::writeInt(ptr32_t address, int32_t v) {
+  if(trace!=nullptr)
+    record(T_Write,address,uint32_t(v),0);
   auto rgn = translate(address);
   if(rgn==nullptr) {
     Log::e("mem_writeint: address translation failure: ", reinterpret_cast<void*>(uint64_t(address)));
@@ -117,6 +169,8 @@ void Mem32::writeInt(ptr32_t address, int32_t v) {
   }
 
 int32_t Mem32::readInt(ptr32_t address) {
+  if(trace!=nullptr)
+    record(T_Read,address,0,0);
   auto rgn = translate(address);
   if(rgn==nullptr) {
     Log::e("mem_readint:  address translation failure: ", reinterpret_cast<void*>(uint64_t(address)));
@@ -130,6 +184,8 @@ int32_t Mem32::readInt(ptr32_t address) {
   }
 
 void Mem32::copyBytes(ptr32_t psrc, ptr32_t pdst, uint32_t size) {
+  if(trace!=nullptr)
+    record(T_Copy,psrc,pdst,size);
   auto src = translate(psrc);
   auto dst = translate(pdst);
   if(src==nullptr || src->status==S_Unused) {
@@ -152,145 +208,195 @@ void Mem32::copyBytes(ptr32_t psrc, ptr32_t pdst, uint32_t size) {
     Log::e("mem_copybytes: copy-size exceed destination block size: ", size);
     sz = std::min(dst->size-dOff,sz);
     }
-  std::memcpy(reinterpret_cast<uint8_t*>(dst->real)+sOff,
-              reinterpret_cast<uint8_t*>(src->real)+dOff,
-              sz);
+  std::memmove(reinterpret_cast<uint8_t*>(dst->real)+dOff,
+               reinterpret_cast<uint8_t*>(src->real)+sOff,
+               sz);
   }
 
-Mem32::Region* Mem32::implAlloc(uint32_t size) {
-  size = ((size+memAlign-1)/memAlign)*memAlign;
+uint32_t Mem32::sizeClass(uint32_t size) {
+  if(size==0)
+    return 0;
+  return uint32_t(std::bit_width(size)-1);
+  }
+
+void Mem32::addFree(const Region& r) {
+  if(r.size>0)
+    freeList[sizeClass(r.size)].emplace(r.size,r.address);
+  }
+
+void Mem32::delFree(const Region& r) {
+  freeList[sizeClass(r.size)].erase({r.size,r.address});
+  }
+
+Mem32::Iterator Mem32::findFree(uint32_t size) {
+  // best fit within own class, any block from a bigger one
+  const uint32_t cls = sizeClass(size);
+  auto&          fl  = freeList[cls];
+  auto           it  = fl.lower_bound({size,0});
+  if(it!=fl.end())
+    return region.find(it->second);
 
-  for(size_t i=0; i<region.size(); ++i) {
-    if(region[i].status!=S_Unused || region[i].size<size)
+  for(uint32_t i=cls+1; i<SizeClasses; ++i) {
+    if(freeList[i].empty())
       continue;
-    if(size!=region[i].size) {
-      auto p2 = region[i];
-      p2.address+=size;
-      p2.size   -=size;
-      region.insert(region.begin()+ptrdiff_t(i+1),p2);
-      }
-    region[i].size = size;
-    return &region[i];
+    return region.find(freeList[i].begin()->second);
     }
+  return region.end();
+  }
 
-  return nullptr;
+Mem32::Region* Mem32::implAlloc(uint32_t size) {
+  size = ((size+memAlign-1)/memAlign)*memAlign;
+  if(size==0)
+    size = memAlign;
+
+  auto it = findFree(size);
+  if(it==region.end())
+    return nullptr;
+
+  auto& rgn = it->second;
+  delFree(rgn);
+  if(size!=rgn.size) {
+    Region p2(rgn.address+size, rgn.size-size);
+    region.emplace_hint(std::next(it),p2.address,p2);
+    addFree(p2);
+    rgn.size = size;
+    }
+  return &rgn;
   }
 
 Mem32::ptr32_t Mem32::realloc(ptr32_t address, uint32_t size) {
+  const ptr32_t ret = implReallocData(address,size);
+  if(trace!=nullptr)
+    record(T_Realloc,address,size,ret);
+  return ret;
+  }
+
+Mem32::ptr32_t Mem32::implReallocData(ptr32_t address, uint32_t size) {
   size = ((size+memAlign-1)/memAlign)*memAlign;
   if(implRealloc(address,size))
     return address;
 
+  auto src = translate(address);
+  if(src==nullptr && address!=0)
+    Log::e("realloc: address translation failure: ", reinterpret_cast<void*>(uint64_t(address)));
+  if(src==nullptr || src->status!=S_Allocated)
+    return implAllocData(0,size,nullptr);
+
   auto next = implAlloc(size);
   if(next==nullptr)
     return 0;
 
-  auto src = translate(address);
-  if(src==nullptr) {
-    if(address!=0)
-      Log::e("realloc: address translation failure: ", reinterpret_cast<void*>(uint64_t(address)));
-    return next->address;
+  auto real = std::realloc(src->real,next->size);
+  if(real==nullptr) {
+    release(region.find(next->address));
+    return 0;
     }
+  if(next->size>src->size)
+    std::memset(reinterpret_cast<uint8_t*>(real)+src->size, 0, next->size-src->size);
 
   next->status  = S_Allocated;
-  next->real    = src->real;
+  next->real    = real;
   next->comment = src->comment;
 
-  src->real     = nullptr;
-  src->status   = S_Unused;
-
-  auto ret = next->address;
-  compactage();
+  const ptr32_t ret = next->address;
+  release(region.find(src->address));
   return ret;
   }
 
 Mem32::Region* Mem32::implAllocAt(ptr32_t address, uint32_t size) {
-  for(size_t i=0; i<region.size(); ++i) {
-    auto& rgn = region[i];
-
-    if(address!=0) {
-      if(!(rgn.address<=address && address+size<=rgn.address+rgn.size))
-        continue;
-      } else {
-      if(rgn.size<size)
-        continue;
-      }
+  if(address==0)
+    return implAlloc(size);
+  if(size==0)
+    size = 1;
 
-    if(rgn.status!=S_Unused) {
-      Log::e("failed to pin a ",size," bytes of memory: block is in use");
-      return 0;
-      }
+  auto it = region.upper_bound(address);
+  if(it==region.begin())
+    return nullptr;
+  --it;
 
-    if(address==0)
-      address = region[i].address;
-
-    if(region[i].address<address) {
-      uint32_t off = (address-region[i].address);
-      auto p2 = region[i];
-      p2.address+=off;
-      p2.size   -=off;
-      region.insert(region.begin()+ptrdiff_t(i+1),p2);
-      region[i].size = off;
-      ++i;
-      }
-    if(size!=region[i].size) {
-      auto p2 = region[i];
-      p2.address+=size;
-      p2.size   -=size;
-      region.insert(region.begin()+ptrdiff_t(i+1),p2);
-      }
+  if(uint64_t(address)+size > uint64_t(it->second.address)+it->second.size)
+    return nullptr;
 
-    return &region[i];
+  if(it->second.status!=S_Unused) {
+    Log::e("failed to pin a ",size," bytes of memory: block is in use");
+    return nullptr;
+    }
+
+  delFree(it->second);
+  if(it->second.address<address) {
+    uint32_t off = (address-it->second.address);
+    Region   p2(address, it->second.size-off);
+    it->second.size = off;
+    addFree(it->second);
+    it = region.emplace_hint(std::next(it),p2.address,p2);
+    }
+  if(size!=it->second.size) {
+    Region p2(address+size, it->second.size-size);
+    region.emplace_hint(std::next(it),p2.address,p2);
+    addFree(p2);
+    it->second.size = size;
     }
-  return nullptr;
+
+  return &it->second;
   }
 
 bool Mem32::implRealloc(ptr32_t address, uint32_t nsize) {
   // NOTE: in place only
-  for(size_t i=0; i<region.size(); ++i) {
-    auto& rgn = region[i];
-    if(rgn.address!=address)
-      continue;
+  auto it = region.find(address);
+  if(it==region.end() || it->second.status!=S_Allocated || nsize==0)
+    return false;
 
-    if(nsize==rgn.size)
-      return true;
+  auto& rgn = it->second;
+  if(nsize==rgn.size)
+    return true;
+
+  if(nsize<rgn.size) {
+    if(auto next = std::realloc(rgn.real, nsize))
+      rgn.real = next;
+    Region frgn(address+nsize, rgn.size-nsize);
+    rgn.size = nsize;
+    release(region.emplace_hint(std::next(it),frgn.address,frgn));
+    return true;
+    }
 
-    if(nsize<rgn.size) {
-      if(auto next = std::realloc(rgn.real, nsize))
-        rgn.real = next;
-      Region frgn(address+nsize, rgn.size-nsize);
-      rgn.size = nsize;
-      region.insert(region.begin() + intptr_t(i + 1), frgn);
-      return true;
-      }
+  auto nx = std::next(it);
+  if(nx==region.end())
+    return false; // can't expand
 
-    if(i+1==region.size())
-      return false; // can't expand
-
-    auto& rgn2 = region[i+1];
-    if(rgn2.status==S_Unused && rgn.size + rgn2.size>=nsize) {
-      auto next = std::realloc(rgn.real, nsize);
-      if(next==nullptr)
-        return false;
-      rgn2.address += (nsize-rgn.size);
-      rgn2.size    -= (nsize-rgn.size);
-      rgn.real      = next;
-      rgn.size      = nsize;
-      if(rgn2.size==0)
-        compactage();
-      return true;
-      }
+  auto& rgn2 = nx->second;
+  if(rgn2.status!=S_Unused || rgn.address+rgn.size!=rgn2.address || rgn.size+rgn2.size<nsize)
+    return false;
 
+  auto next = std::realloc(rgn.real, nsize);
+  if(next==nullptr)
     return false;
+  std::memset(reinterpret_cast<uint8_t*>(next)+rgn.size, 0, nsize-rgn.size);
+
+  Region rest(address+nsize, rgn2.size-(nsize-rgn.size));
+  delFree(rgn2);
+  region.erase(nx);
+  if(rest.size>0) {
+    region.emplace(rest.address,rest);
+    addFree(rest);
     }
-  return false;
+  rgn.real = next;
+  rgn.size = nsize;
+  return true;
   }
 
 Mem32::Region* Mem32::translate(ptr32_t address) {
-  // TODO: binary-search
-  for(auto& rgn:region) {
-    if(rgn.address<=address && address<rgn.address+rgn.size && rgn.status!=S_Unused)
-      return &rgn;
-    }
-  return nullptr;
+  // scripts tend to access same block many times in a row
+  if(lastHit!=nullptr && lastHit->address<=address && address-lastHit->address<lastHit->size)
+    return lastHit;
+
+  auto it = region.upper_bound(address);
+  if(it==region.begin())
+    return nullptr;
+  --it;
+
+  auto& rgn = it->second;
+  if(rgn.status==S_Unused || address-rgn.address>=rgn.size)
+    return nullptr;
+  lastHit = &rgn;
+  return &rgn;
   }
@@ -3,6 +3,10 @@
 #include <functional>
 #include <vector>
 #include <memory>
+#include <map>
+#include <set>
+#include <cstdio>
+#include <cstdint>
 
 class Mem32 {
   public:
@@ -26,6 +30,26 @@ class Mem32 {
     int32_t readInt  (ptr32_t address);
     void    copyBytes(ptr32_t src, ptr32_t dst, uint32_t size);
 
+    // access trace: every call above is appended to file as TraceOp, for offline replay (OpenGothicBench)
+    enum TraceCode : uint32_t {
+      T_PinAt,   // a=address, b=size, c=result
+      T_Pin,     // b=size, c=result
+      T_AllocAt, // a=address, b=size, c=result
+      T_Alloc,   // b=size, c=result
+      T_Free,    // a=address
+      T_Realloc, // a=address, b=size, c=result
+      T_Read,    // a=address
+      T_Write,   // a=address, b=value
+      T_Copy,    // a=src, b=dst, c=size
+      };
+    struct TraceOp {
+      TraceCode code = T_Read;
+      uint32_t  a    = 0;
+      uint32_t  b    = 0;
+      uint32_t  c    = 0;
+      };
+    bool    startTrace(const char* path);
+
   private:
     enum Status:uint8_t {
       S_Unused,
@@ -45,12 +69,31 @@ class Mem32 {
       Status                              status  = S_Unused;
       };
 
+    using RegionMap = std::map<ptr32_t,Region>;
+    using Iterator  = RegionMap::iterator;
+    using FreeList  = std::set<std::pair<uint32_t,ptr32_t>>; // size, address
+
+    static constexpr uint32_t SizeClasses = 32;
+
+    ptr32_t  implAllocData(ptr32_t address, uint32_t size, const char* comment);
+    ptr32_t  implReallocData(ptr32_t address, uint32_t size);
+    void     record(TraceCode code, uint32_t a, uint32_t b, uint32_t c);
+
     Region*  implAlloc(uint32_t size);
     Region*  implAllocAt(ptr32_t address, uint32_t size);
     bool     implRealloc(ptr32_t address, uint32_t size);
     Region*  translate(ptr32_t address);
-    void     compactage();
+    void     release(Iterator it);
 
-    std::vector<Region> region;
-  };
+    Iterator findFree(uint32_t size);
+    void     addFree(const Region& r);
+    void     delFree(const Region& r);
+    static uint32_t sizeClass(uint32_t size);
 
+    // sorted by address; node-based, so Region* stays valid across inserts
+    RegionMap  region;
+    // unused regions, segregated by power-of-two size class
+    FreeList   freeList[SizeClasses];
+    Region*    lastHit = nullptr;
+    std::FILE* trace   = nullptr;
+  };
@@ -3,6 +3,7 @@
 #include <Tempest/Log>
 #include <Tempest/SoundEffect>
 
+#include <algorithm>
 #include <cctype>
 
 #include "game/definitions/spelldefinitions.h"
@@ -75,7 +76,7 @@ int GameScript::PerDist::at(PercType perc, int r) const {
 
 
 GameScript::GameScript(GameSession &owner)
-    :owner(owner), vm(createVm(Gothic::inst())) {
+    :owner(owner), vm(createVm(Gothic::inst())), prof(vm) {
   if (vm.global_self() == nullptr || vm.global_other() == nullptr || vm.global_item() == nullptr ||
       vm.global_victim() == nullptr || vm.global_hero() == nullptr)
     throw std::runtime_error("Cannot find script symbol SELF, OTHER, ITEM, VICTIM, or HERO! Cannot proceed!");
@@ -95,214 +96,218 @@ GameScript::~GameScript() {
   }
 
 void GameScript::initCommon() {
-  bindExternal("hlp_random",                     &GameScript::hlp_random);
-  bindExternal("hlp_isvalidnpc",                 &GameScript::hlp_isvalidnpc);
-  bindExternal("hlp_isvaliditem",                &GameScript::hlp_isvaliditem);
-  bindExternal("hlp_isitem",                     &GameScript::hlp_isitem);
-  bindExternal("hlp_getnpc",                     &GameScript::hlp_getnpc);
-  bindExternal("hlp_getinstanceid",              &GameScript::hlp_getinstanceid);
-
-  bindExternal("wld_insertnpc",                  &GameScript::wld_insertnpc);
-  bindExternal("wld_insertitem",                 &GameScript::wld_insertitem);
-  bindExternal("wld_settime",                    &GameScript::wld_settime);
-  bindExternal("wld_getday",                     &GameScript::wld_getday);
-  bindExternal("wld_playeffect",                 &GameScript::wld_playeffect);
-  bindExternal("wld_stopeffect",                 &GameScript::wld_stopeffect);
-  bindExternal("wld_getplayerportalguild",       &GameScript::wld_getplayerportalguild);
-  bindExternal("wld_getformerplayerportalguild", &GameScript::wld_getformerplayerportalguild);
-  bindExternal("wld_setguildattitude",           &GameScript::wld_setguildattitude);
-  bindExternal("wld_getguildattitude",           &GameScript::wld_getguildattitude);
-  bindExternal("wld_exchangeguildattitudes",     &GameScript::wld_exchangeguildattitudes);
-  bindExternal("wld_istime",                     &GameScript::wld_istime);
-  bindExternal("wld_isfpavailable",              &GameScript::wld_isfpavailable);
-  bindExternal("wld_isnextfpavailable",          &GameScript::wld_isnextfpavailable);
-  bindExternal("wld_ismobavailable",             &GameScript::wld_ismobavailable);
-  bindExternal("wld_setmobroutine",              &GameScript::wld_setmobroutine);
-  bindExternal("wld_getmobstate",                &GameScript::wld_getmobstate);
-  bindExternal("wld_assignroomtoguild",          &GameScript::wld_assignroomtoguild);
-  bindExternal("wld_detectnpc",                  &GameScript::wld_detectnpc);
-  bindExternal("wld_detectnpcex",                &GameScript::wld_detectnpcex);
-  bindExternal("wld_detectitem",                 &GameScript::wld_detectitem);
-  bindExternal("wld_spawnnpcrange",              &GameScript::wld_spawnnpcrange);
-  bindExternal("wld_sendtrigger",                &GameScript::wld_sendtrigger);
-  bindExternal("wld_senduntrigger",              &GameScript::wld_senduntrigger);
-  bindExternal("wld_israining",                  &GameScript::wld_israining);
-
-  bindExternal("mdl_setvisual",                  &GameScript::mdl_setvisual);
-  bindExternal("mdl_setvisualbody",              &GameScript::mdl_setvisualbody);
-  bindExternal("mdl_setmodelfatness",            &GameScript::mdl_setmodelfatness);
-  bindExternal("mdl_applyoverlaymds",            &GameScript::mdl_applyoverlaymds);
-  bindExternal("mdl_applyoverlaymdstimed",       &GameScript::mdl_applyoverlaymdstimed);
-  bindExternal("mdl_removeoverlaymds",           &GameScript::mdl_removeoverlaymds);
-  bindExternal("mdl_setmodelscale",              &GameScript::mdl_setmodelscale);
-  bindExternal("mdl_startfaceani",               &GameScript::mdl_startfaceani);
-  bindExternal("mdl_applyrandomani",             &GameScript::mdl_applyrandomani);
-  bindExternal("mdl_applyrandomanifreq",         &GameScript::mdl_applyrandomanifreq);
-  bindExternal("mdl_applyrandomfaceani",         &GameScript::mdl_applyrandomfaceani);
-
-  bindExternal("npc_settofightmode",             &GameScript::npc_settofightmode);
-  bindExternal("npc_settofistmode",              &GameScript::npc_settofistmode);
-  bindExternal("npc_isinstate",                  &GameScript::npc_isinstate);
-  bindExternal("npc_isinroutine",                &GameScript::npc_isinroutine);
-  bindExternal("npc_wasinstate",                 &GameScript::npc_wasinstate);
-  bindExternal("npc_getdisttowp",                &GameScript::npc_getdisttowp);
-  bindExternal("npc_exchangeroutine",            &GameScript::npc_exchangeroutine);
-  bindExternal("npc_isdead",                     &GameScript::npc_isdead);
-  bindExternal("npc_knowsinfo",                  &GameScript::npc_knowsinfo);
-  bindExternal("npc_settalentskill",             &GameScript::npc_settalentskill);
-  bindExternal("npc_gettalentskill",             &GameScript::npc_gettalentskill);
-  bindExternal("npc_settalentvalue",             &GameScript::npc_settalentvalue);
-  bindExternal("npc_gettalentvalue",             &GameScript::npc_gettalentvalue);
-  bindExternal("npc_setrefusetalk",              &GameScript::npc_setrefusetalk);
-  bindExternal("npc_refusetalk",                 &GameScript::npc_refusetalk);
-  bindExternal("npc_hasitems",                   &GameScript::npc_hasitems);
-  bindExternal("npc_hasspell",                   &GameScript::npc_hasspell);
-  bindExternal("npc_getinvitem",                 &GameScript::npc_getinvitem);
-  bindExternal("npc_removeinvitem",              &GameScript::npc_removeinvitem);
-  bindExternal("npc_removeinvitems",             &GameScript::npc_removeinvitems);
-  bindExternal("npc_getbodystate",               &GameScript::npc_getbodystate);
-  bindExternal("npc_getlookattarget",            &GameScript::npc_getlookattarget);
-  bindExternal("npc_getdisttonpc",               &GameScript::npc_getdisttonpc);
-  bindExternal("npc_hasequippedarmor",           &GameScript::npc_hasequippedarmor);
-  bindExternal("npc_setperctime",                &GameScript::npc_setperctime);
-  bindExternal("npc_percenable",                 &GameScript::npc_percenable);
-  bindExternal("npc_percdisable",                &GameScript::npc_percdisable);
-  bindExternal("npc_getnearestwp",               &GameScript::npc_getnearestwp);
-  bindExternal("npc_clearaiqueue",               &GameScript::npc_clearaiqueue);
-  bindExternal("npc_isplayer",                   &GameScript::npc_isplayer);
-  bindExternal("npc_getstatetime",               &GameScript::npc_getstatetime);
-  bindExternal("npc_setstatetime",               &GameScript::npc_setstatetime);
-  bindExternal("npc_changeattribute",            &GameScript::npc_changeattribute);
-  bindExternal("npc_isonfp",                     &GameScript::npc_isonfp);
-  bindExternal("npc_getheighttonpc",             &GameScript::npc_getheighttonpc);
-  bindExternal("npc_getequippedmeleeweapon",     &GameScript::npc_getequippedmeleeweapon);
-  bindExternal("npc_getequippedrangedweapon",    &GameScript::npc_getequippedrangedweapon);
-  bindExternal("npc_getequippedarmor",           &GameScript::npc_getequippedarmor);
-  bindExternal("npc_canseenpc",                  &GameScript::npc_canseenpc);
-  bindExternal("npc_canseenpcfreelos",           &GameScript::npc_canseenpcfreelos);
-  bindExternal("npc_canseeitem",                 &GameScript::npc_canseeitem);
-  bindExternal("npc_hasequippedweapon",          &GameScript::npc_hasequippedweapon);
-  bindExternal("npc_hasequippedmeleeweapon",     &GameScript::npc_hasequippedmeleeweapon);
-  bindExternal("npc_hasequippedrangedweapon",    &GameScript::npc_hasequippedrangedweapon);
-  bindExternal("npc_getactivespell",             &GameScript::npc_getactivespell);
-  bindExternal("npc_getactivespellisscroll",     &GameScript::npc_getactivespellisscroll);
-  bindExternal("npc_getactivespellcat",          &GameScript::npc_getactivespellcat);
-  bindExternal("npc_setactivespellinfo",         &GameScript::npc_setactivespellinfo);
-  bindExternal("npc_getactivespelllevel",        &GameScript::npc_getactivespelllevel);
-  bindExternal("npc_isinfightmode",              &GameScript::npc_isinfightmode);
-  bindExternal("npc_settarget",                  &GameScript::npc_settarget);
-  bindExternal("npc_gettarget",                  &GameScript::npc_gettarget);
-  bindExternal("npc_getnexttarget",              &GameScript::npc_getnexttarget);
-  bindExternal("npc_sendpassiveperc",            &GameScript::npc_sendpassiveperc);
-  bindExternal("npc_checkinfo",                  &GameScript::npc_checkinfo);
-  bindExternal("npc_getportalguild",             &GameScript::npc_getportalguild);
-  bindExternal("npc_isinplayersroom",            &GameScript::npc_isinplayersroom);
-  bindExternal("npc_getreadiedweapon",           &GameScript::npc_getreadiedweapon);
-  bindExternal("npc_hasreadiedweapon",           &GameScript::npc_hasreadiedweapon);
-  bindExternal("npc_hasreadiedmeleeweapon",      &GameScript::npc_hasreadiedmeleeweapon);
-  bindExternal("npc_hasreadiedrangedweapon",     &GameScript::npc_hasreadiedrangedweapon);
-  bindExternal("npc_hasrangedweaponwithammo",    &GameScript::npc_hasrangedweaponwithammo);
-  bindExternal("npc_isdrawingspell",             &GameScript::npc_isdrawingspell);
-  bindExternal("npc_isdrawingweapon",            &GameScript::npc_isdrawingweapon);
-  bindExternal("npc_perceiveall",                &GameScript::npc_perceiveall);
-  bindExternal("npc_stopani",                    &GameScript::npc_stopani);
-  bindExternal("npc_settrueguild",               &GameScript::npc_settrueguild);
-  bindExternal("npc_gettrueguild",               &GameScript::npc_gettrueguild);
-  bindExternal("npc_clearinventory",             &GameScript::npc_clearinventory);
-  bindExternal("npc_getattitude",                &GameScript::npc_getattitude);
-  bindExternal("npc_getpermattitude",            &GameScript::npc_getpermattitude);
-  bindExternal("npc_setattitude",                &GameScript::npc_setattitude);
-  bindExternal("npc_settempattitude",            &GameScript::npc_settempattitude);
-  bindExternal("npc_hasbodyflag",                &GameScript::npc_hasbodyflag);
-  bindExternal("npc_getlasthitspellid",          &GameScript::npc_getlasthitspellid);
-  bindExternal("npc_getlasthitspellcat",         &GameScript::npc_getlasthitspellcat);
-  bindExternal("npc_playani",                    &GameScript::npc_playani);
-  bindExternal("npc_isdetectedmobownedbynpc",    &GameScript::npc_isdetectedmobownedbynpc);
-  bindExternal("npc_getdetectedmob",             &GameScript::npc_getdetectedmob);
-  bindExternal("npc_isdetectedmobownedbyguild",  &GameScript::npc_isdetectedmobownedbyguild);
-  bindExternal("npc_ownedbynpc",                 &GameScript::npc_ownedbynpc);
-  bindExternal("npc_canseesource",               &GameScript::npc_canseesource);
-  bindExternal("npc_getdisttoitem",              &GameScript::npc_getdisttoitem);
-  bindExternal("npc_getheighttoitem",            &GameScript::npc_getheighttoitem);
-  bindExternal("npc_getdisttoplayer",            &GameScript::npc_getdisttoplayer);
-
-  bindExternal("ai_output",                      &GameScript::ai_output);
-  bindExternal("ai_stopprocessinfos",            &GameScript::ai_stopprocessinfos);
-  bindExternal("ai_processinfos",                &GameScript::ai_processinfos);
-  bindExternal("ai_standup",                     &GameScript::ai_standup);
-  bindExternal("ai_standupquick",                &GameScript::ai_standupquick);
-  bindExternal("ai_continueroutine",             &GameScript::ai_continueroutine);
-  bindExternal("ai_stoplookat",                  &GameScript::ai_stoplookat);
-  bindExternal("ai_lookat",                      &GameScript::ai_lookat);
-  bindExternal("ai_lookatnpc",                   &GameScript::ai_lookatnpc);
-  bindExternal("ai_removeweapon",                &GameScript::ai_removeweapon);
-  bindExternal("ai_unreadyspell",                &GameScript::ai_unreadyspell);
-  bindExternal("ai_turntonpc",                   &GameScript::ai_turntonpc);
-  bindExternal("ai_outputsvm",                   &GameScript::ai_outputsvm);
-  bindExternal("ai_outputsvm_overlay",           &GameScript::ai_outputsvm_overlay);
-  bindExternal("ai_startstate",                  &GameScript::ai_startstate);
-  bindExternal("ai_playani",                     &GameScript::ai_playani);
-  bindExternal("ai_setwalkmode",                 &GameScript::ai_setwalkmode);
-  bindExternal("ai_wait",                        &GameScript::ai_wait);
-  bindExternal("ai_waitms",                      &GameScript::ai_waitms);
-  bindExternal("ai_aligntowp",                   &GameScript::ai_aligntowp);
-  bindExternal("ai_gotowp",                      &GameScript::ai_gotowp);
-  bindExternal("ai_gotofp",                      &GameScript::ai_gotofp);
-  bindExternal("ai_playanibs",                   &GameScript::ai_playanibs);
-  bindExternal("ai_equiparmor",                  &GameScript::ai_equiparmor);
-  bindExternal("ai_equipbestarmor",              &GameScript::ai_equipbestarmor);
-  bindExternal("ai_equipbestmeleeweapon",        &GameScript::ai_equipbestmeleeweapon);
-  bindExternal("ai_equipbestrangedweapon",       &GameScript::ai_equipbestrangedweapon);
-  bindExternal("ai_usemob",                      &GameScript::ai_usemob);
-  bindExternal("ai_teleport",                    &GameScript::ai_teleport);
-  bindExternal("ai_stoppointat",                 &GameScript::ai_stoppointat);
-  bindExternal("ai_drawweapon",                  &GameScript::ai_drawweapon);
-  bindExternal("ai_readymeleeweapon",            &GameScript::ai_readymeleeweapon);
-  bindExternal("ai_readyrangedweapon",           &GameScript::ai_readyrangedweapon);
-  bindExternal("ai_readyspell",                  &GameScript::ai_readyspell);
-  bindExternal("ai_attack",                      &GameScript::ai_attack);
-  bindExternal("ai_flee",                        &GameScript::ai_flee);
-  bindExternal("ai_dodge",                       &GameScript::ai_dodge);
-  bindExternal("ai_unequipweapons",              &GameScript::ai_unequipweapons);
-  bindExternal("ai_unequiparmor",                &GameScript::ai_unequiparmor);
-  bindExternal("ai_gotonpc",                     &GameScript::ai_gotonpc);
-  bindExternal("ai_gotonextfp",                  &GameScript::ai_gotonextfp);
-  bindExternal("ai_aligntofp",                   &GameScript::ai_aligntofp);
-  bindExternal("ai_useitem",                     &GameScript::ai_useitem);
-  bindExternal("ai_useitemtostate",              &GameScript::ai_useitemtostate);
-  bindExternal("ai_setnpcstostate",              &GameScript::ai_setnpcstostate);
-  bindExternal("ai_finishingmove",               &GameScript::ai_finishingmove);
-  bindExternal("ai_takeitem",                    &GameScript::ai_takeitem);
-  bindExternal("ai_gotoitem",                    &GameScript::ai_gotoitem);
-  bindExternal("ai_pointat",                     &GameScript::ai_pointat);
-  bindExternal("ai_pointatnpc",                  &GameScript::ai_pointatnpc);
-
-  bindExternal("mob_hasitems",                   &GameScript::mob_hasitems);
-  bindExternal("ai_printscreen",                 &GameScript::ai_printscreen);
-
-  bindExternal("ta_min",                         &GameScript::ta_min);
-
-  bindExternal("log_createtopic",                &GameScript::log_createtopic);
-  bindExternal("log_settopicstatus",             &GameScript::log_settopicstatus);
-  bindExternal("log_addentry",                   &GameScript::log_addentry);
-
-  bindExternal("equipitem",                      &GameScript::equipitem);
-  bindExternal("createinvitem",                  &GameScript::createinvitem);
-  bindExternal("createinvitems",                 &GameScript::createinvitems);
-
-  bindExternal("perc_setrange",                  &GameScript::perc_setrange);
-
-  bindExternal("info_addchoice",                 &GameScript::info_addchoice);
-  bindExternal("info_clearchoices",              &GameScript::info_clearchoices);
-  bindExternal("infomanager_hasfinished",        &GameScript::infomanager_hasfinished);
-
-  bindExternal("snd_play",                       &GameScript::snd_play);
-  bindExternal("snd_play3d",                     &GameScript::snd_play3d);
-
-  bindExternal("game_initgerman",                &GameScript::game_initgerman);
-  bindExternal("game_initenglish",               &GameScript::game_initenglish);
-
-  bindExternal("exitsession",                    &GameScript::exitsession);
+  callStats.resize(vm.symbols().size());
+  for(size_t i=0; i<callStats.size(); ++i)
+    callStats[i].symbol = i;
+
+  bindExternal<&GameScript::hlp_random>("hlp_random");
+  bindExternal<&GameScript::hlp_isvalidnpc>("hlp_isvalidnpc");
+  bindExternal<&GameScript::hlp_isvaliditem>("hlp_isvaliditem");
+  bindExternal<&GameScript::hlp_isitem>("hlp_isitem");
+  bindExternal<&GameScript::hlp_getnpc>("hlp_getnpc");
+  bindExternal<&GameScript::hlp_getinstanceid>("hlp_getinstanceid");
+
+  bindExternal<&GameScript::wld_insertnpc>("wld_insertnpc");
+  bindExternal<&GameScript::wld_insertitem>("wld_insertitem");
+  bindExternal<&GameScript::wld_settime>("wld_settime");
+  bindExternal<&GameScript::wld_getday>("wld_getday");
+  bindExternal<&GameScript::wld_playeffect>("wld_playeffect");
+  bindExternal<&GameScript::wld_stopeffect>("wld_stopeffect");
+  bindExternal<&GameScript::wld_getplayerportalguild>("wld_getplayerportalguild");
+  bindExternal<&GameScript::wld_getformerplayerportalguild>("wld_getformerplayerportalguild");
+  bindExternal<&GameScript::wld_setguildattitude>("wld_setguildattitude");
+  bindExternal<&GameScript::wld_getguildattitude>("wld_getguildattitude");
+  bindExternal<&GameScript::wld_exchangeguildattitudes>("wld_exchangeguildattitudes");
+  bindExternal<&GameScript::wld_istime>("wld_istime");
+  bindExternal<&GameScript::wld_isfpavailable>("wld_isfpavailable");
+  bindExternal<&GameScript::wld_isnextfpavailable>("wld_isnextfpavailable");
+  bindExternal<&GameScript::wld_ismobavailable>("wld_ismobavailable");
+  bindExternal<&GameScript::wld_setmobroutine>("wld_setmobroutine");
+  bindExternal<&GameScript::wld_getmobstate>("wld_getmobstate");
+  bindExternal<&GameScript::wld_assignroomtoguild>("wld_assignroomtoguild");
+  bindExternal<&GameScript::wld_detectnpc>("wld_detectnpc");
+  bindExternal<&GameScript::wld_detectnpcex>("wld_detectnpcex");
+  bindExternal<&GameScript::wld_detectitem>("wld_detectitem");
+  bindExternal<&GameScript::wld_spawnnpcrange>("wld_spawnnpcrange");
+  bindExternal<&GameScript::wld_sendtrigger>("wld_sendtrigger");
+  bindExternal<&GameScript::wld_senduntrigger>("wld_senduntrigger");
+  bindExternal<&GameScript::wld_israining>("wld_israining");
+
+  bindExternal<&GameScript::mdl_setvisual>("mdl_setvisual");
+  bindExternal<&GameScript::mdl_setvisualbody>("mdl_setvisualbody");
+  bindExternal<&GameScript::mdl_setmodelfatness>("mdl_setmodelfatness");
+  bindExternal<&GameScript::mdl_applyoverlaymds>("mdl_applyoverlaymds");
+  bindExternal<&GameScript::mdl_applyoverlaymdstimed>("mdl_applyoverlaymdstimed");
+  bindExternal<&GameScript::mdl_removeoverlaymds>("mdl_removeoverlaymds");
+  bindExternal<&GameScript::mdl_setmodelscale>("mdl_setmodelscale");
+  bindExternal<&GameScript::mdl_startfaceani>("mdl_startfaceani");
+  bindExternal<&GameScript::mdl_applyrandomani>("mdl_applyrandomani");
+  bindExternal<&GameScript::mdl_applyrandomanifreq>("mdl_applyrandomanifreq");
+  bindExternal<&GameScript::mdl_applyrandomfaceani>("mdl_applyrandomfaceani");
+
+  bindExternal<&GameScript::npc_settofightmode>("npc_settofightmode");
+  bindExternal<&GameScript::npc_settofistmode>("npc_settofistmode");
+  bindExternal<&GameScript::npc_isinstate>("npc_isinstate");
+  bindExternal<&GameScript::npc_isinroutine>("npc_isinroutine");
+  bindExternal<&GameScript::npc_wasinstate>("npc_wasinstate");
+  bindExternal<&GameScript::npc_getdisttowp>("npc_getdisttowp");
+  bindExternal<&GameScript::npc_exchangeroutine>("npc_exchangeroutine");
+  bindExternal<&GameScript::npc_isdead>("npc_isdead");
+  bindExternal<&GameScript::npc_knowsinfo>("npc_knowsinfo");
+  bindExternal<&GameScript::npc_settalentskill>("npc_settalentskill");
+  bindExternal<&GameScript::npc_gettalentskill>("npc_gettalentskill");
+  bindExternal<&GameScript::npc_settalentvalue>("npc_settalentvalue");
+  bindExternal<&GameScript::npc_gettalentvalue>("npc_gettalentvalue");
+  bindExternal<&GameScript::npc_setrefusetalk>("npc_setrefusetalk");
+  bindExternal<&GameScript::npc_refusetalk>("npc_refusetalk");
+  bindExternal<&GameScript::npc_hasitems>("npc_hasitems");
+  bindExternal<&GameScript::npc_hasspell>("npc_hasspell");
+  bindExternal<&GameScript::npc_getinvitem>("npc_getinvitem");
+  bindExternal<&GameScript::npc_removeinvitem>("npc_removeinvitem");
+  bindExternal<&GameScript::npc_removeinvitems>("npc_removeinvitems");
+  bindExternal<&GameScript::npc_getbodystate>("npc_getbodystate");
+  bindExternal<&GameScript::npc_getlookattarget>("npc_getlookattarget");
+  bindExternal<&GameScript::npc_getdisttonpc>("npc_getdisttonpc");
+  bindExternal<&GameScript::npc_hasequippedarmor>("npc_hasequippedarmor");
+  bindExternal<&GameScript::npc_setperctime>("npc_setperctime");
+  bindExternal<&GameScript::npc_percenable>("npc_percenable");
+  bindExternal<&GameScript::npc_percdisable>("npc_percdisable");
+  bindExternal<&GameScript::npc_getnearestwp>("npc_getnearestwp");
+  bindExternal<&GameScript::npc_clearaiqueue>("npc_clearaiqueue");
+  bindExternal<&GameScript::npc_isplayer>("npc_isplayer");
+  bindExternal<&GameScript::npc_getstatetime>("npc_getstatetime");
+  bindExternal<&GameScript::npc_setstatetime>("npc_setstatetime");
+  bindExternal<&GameScript::npc_changeattribute>("npc_changeattribute");
+  bindExternal<&GameScript::npc_isonfp>("npc_isonfp");
+  bindExternal<&GameScript::npc_getheighttonpc>("npc_getheighttonpc");
+  bindExternal<&GameScript::npc_getequippedmeleeweapon>("npc_getequippedmeleeweapon");
+  bindExternal<&GameScript::npc_getequippedrangedweapon>("npc_getequippedrangedweapon");
+  bindExternal<&GameScript::npc_getequippedarmor>("npc_getequippedarmor");
+  bindExternal<&GameScript::npc_canseenpc>("npc_canseenpc");
+  bindExternal<&GameScript::npc_canseenpcfreelos>("npc_canseenpcfreelos");
+  bindExternal<&GameScript::npc_canseeitem>("npc_canseeitem");
+  bindExternal<&GameScript::npc_hasequippedweapon>("npc_hasequippedweapon");
+  bindExternal<&GameScript::npc_hasequippedmeleeweapon>("npc_hasequippedmeleeweapon");
+  bindExternal<&GameScript::npc_hasequippedrangedweapon>("npc_hasequippedrangedweapon");
+  bindExternal<&GameScript::npc_getactivespell>("npc_getactivespell");
+  bindExternal<&GameScript::npc_getactivespellisscroll>("npc_getactivespellisscroll");
+  bindExternal<&GameScript::npc_getactivespellcat>("npc_getactivespellcat");
+  bindExternal<&GameScript::npc_setactivespellinfo>("npc_setactivespellinfo");
+  bindExternal<&GameScript::npc_getactivespelllevel>("npc_getactivespelllevel");
+  bindExternal<&GameScript::npc_isinfightmode>("npc_isinfightmode");
+  bindExternal<&GameScript::npc_settarget>("npc_settarget");
+  bindExternal<&GameScript::npc_gettarget>("npc_gettarget");
+  bindExternal<&GameScript::npc_getnexttarget>("npc_getnexttarget");
+  bindExternal<&GameScript::npc_sendpassiveperc>("npc_sendpassiveperc");
+  bindExternal<&GameScript::npc_checkinfo>("npc_checkinfo");
+  bindExternal<&GameScript::npc_getportalguild>("npc_getportalguild");
+  bindExternal<&GameScript::npc_isinplayersroom>("npc_isinplayersroom");
+  bindExternal<&GameScript::npc_getreadiedweapon>("npc_getreadiedweapon");
+  bindExternal<&GameScript::npc_hasreadiedweapon>("npc_hasreadiedweapon");
+  bindExternal<&GameScript::npc_hasreadiedmeleeweapon>("npc_hasreadiedmeleeweapon");
+  bindExternal<&GameScript::npc_hasreadiedrangedweapon>("npc_hasreadiedrangedweapon");
+  bindExternal<&GameScript::npc_hasrangedweaponwithammo>("npc_hasrangedweaponwithammo");
+  bindExternal<&GameScript::npc_isdrawingspell>("npc_isdrawingspell");
+  bindExternal<&GameScript::npc_isdrawingweapon>("npc_isdrawingweapon");
+  bindExternal<&GameScript::npc_perceiveall>("npc_perceiveall");
+  bindExternal<&GameScript::npc_stopani>("npc_stopani");
+  bindExternal<&GameScript::npc_settrueguild>("npc_settrueguild");
+  bindExternal<&GameScript::npc_gettrueguild>("npc_gettrueguild");
+  bindExternal<&GameScript::npc_clearinventory>("npc_clearinventory");
+  bindExternal<&GameScript::npc_getattitude>("npc_getattitude");
+  bindExternal<&GameScript::npc_getpermattitude>("npc_getpermattitude");
+  bindExternal<&GameScript::npc_setattitude>("npc_setattitude");
+  bindExternal<&GameScript::npc_settempattitude>("npc_settempattitude");
+  bindExternal<&GameScript::npc_hasbodyflag>("npc_hasbodyflag");
+  bindExternal<&GameScript::npc_getlasthitspellid>("npc_getlasthitspellid");
+  bindExternal<&GameScript::npc_getlasthitspellcat>("npc_getlasthitspellcat");
+  bindExternal<&GameScript::npc_playani>("npc_playani");
+  bindExternal<&GameScript::npc_isdetectedmobownedbynpc>("npc_isdetectedmobownedbynpc");
+  bindExternal<&GameScript::npc_getdetectedmob>("npc_getdetectedmob");
+  bindExternal<&GameScript::npc_isdetectedmobownedbyguild>("npc_isdetectedmobownedbyguild");
+  bindExternal<&GameScript::npc_ownedbynpc>("npc_ownedbynpc");
+  bindExternal<&GameScript::npc_canseesource>("npc_canseesource");
+  bindExternal<&GameScript::npc_getdisttoitem>("npc_getdisttoitem");
+  bindExternal<&GameScript::npc_getheighttoitem>("npc_getheighttoitem");
+  bindExternal<&GameScript::npc_getdisttoplayer>("npc_getdisttoplayer");
+
+  bindExternal<&GameScript::ai_output>("ai_output");
+  bindExternal<&GameScript::ai_stopprocessinfos>("ai_stopprocessinfos");
+  bindExternal<&GameScript::ai_processinfos>("ai_processinfos");
+  bindExternal<&GameScript::ai_standup>("ai_standup");
+  bindExternal<&GameScript::ai_standupquick>("ai_standupquick");
+  bindExternal<&GameScript::ai_continueroutine>("ai_continueroutine");
+  bindExternal<&GameScript::ai_stoplookat>("ai_stoplookat");
+  bindExternal<&GameScript::ai_lookat>("ai_lookat");
+  bindExternal<&GameScript::ai_lookatnpc>("ai_lookatnpc");
+  bindExternal<&GameScript::ai_removeweapon>("ai_removeweapon");
+  bindExternal<&GameScript::ai_unreadyspell>("ai_unreadyspell");
+  bindExternal<&GameScript::ai_turntonpc>("ai_turntonpc");
+  bindExternal<&GameScript::ai_outputsvm>("ai_outputsvm");
+  bindExternal<&GameScript::ai_outputsvm_overlay>("ai_outputsvm_overlay");
+  bindExternal<&GameScript::ai_startstate>("ai_startstate");
+  bindExternal<&GameScript::ai_playani>("ai_playani");
+  bindExternal<&GameScript::ai_setwalkmode>("ai_setwalkmode");
+  bindExternal<&GameScript::ai_wait>("ai_wait");
+  bindExternal<&GameScript::ai_waitms>("ai_waitms");
+  bindExternal<&GameScript::ai_aligntowp>("ai_aligntowp");
+  bindExternal<&GameScript::ai_gotowp>("ai_gotowp");
+  bindExternal<&GameScript::ai_gotofp>("ai_gotofp");
+  bindExternal<&GameScript::ai_playanibs>("ai_playanibs");
+  bindExternal<&GameScript::ai_equiparmor>("ai_equiparmor");
+  bindExternal<&GameScript::ai_equipbestarmor>("ai_equipbestarmor");
+  bindExternal<&GameScript::ai_equipbestmeleeweapon>("ai_equipbestmeleeweapon");
+  bindExternal<&GameScript::ai_equipbestrangedweapon>("ai_equipbestrangedweapon");
+  bindExternal<&GameScript::ai_usemob>("ai_usemob");
+  bindExternal<&GameScript::ai_teleport>("ai_teleport");
+  bindExternal<&GameScript::ai_stoppointat>("ai_stoppointat");
+  bindExternal<&GameScript::ai_drawweapon>("ai_drawweapon");
+  bindExternal<&GameScript::ai_readymeleeweapon>("ai_readymeleeweapon");
+  bindExternal<&GameScript::ai_readyrangedweapon>("ai_readyrangedweapon");
+  bindExternal<&GameScript::ai_readyspell>("ai_readyspell");
+  bindExternal<&GameScript::ai_attack>("ai_attack");
+  bindExternal<&GameScript::ai_flee>("ai_flee");
+  bindExternal<&GameScript::ai_dodge>("ai_dodge");
+  bindExternal<&GameScript::ai_unequipweapons>("ai_unequipweapons");
+  bindExternal<&GameScript::ai_unequiparmor>("ai_unequiparmor");
+  bindExternal<&GameScript::ai_gotonpc>("ai_gotonpc");
+  bindExternal<&GameScript::ai_gotonextfp>("ai_gotonextfp");
+  bindExternal<&GameScript::ai_aligntofp>("ai_aligntofp");
+  bindExternal<&GameScript::ai_useitem>("ai_useitem");
+  bindExternal<&GameScript::ai_useitemtostate>("ai_useitemtostate");
+  bindExternal<&GameScript::ai_setnpcstostate>("ai_setnpcstostate");
+  bindExternal<&GameScript::ai_finishingmove>("ai_finishingmove");
+  bindExternal<&GameScript::ai_takeitem>("ai_takeitem");
+  bindExternal<&GameScript::ai_gotoitem>("ai_gotoitem");
+  bindExternal<&GameScript::ai_pointat>("ai_pointat");
+  bindExternal<&GameScript::ai_pointatnpc>("ai_pointatnpc");
+
+  bindExternal<&GameScript::mob_hasitems>("mob_hasitems");
+  bindExternal<&GameScript::ai_printscreen>("ai_printscreen");
+
+  bindExternal<&GameScript::ta_min>("ta_min");
+
+  bindExternal<&GameScript::log_createtopic>("log_createtopic");
+  bindExternal<&GameScript::log_settopicstatus>("log_settopicstatus");
+  bindExternal<&GameScript::log_addentry>("log_addentry");
+
+  bindExternal<&GameScript::equipitem>("equipitem");
+  bindExternal<&GameScript::createinvitem>("createinvitem");
+  bindExternal<&GameScript::createinvitems>("createinvitems");
+
+  bindExternal<&GameScript::perc_setrange>("perc_setrange");
+
+  bindExternal<&GameScript::info_addchoice>("info_addchoice");
+  bindExternal<&GameScript::info_clearchoices>("info_clearchoices");
+  bindExternal<&GameScript::infomanager_hasfinished>("infomanager_hasfinished");
+
+  bindExternal<&GameScript::snd_play>("snd_play");
+  bindExternal<&GameScript::snd_play3d>("snd_play3d");
+
+  bindExternal<&GameScript::game_initgerman>("game_initgerman");
+  bindExternal<&GameScript::game_initenglish>("game_initenglish");
+
+  bindExternal<&GameScript::exitsession>("exitsession");
 
   // vm.validateExternals();
 
@@ -413,6 +418,48 @@ void GameScript::initCommon() {
   if(LeGo::isRequired(vm)) {
     plugins.emplace_back(std::make_unique<LeGo>(*this,*ikarus,vm));
     }
+
+  resolveEntryPoints();
+  }
+
+void GameScript::resolveEntryPoints() {
+  entry = EntryPoints();
+  entry.G_CanNotUse                        = vm.find_symbol_by_name("G_CanNotUse");
+  entry.G_CanNotCast                       = vm.find_symbol_by_name("G_CanNotCast");
+  entry.G_PickLock                         = vm.find_symbol_by_name("G_PickLock");
+  entry.C_CanNpcCollideWithSpell           = vm.find_symbol_by_name("C_CanNpcCollideWithSpell");
+  entry.Spell_ProcessMana                  = vm.find_symbol_by_name("Spell_ProcessMana");
+  entry.Spell_ProcessMana_Release          = vm.find_symbol_by_name("Spell_ProcessMana_Release");
+  entry.player_trade_not_enough_gold       = vm.find_symbol_by_name("player_trade_not_enough_gold");
+  entry.player_mob_missing_item            = vm.find_symbol_by_name("player_mob_missing_item");
+  entry.player_mob_missing_key             = vm.find_symbol_by_name("player_mob_missing_key");
+  entry.player_mob_another_is_using        = vm.find_symbol_by_name("player_mob_another_is_using");
+  entry.player_mob_missing_key_or_lockpick = vm.find_symbol_by_name("player_mob_missing_key_or_lockpick");
+  entry.player_mob_missing_lockpick        = vm.find_symbol_by_name("player_mob_missing_lockpick");
+  entry.player_mob_too_far_away            = vm.find_symbol_by_name("player_mob_too_far_away");
+  entry.player_plunder_is_empty            = vm.find_symbol_by_name("player_plunder_is_empty");
+  entry.player_hotkey_screen_map           = vm.find_symbol_by_name("player_hotkey_screen_map");
+  entry.player_hotkey_lame_potion          = vm.find_symbol_by_name("player_hotkey_lame_potion");
+  entry.player_hotkey_lame_heal            = vm.find_symbol_by_name("player_hotkey_lame_heal");
+  entry.PLAYER_PERC_ASSESSMAGIC            = vm.find_symbol_by_name("PLAYER_PERC_ASSESSMAGIC");
+  entry.NPC_DAM_DIVE_TIME                  = vm.find_symbol_by_name("NPC_DAM_DIVE_TIME");
+
+  entry.spellCast.resize(spellFxInstanceNames->count());
+  for(uint32_t i=0; i<spellFxInstanceNames->count(); ++i) {
+    string_frm name("Spell_Cast_",spellFxInstanceNames->get_string(uint16_t(i)));
+    entry.spellCast[i] = vm.find_symbol_by_name(name);
+    }
+  functionByName.clear();
+  }
+
+zenkit::DaedalusSymbol* GameScript::findFunction(std::string_view name) {
+  // names come from world data (mobsi) - cache them as is, without case conversion
+  auto it = functionByName.find(name);
+  if(it!=functionByName.end())
+    return it->second;
+  auto fn = vm.find_symbol_by_name(name);
+  functionByName.emplace(std::string(name),fn);
+  return fn;
   }
 
 void GameScript::initSettings() {
@@ -489,7 +536,7 @@ void GameScript::initializeInstanceNpc(const std::shared_ptr<zenkit::INpc>& npc,
     auto* daily_routine = vm.find_symbol_by_index(uint32_t(npc->daily_routine));
 
     if(daily_routine != nullptr) {
-      vm.call_function(daily_routine);
+      callFunction(daily_routine);
       }
     }
   }
@@ -802,11 +849,42 @@ size_t GameScript::symbolsCount() const {
   return vm.symbols().size();
   }
 
+void GameScript::setCallStatsEnabled(bool e) {
+  if(e && !callStatsEnabled) {
+    for(auto& i:callStats) {
+      i.calls = 0;
+      i.time  = 0;
+      }
+    }
+  callStatsEnabled = e;
+  }
+
+std::vector<GameScript::CallStat> GameScript::callStatsTop(size_t count) const {
+  std::vector<CallStat> ret;
+  for(auto& i:callStats)
+    if(i.calls>0)
+      ret.push_back(i);
+  std::sort(ret.begin(),ret.end(),[](const CallStat& a, const CallStat& b){
+    return a.time>b.time;
+    });
+  if(ret.size()>count)
+    ret.resize(count);
+  return ret;
+  }
+
 const AiState& GameScript::aiState(ScriptFn id) {
-  auto it = aiStates.find(id.ptr);
-  if(it!=aiStates.end())
+  if(id.ptr<vm.symbols().size()) {
+    if(aiStates.size()<=id.ptr)
+      aiStates.resize(vm.symbols().size());
+    auto& st = aiStates[id.ptr];
+    if(st==nullptr)
+      st = std::make_unique<AiState>(*this,id.ptr);
+    return *st;
+    }
+  auto it = aiStatesExtra.find(id.ptr);
+  if(it!=aiStatesExtra.end())
     return it->second;
-  auto ins = aiStates.emplace(id.ptr,AiState(*this,id.ptr));
+  auto ins = aiStatesExtra.emplace(id.ptr,AiState(*this,id.ptr));
   return ins.first->second;
   }
 
@@ -859,7 +937,7 @@ std::vector<GameScript::DlgChoice> GameScript::dialogChoices(std::shared_ptr<zen
       if(info.condition) {
         auto* conditionSymbol = vm.find_symbol_by_index(uint32_t(info.condition));
         if (conditionSymbol != nullptr) {
-          valid = vm.call_function<int>(conditionSymbol) != 0;
+          valid = callFunction<int>(conditionSymbol) != 0;
           }
         }
       if(!valid)
@@ -925,91 +1003,91 @@ void GameScript::exec(const GameScript::DlgChoice &dlg, Npc& player, Npc& npc) {
         ++i;
       }
     }
-  vm.call_function(vm.find_symbol_by_index(dlg.scriptFn));
+  callFunction(vm.find_symbol_by_index(dlg.scriptFn));
   }
 
 void GameScript::printCannotUseError(Npc& npc, int32_t atr, int32_t nValue) {
-  auto id = vm.find_symbol_by_name("G_CanNotUse");
+  auto id = entry.G_CanNotUse;
   if(id==nullptr)
     return;
 
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  vm.call_function<void>(id, npc.isPlayer(), atr, nValue);
+  callFunction<void>(id, npc.isPlayer(), atr, nValue);
   }
 
 void GameScript::printCannotCastError(Npc &npc, int32_t plM, int32_t itM) {
-  auto id = vm.find_symbol_by_name("G_CanNotCast");
+  auto id = entry.G_CanNotCast;
   if(id==nullptr)
     return;
 
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  vm.call_function<void>(id, npc.isPlayer(), itM, plM);
+  callFunction<void>(id, npc.isPlayer(), itM, plM);
   }
 
 void GameScript::printCannotBuyError(Npc &npc) {
-  auto id = vm.find_symbol_by_name("player_trade_not_enough_gold");
+  auto id = entry.player_trade_not_enough_gold;
   if(id==nullptr)
     return;
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  vm.call_function<void>(id);
+  callFunction<void>(id);
   }
 
 void GameScript::printMobMissingItem(Npc &npc) {
-  auto id = vm.find_symbol_by_name("player_mob_missing_item");
+  auto id = entry.player_mob_missing_item;
   if(id==nullptr)
     return;
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  vm.call_function<void>(id);
+  callFunction<void>(id);
   }
 
 void GameScript::printMobMissingKey(Npc& npc) {
-  auto id = vm.find_symbol_by_name("player_mob_missing_key");
+  auto id = entry.player_mob_missing_key;
   if(id==nullptr)
     return;
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  vm.call_function<void>(id);
+  callFunction<void>(id);
   }
 
 void GameScript::printMobAnotherIsUsing(Npc &npc) {
-  auto id = vm.find_symbol_by_name("player_mob_another_is_using");
+  auto id = entry.player_mob_another_is_using;
   if(id==nullptr)
     return;
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  vm.call_function<void>(id);
+  callFunction<void>(id);
   }
 
 void GameScript::printMobMissingKeyOrLockpick(Npc& npc) {
-  auto id = vm.find_symbol_by_name("player_mob_missing_key_or_lockpick");
+  auto id = entry.player_mob_missing_key_or_lockpick;
   if(id==nullptr)
     return;
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  vm.call_function<void>(id);
+  callFunction<void>(id);
   }
 
 void GameScript::printMobMissingLockpick(Npc& npc) {
-  auto id = vm.find_symbol_by_name("player_mob_missing_lockpick");
+  auto id = entry.player_mob_missing_lockpick;
   if(id==nullptr)
     return;
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  vm.call_function<void>(id);
+  callFunction<void>(id);
   }
 
 void GameScript::printMobTooFar(Npc& npc) {
-  auto id = vm.find_symbol_by_name("player_mob_too_far_away");
+  auto id = entry.player_mob_too_far_away;
   if(id==nullptr)
     return;
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  vm.call_function<void>(id);
+  callFunction<void>(id);
   }
 
 void GameScript::invokeState(const std::shared_ptr<zenkit::INpc>& hnpc, const std::shared_ptr<zenkit::INpc>& oth, const char *name) {
-  auto id = vm.find_symbol_by_name(name);
+  auto id = findFunction(name);
   if(id==nullptr)
     return;
 
   ScopeVar self (*vm.global_self(),  hnpc);
   ScopeVar other(*vm.global_other(), oth);
-  vm.call_function<void>(id);
+  callFunction<void>(id);
   }
 
 int GameScript::invokeState(Npc* npc, Npc* oth, Npc* vic, ScriptFn fn) {
@@ -1035,10 +1113,10 @@ int GameScript::invokeState(Npc* npc, Npc* oth, Npc* vic, ScriptFn fn) {
   auto* sym = vm.find_symbol_by_index(uint32_t(fn.ptr));
   int   ret = 0;
   if(sym!=nullptr && sym->rtype() == zenkit::DaedalusDataType::INT) {
-    ret = vm.call_function<int>(sym);
+    ret = callFunction<int>(sym);
     }
   else if(sym!=nullptr) {
-    vm.call_function<void>(sym);
+    callFunction<void>(sym);
     ret = 0;
     }
 
@@ -1061,35 +1139,34 @@ void GameScript::invokeItem(Npc *npc, ScriptFn fn) {
     return;
 
   ScopeVar self(*vm.global_self(), npc->handlePtr());
-  vm.call_function<void>(functionSymbol);
+  callFunction<void>(functionSymbol);
   }
 
 int GameScript::invokeMana(Npc &npc, Npc* target, int mana) {
-  auto fn = vm.find_symbol_by_name("Spell_ProcessMana");
+  auto fn = entry.Spell_ProcessMana;
   if(fn==nullptr)
     return SpellCode::SPL_SENDSTOP;
 
   ScopeVar self (*vm.global_self(),  npc.handlePtr());
   ScopeVar other(*vm.global_other(), target != nullptr ? target->handlePtr() : nullptr);
 
-  return vm.call_function<int>(fn,mana);
+  return callFunction<int>(fn,mana);
   }
 
 int GameScript::invokeManaRelease(Npc &npc, Npc* target, int mana) {
-  auto fn = vm.find_symbol_by_name("Spell_ProcessMana_Release");
+  auto fn = entry.Spell_ProcessMana_Release;
   if(fn==nullptr)
     return SpellCode::SPL_SENDSTOP;
 
   ScopeVar self (*vm.global_self(),  npc.handlePtr());
   ScopeVar other(*vm.global_other(), target != nullptr ? target->handlePtr() : nullptr);
 
-  return vm.call_function<int>(fn,mana);
+  return callFunction<int>(fn,mana);
   }
 
 void GameScript::invokeSpell(Npc &npc, Npc* target, Item &it) {
-  auto&      tag = spellFxInstanceNames->get_string(uint16_t(it.spellId()));
-  string_frm name("Spell_Cast_",tag);
-  auto       fn = vm.find_symbol_by_name(name);
+  const size_t splId = size_t(it.spellId());
+  auto         fn    = splId<entry.spellCast.size() ? entry.spellCast[splId] : nullptr;
   if(fn==nullptr)
     return;
 
@@ -1100,51 +1177,51 @@ void GameScript::invokeSpell(Npc &npc, Npc* target, Item &it) {
   try {
     if(fn->count()==1) {
       // this is a leveled spell
-      vm.call_function<void>(fn, splLevel);
+      callFunction<void>(fn, splLevel);
       } else {
-      vm.call_function<void>(fn);
+      callFunction<void>(fn);
       }
     }
   catch(...) {
-    Log::d("unable to call spell-script: \"",name,"\'");
+    Log::d("unable to call spell-script: \"",fn->name(),"\'");
     }
   }
 
 int GameScript::invokeCond(Npc& npc, std::string_view func) {
-  auto fn = vm.find_symbol_by_name(func);
+  auto fn = findFunction(func);
   if(fn==nullptr) {
     Gothic::inst().onPrint("MOBSI::conditionFunc is not invalid");
     return 1;
     }
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  return vm.call_function<int>(fn);
+  return callFunction<int>(fn);
   }
 
 void GameScript::invokePickLock(Npc& npc, int bSuccess, int bBrokenOpen) {
-  auto fn   = vm.find_symbol_by_name("G_PickLock");
+  auto fn   = entry.G_PickLock;
   if(fn==nullptr)
     return;
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  vm.call_function<void>(fn, bSuccess, bBrokenOpen);
+  callFunction<void>(fn, bSuccess, bBrokenOpen);
   }
 
 CollideMask GameScript::canNpcCollideWithSpell(Npc& npc, Npc* shooter, int32_t spellId) {
-  auto fn   = vm.find_symbol_by_name("C_CanNpcCollideWithSpell");
+  auto fn   = entry.C_CanNpcCollideWithSpell;
   if(fn==nullptr)
     return COLL_DOEVERYTHING;
 
   ScopeVar self (*vm.global_self(),  npc.handlePtr());
   ScopeVar other(*vm.global_other(), shooter->handlePtr());
-  return CollideMask(vm.call_function<int>(fn, spellId));
+  return CollideMask(callFunction<int>(fn, spellId));
   }
 
 int GameScript::playerHotKeyScreenMap(Npc& pl) {
-  auto fn   = vm.find_symbol_by_name("player_hotkey_screen_map");
+  auto fn   = entry.player_hotkey_screen_map;
   if(fn==nullptr)
     return -1;
 
   ScopeVar self(*vm.global_self(), pl.handlePtr());
-  int map = vm.call_function<int>(fn);
+  int map = callFunction<int>(fn);
   if(map>=0)
     pl.useItem(size_t(map));
   return map;
@@ -1155,12 +1232,12 @@ void GameScript::playerHotLamePotion(Npc& pl) {
   if(opt==0)
     return;
 
-  auto fn   = vm.find_symbol_by_name("player_hotkey_lame_potion");
+  auto fn   = entry.player_hotkey_lame_potion;
   if(fn==nullptr)
     return;
 
   ScopeVar self(*vm.global_self(), pl.handlePtr());
-  vm.call_function<void>(fn);
+  callFunction<void>(fn);
   }
 
 void GameScript::playerHotLameHeal(Npc& pl) {
@@ -1168,12 +1245,12 @@ void GameScript::playerHotLameHeal(Npc& pl) {
   if(opt==0)
     return;
 
-  auto fn   = vm.find_symbol_by_name("player_hotkey_lame_heal");
+  auto fn   = entry.player_hotkey_lame_heal;
   if(fn==nullptr)
     return;
 
   ScopeVar self(*vm.global_self(), pl.handlePtr());
-  vm.call_function<void>(fn);
+  callFunction<void>(fn);
   }
 
 std::string_view GameScript::spellCastAnim(Npc&, Item &it) {
@@ -1254,21 +1331,21 @@ uint32_t GameScript::messageTime(std::string_view id) const {
   }
 
 void GameScript::printNothingToGet() {
-  auto id = vm.find_symbol_by_name("player_plunder_is_empty");
+  auto id = entry.player_plunder_is_empty;
   if(id==nullptr)
     return;
   ScopeVar self(*vm.global_self(), owner.player()->handlePtr());
-  vm.call_function<void>(id);
+  callFunction<void>(id);
   }
 
 void GameScript::useInteractive(const std::shared_ptr<zenkit::INpc>& hnpc, std::string_view func) {
-  auto fn = vm.find_symbol_by_name(func);
+  auto fn = findFunction(func);
   if(fn == nullptr)
     return;
 
   ScopeVar self(*vm.global_self(),hnpc);
   try {
-    vm.call_function<void>(fn);
+    callFunction<void>(fn);
     }
   catch (...) {
     Log::i("unable to use interactive [",func,"]");
@@ -1359,8 +1436,10 @@ uint64_t GameScript::tickCount() const {
   }
 
 void GameScript::tick(uint64_t dt) {
-  for(auto& i:plugins)
+  for(auto& i:plugins) {
+    ScriptProfiler::Scope scope(prof,ScriptProfiler::F_PluginTick);
     i->tick(dt);
+    }
   }
 
 uint32_t GameScript::rand(uint32_t max) {
@@ -1477,7 +1556,7 @@ AiOuputPipe *GameScript::openDlgOuput(Npc &player, Npc &npc) {
   }
 
 ScriptFn GameScript::playerPercAssessMagic() {
-  auto id = vm.find_symbol_by_name("PLAYER_PERC_ASSESSMAGIC");
+  auto id = entry.PLAYER_PERC_ASSESSMAGIC;
   if(id==nullptr)
     return ScriptFn();
 
@@ -1487,7 +1566,7 @@ ScriptFn GameScript::playerPercAssessMagic() {
   }
 
 int GameScript::npcDamDiveTime() {
-  auto id = vm.find_symbol_by_name("NPC_DAM_DIVE_TIME");
+  auto id = entry.NPC_DAM_DIVE_TIME;
   if(id==nullptr)
     return 0;
   return id->get_int();
@@ -1666,20 +1745,11 @@ bool GameScript::wld_detectnpc(std::shared_ptr<zenkit::INpc> npcRef, int inst, i
     return false;
     }
 
-  Npc*  ret =nullptr;
-  float dist=std::numeric_limits<float>::max();
-
-  world().detectNpc(npc->position(), float(npc->handle().senses_range), [inst,state,guild,&ret,&dist,npc](Npc& n){
-    if((inst ==-1 || int32_t(n.instanceSymbol())==inst) &&
-       (state==-1 || n.isState(uint32_t(state))) &&
-       (guild==-1 || int32_t(n.guild())==guild) &&
-       (&n!=npc) && !n.isDead()) {
-      float d = n.qDistTo(*npc);
-      if(d<dist){
-        ret = &n;
-        dist = d;
-        }
-      }
+  Npc* ret = world().findNearestNpc(npc->position(), float(npc->handle().senses_range), [inst,state,guild,npc](Npc& n){
+    return (inst ==-1 || int32_t(n.instanceSymbol())==inst) &&
+           (state==-1 || n.isState(uint32_t(state))) &&
+           (guild==-1 || int32_t(n.guild())==guild) &&
+           (&n!=npc) && !n.isDead();
     });
   if(ret)
     vm.global_other()->set_instance(ret->handlePtr());
@@ -1691,21 +1761,12 @@ bool GameScript::wld_detectnpcex(std::shared_ptr<zenkit::INpc> npcRef, int inst,
   if(npc==nullptr) {
     return false;
     }
-  Npc*  ret =nullptr;
-  float dist=std::numeric_limits<float>::max();
-
-  world().detectNpc(npc->position(), float(npc->handle().senses_range), [inst,state,guild,&ret,&dist,npc,player](Npc& n){
-    if((inst ==-1 || int32_t(n.instanceSymbol())==inst) &&
-       (state==-1 || n.isState(uint32_t(state))) &&
-       (guild==-1 || int32_t(n.guild())==guild) &&
-       (&n!=npc) && !n.isDead() &&
-       (player!=0 || !n.isPlayer())) {
-      float d = n.qDistTo(*npc);
-      if(d<dist){
-        ret = &n;
-        dist = d;
-        }
-      }
+  Npc* ret = world().findNearestNpc(npc->position(), float(npc->handle().senses_range), [inst,state,guild,npc,player](Npc& n){
+    return (inst ==-1 || int32_t(n.instanceSymbol())==inst) &&
+           (state==-1 || n.isState(uint32_t(state))) &&
+           (guild==-1 || int32_t(n.guild())==guild) &&
+           (&n!=npc) && !n.isDead() &&
+           (player!=0 || !n.isPlayer());
     });
   if(ret)
     vm.global_other()->set_instance(ret->handlePtr());
@@ -1751,7 +1812,7 @@ void GameScript::wld_sendtrigger(std::string_view triggerTarget) {
   if(triggerTarget.empty())
     return;
   auto& world = *owner.world();
-  const TriggerEvent evt(std::string{triggerTarget},"",world.tickCount(),TriggerEvent::T_Trigger);
+  const TriggerEvent evt(triggerTarget,"",world.tickCount(),TriggerEvent::T_Trigger);
   world.triggerEvent(evt);
   }
 
@@ -1759,7 +1820,7 @@ void GameScript::wld_senduntrigger(std::string_view triggerTarget) {
   if(triggerTarget.empty())
     return;
   auto& world = *owner.world();
-  const TriggerEvent evt(std::string{triggerTarget},"",world.tickCount(),TriggerEvent::T_Untrigger);
+  const TriggerEvent evt(triggerTarget,"",world.tickCount(),TriggerEvent::T_Untrigger);
   world.triggerEvent(evt);
   }
 
@@ -2297,18 +2358,8 @@ bool GameScript::npc_getnexttarget(std::shared_ptr<zenkit::INpc> npcRef) {
   Npc* ret = nullptr;
 
   if(npc!=nullptr){
-    float dist = float(npc->handle().senses_range);
-    dist*=dist;
-
-    world().detectNpc(npc->position(),float(npc->handle().senses_range),[&,npc](Npc& oth){
-      if(&oth!=npc && !oth.isDown() && oth.isEnemy(*npc) && npc->canSenseNpc(oth,true)!=SensesBit::SENSE_NONE){
-        float qd = oth.qDistTo(*npc);
-        if(qd<dist){
-          dist=qd;
-          ret = &oth;
-          }
-        }
-      return false;
+    ret = world().findNearestNpc(npc->position(),float(npc->handle().senses_range),[npc](Npc& oth){
+      return &oth!=npc && !oth.isDown() && oth.isEnemy(*npc) && npc->canSenseNpc(oth,true)!=SensesBit::SENSE_NONE;
       });
     if(ret!=nullptr)
       npc->setTarget(ret);
@@ -2351,7 +2402,7 @@ bool GameScript::npc_checkinfo(std::shared_ptr<zenkit::INpc> npcRef, int imp) {
     if(info->condition) {
       auto* conditionSymbol = vm.find_symbol_by_index(uint32_t(info->condition));
       if (conditionSymbol != nullptr)
-        valid = vm.call_function<int>(conditionSymbol)!=0;
+        valid = callFunction<int>(conditionSymbol)!=0;
       }
     if(valid) {
       return true;
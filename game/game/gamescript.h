@@ -7,6 +7,7 @@
 #include <memory>
 #include <set>
 #include <random>
+#include <chrono>
 
 #include <Tempest/Matrix4x4>
 #include <Tempest/Painter>
@@ -17,6 +18,7 @@
 #include "game/constants.h"
 #include "game/aistate.h"
 #include "game/questlog.h"
+#include "game/scriptprofiler.h"
 
 class GameSession;
 class World;
@@ -111,6 +113,16 @@ class GameScript final {
     size_t                       findSymbolIndex(std::string_view s);
     size_t                       symbolsCount() const;
 
+    struct CallStat final {
+      size_t   symbol = 0;
+      uint64_t calls  = 0;
+      uint64_t time   = 0; // nanoseconds, including nested calls
+      };
+    void                         setCallStatsEnabled(bool e);
+    bool                         isCallStatsEnabled() const { return callStatsEnabled; }
+    std::vector<CallStat>        callStatsTop(size_t count) const;
+    ScriptProfiler&              profiler() { return prof; }
+
     const AiState&               aiState  (ScriptFn id);
     const zenkit::ISpell&        spellDesc(int32_t splId);
     const VisualFx*              spellVfx (int32_t splId);
@@ -177,6 +189,11 @@ class GameScript final {
       using signature = R(P...);
       };
 
+    struct StringHash {
+      using is_transparent = void;
+      size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+      };
+
     struct GlobalOutput : AiOuputPipe {
       explicit GlobalOutput(GameScript& owner):owner(owner){}
 
@@ -191,12 +208,72 @@ class GameScript final {
       GameScript& owner;
       };
 
-    template <class F>
-    void bindExternal(const std::string& name, F function) {
-      vm.register_external(name, std::function<typename DetermineSignature<F>::signature> (
-                                   [this, function](auto ... v) { return (this->*function)(v...); }));
+    // entry points, resolved once after script load
+    struct EntryPoints final {
+      zenkit::DaedalusSymbol* G_CanNotUse                        = nullptr;
+      zenkit::DaedalusSymbol* G_CanNotCast                       = nullptr;
+      zenkit::DaedalusSymbol* G_PickLock                         = nullptr;
+      zenkit::DaedalusSymbol* C_CanNpcCollideWithSpell           = nullptr;
+      zenkit::DaedalusSymbol* Spell_ProcessMana                  = nullptr;
+      zenkit::DaedalusSymbol* Spell_ProcessMana_Release          = nullptr;
+      zenkit::DaedalusSymbol* player_trade_not_enough_gold       = nullptr;
+      zenkit::DaedalusSymbol* player_mob_missing_item            = nullptr;
+      zenkit::DaedalusSymbol* player_mob_missing_key             = nullptr;
+      zenkit::DaedalusSymbol* player_mob_another_is_using        = nullptr;
+      zenkit::DaedalusSymbol* player_mob_missing_key_or_lockpick = nullptr;
+      zenkit::DaedalusSymbol* player_mob_missing_lockpick        = nullptr;
+      zenkit::DaedalusSymbol* player_mob_too_far_away            = nullptr;
+      zenkit::DaedalusSymbol* player_plunder_is_empty            = nullptr;
+      zenkit::DaedalusSymbol* player_hotkey_screen_map           = nullptr;
+      zenkit::DaedalusSymbol* player_hotkey_lame_potion          = nullptr;
+      zenkit::DaedalusSymbol* player_hotkey_lame_heal            = nullptr;
+      zenkit::DaedalusSymbol* PLAYER_PERC_ASSESSMAGIC            = nullptr;
+      zenkit::DaedalusSymbol* NPC_DAM_DIVE_TIME                  = nullptr;
+      std::vector<zenkit::DaedalusSymbol*> spellCast; // Spell_Cast_* by spell id
+      };
+
+    struct CallScope final {
+      CallScope(GameScript& owner, size_t symbol):frame(owner.prof,symbol) {
+        if(!owner.callStatsEnabled || symbol>=owner.callStats.size())
+          return;
+        stat = &owner.callStats[symbol];
+        t0   = std::chrono::steady_clock::now();
+        }
+      CallScope(const CallScope&)=delete;
+      ~CallScope() {
+        if(stat==nullptr)
+          return;
+        auto dt = std::chrono::steady_clock::now()-t0;
+        stat->calls++;
+        stat->time += uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(dt).count());
+        }
+
+      ScriptProfiler::Scope                 frame;
+      CallStat*                             stat = nullptr;
+      std::chrono::steady_clock::time_point t0;
+      };
+
+    // member function is a template argument: wrapper captures only 'this' and stays in std::function small buffer
+    template <auto function>
+    void bindExternal(const std::string& name) {
+      auto*        sym = vm.find_symbol_by_name(name);
+      const size_t id  = sym!=nullptr ? sym->index() : size_t(-1);
+      vm.register_external(name, std::function<typename DetermineSignature<decltype(function)>::signature> (
+                                   [this, id](auto ... v) {
+                                     CallScope scope(*this,id);
+                                     return (this->*function)(v...);
+                                     }));
       }
 
+    template <class R = void, class ... Args>
+    R callFunction(zenkit::DaedalusSymbol* fn, Args ... args) {
+      CallScope scope(*this,fn!=nullptr ? fn->index() : size_t(-1));
+      return vm.call_function<R>(fn, args...);
+      }
+
+    void  resolveEntryPoints();
+    auto  findFunction(std::string_view name) -> zenkit::DaedalusSymbol*;
+
     void  initCommon();
     void  initSettings();
     void  loadDialogOU();
@@ -441,6 +518,7 @@ class GameScript final {
 
     GameSession&                                                owner;
     zenkit::DaedalusVm                                          vm;
+    ScriptProfiler                                              prof;
     int32_t                                                     vmLang = -1;
     std::mt19937                                                randGen;
 
@@ -453,7 +531,12 @@ class GameScript final {
     std::set<std::pair<size_t,size_t>>                          dlgKnownInfos;
     std::vector<std::shared_ptr<zenkit::IInfo>>                 dialogsInfo;
     zenkit::CutsceneLibrary                                     dialogs;
-    std::unordered_map<size_t,AiState>                          aiStates;
+    std::vector<std::unique_ptr<AiState>>                       aiStates;      // by symbol index
+    std::unordered_map<size_t,AiState>                          aiStatesExtra; // invalid symbols
+    EntryPoints                                                 entry;
+    std::unordered_map<std::string,zenkit::DaedalusSymbol*,StringHash,std::equal_to<>> functionByName;
+    std::vector<CallStat>                                       callStats;
+    bool                                                        callStatsEnabled = false;
     std::unique_ptr<AiOuputPipe>                                aiDefaultPipe;
 
     QuestLog                                                    quests;
@@ -0,0 +1,128 @@
+#include "scriptprofiler.h"
+
+#include <Tempest/Log>
+
+#include <algorithm>
+#include <fstream>
+
+using namespace Tempest;
+
+ScriptProfiler::ScriptProfiler(zenkit::DaedalusVm& vm)
+  :vm(vm) {
+  }
+
+void ScriptProfiler::start() {
+  nodes.clear();
+  children.clear();
+  stack.clear();
+  nodes.emplace_back();
+  active = true;
+  }
+
+void ScriptProfiler::stop() {
+  active = false;
+  }
+
+void ScriptProfiler::enter(uint32_t symbol) {
+  const uint32_t parent = stack.empty() ? 0 : stack.back().node;
+  const uint64_t key    = (uint64_t(parent) << 32) | symbol;
+
+  uint32_t id = 0;
+  auto     it = children.find(key);
+  if(it==children.end()) {
+    id = uint32_t(nodes.size());
+    Node n;
+    n.parent = parent;
+    n.symbol = symbol;
+    nodes.push_back(n);
+    children.emplace(key,id);
+    } else {
+    id = it->second;
+    }
+
+  nodes[id].calls++;
+  Frame f;
+  f.node = id;
+  f.t0   = clock::now();
+  stack.push_back(f);
+  }
+
+void ScriptProfiler::leave() {
+  // profiler was restarted, while frame was open
+  if(stack.empty())
+    return;
+
+  const Frame    f  = stack.back();
+  const uint64_t dt = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now()-f.t0).count());
+  stack.pop_back();
+
+  auto& n = nodes[f.node];
+  n.total += dt;
+  n.self  += (dt>f.child ? dt-f.child : 0);
+  if(!stack.empty())
+    stack.back().child += dt;
+  }
+
+bool ScriptProfiler::isRecursive(const Node& n) const {
+  for(uint32_t p=n.parent; p!=0; p=nodes[p].parent)
+    if(nodes[p].symbol==n.symbol)
+      return true;
+  return false;
+  }
+
+std::string_view ScriptProfiler::name(uint32_t symbol) const {
+  if(symbol==F_PluginTick)
+    return "[plugins]";
+  if(auto sym = vm.find_symbol_by_index(symbol))
+    return sym->name();
+  return "[unknown]";
+  }
+
+bool ScriptProfiler::dump(const std::string& path) const {
+  std::ofstream fout(path, std::ios::trunc);
+  if(!fout.is_open()) {
+    Log::e("unable to write script profile: \"",path,"\"");
+    return false;
+    }
+
+  std::vector<uint32_t> chain;
+  for(size_t i=1; i<nodes.size(); ++i) {
+    auto& n = nodes[i];
+    if(n.self/1000==0)
+      continue;
+    chain.clear();
+    for(uint32_t p=uint32_t(i); p!=0; p=nodes[p].parent)
+      chain.push_back(nodes[p].symbol);
+    for(size_t r=chain.size(); r>0; --r) {
+      fout << name(chain[r-1]);
+      if(r>1)
+        fout << ';';
+      }
+    fout << ' ' << (n.self/1000) << '\n';
+    }
+  return fout.good();
+  }
+
+std::vector<ScriptProfiler::Stat> ScriptProfiler::top(size_t count) const {
+  std::unordered_map<uint32_t,Stat> agg;
+  for(size_t i=1; i<nodes.size(); ++i) {
+    auto& n = nodes[i];
+    auto& s = agg[n.symbol];
+    s.symbol = n.symbol;
+    s.calls += n.calls;
+    s.self  += n.self;
+    if(!isRecursive(n))
+      s.total += n.total;
+    }
+
+  std::vector<Stat> ret;
+  ret.reserve(agg.size());
+  for(auto& i:agg)
+    ret.push_back(i.second);
+  std::sort(ret.begin(),ret.end(),[](const Stat& a, const Stat& b){
+    return a.self>b.self;
+    });
+  if(ret.size()>count)
+    ret.resize(count);
+  return ret;
+  }
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <zenkit/DaedalusVm.hh>
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+// Instrumenting profiler for script code.
+// Frames are recorded at engine/script boundaries: engine entry points, externals and plugin ticks;
+// time spent in script-to-script calls is attributed to the nearest recorded frame.
+class ScriptProfiler final {
+  public:
+    explicit ScriptProfiler(zenkit::DaedalusVm& vm);
+
+    // pseudo-symbols, for frames without script function
+    enum : uint32_t {
+      F_PluginTick = uint32_t(-2),
+      };
+
+    struct Scope final {
+      Scope(ScriptProfiler& p, size_t symbol):prof(p.active ? &p : nullptr) {
+        if(prof!=nullptr)
+          prof->enter(uint32_t(symbol));
+        }
+      Scope(const Scope&)=delete;
+      ~Scope() {
+        if(prof!=nullptr)
+          prof->leave();
+        }
+      ScriptProfiler* prof = nullptr;
+      };
+
+    struct Stat final {
+      uint32_t symbol = 0;
+      uint64_t calls  = 0;
+      uint64_t self   = 0; // nanoseconds
+      uint64_t total  = 0; // nanoseconds, recursive calls are counted once
+      };
+
+    bool   isActive() const { return active; }
+    void   start();
+    void   stop();
+
+    // collapsed-stack format: "frame;frame;frame self_us" per line, as consumed by flamegraph.pl
+    bool   dump(const std::string& path) const;
+    auto   top(size_t count) const -> std::vector<Stat>;
+    auto   name(uint32_t symbol) const -> std::string_view;
+
+  private:
+    using clock = std::chrono::steady_clock;
+
+    struct Node final {
+      uint32_t parent = 0;
+      uint32_t symbol = 0;
+      uint64_t calls  = 0;
+      uint64_t self   = 0;
+      uint64_t total  = 0;
+      };
+
+    struct Frame final {
+      uint32_t          node  = 0;
+      clock::time_point t0;
+      uint64_t          child = 0;
+      };
+
+    void   enter(uint32_t symbol);
+    void   leave();
+    bool   isRecursive(const Node& n) const;
+
+    zenkit::DaedalusVm&                    vm;
+    bool                                   active = false;
+    std::vector<Node>                      nodes; // calling-context tree; nodes[0] is root
+    std::unordered_map<uint64_t,uint32_t>  children;
+    std::vector<Frame>                     stack;
+  };
@@ -6,12 +6,38 @@
 #include "world/world.h"
 #include "world/fplock.h"
 #include "world/waypoint.h"
+#include "utils/workers.h"
 
 #include <Tempest/MemReader>
 #include <Tempest/MemWriter>
 #include <Tempest/Log>
 #include <Tempest/Application>
 
+struct Serialize::PendingEntry {
+  std::string          name;
+  std::vector<uint8_t> data;
+  bool                 deflate = false;
+
+  // output of worker
+  Workers::Task        task;
+  void*                packed     = nullptr;
+  size_t               packedSize = 0;
+  mz_uint32            crc        = 0;
+
+  ~PendingEntry() { mz_free(packed); }
+
+  void compress() {
+    static const mz_uint flags = tdefl_create_comp_flags_from_zip_params(MZ_BEST_SPEED,-MZ_DEFAULT_WINDOW_BITS,MZ_DEFAULT_STRATEGY);
+    crc    = mz_uint32(mz_crc32(MZ_CRC32_INIT,data.data(),data.size()));
+    packed = tdefl_compress_mem_to_heap(data.data(),data.size(),&packedSize,int(flags));
+    if(packed!=nullptr && packedSize>=data.size()) {
+      // incompressible - store as is
+      mz_free(packed);
+      packed = nullptr;
+      }
+    }
+  };
+
 size_t Serialize::writeFunc(void* pOpaque, uint64_t file_ofs, const void* pBuf, size_t n) {
   auto& self = *reinterpret_cast<Serialize*>(pOpaque);
   file_ofs += mz_zip_get_archive_file_start_offset(&self.impl);
@@ -75,8 +101,13 @@ Serialize::Serialize(Tempest::IDevice& fin) : fin(&fin) {
   mz_zip_reader_init(&impl, fin.size(), 0);
   }
 
+Serialize::Serialize(Snapshot& dst) : snapshot(&dst) {
+  entryName.reserve(256);
+  }
+
 Serialize::~Serialize() {
   closeEntry();
+  flushEntries(0);
   if(fout!=nullptr) {
     mz_zip_writer_finalize_archive(&impl);
     mz_zip_writer_end(&impl);
@@ -90,16 +121,93 @@ std::string_view Serialize::worldName() const {
   return "_";
   }
 
+size_t Serialize::Snapshot::byteSize() const {
+  size_t sz = 0;
+  for(auto& i:entries)
+    sz += i.data.size();
+  return sz;
+  }
+
+void Serialize::writeSnapshot(Tempest::ODevice& fout, Snapshot&& snap) {
+  Serialize s(fout);
+  for(auto& e:snap.entries) {
+    s.implSetEntry(e.name);
+    s.entryStored = e.stored;
+    if(e.pixmapAt==size_t(-1)) {
+      s.entryBuf = std::move(e.data);
+      continue;
+      }
+    s.writeBytes(e.data.data(),e.pixmapAt);
+    s.implWrite(e.pixmap);
+    s.writeBytes(e.data.data()+e.pixmapAt,e.data.size()-e.pixmapAt);
+    e = Snapshot::Entry();
+    }
+  }
+
 void Serialize::closeEntry() {
+  if(snapshot!=nullptr) {
+    if(entryBuf.empty() && entryPixmapAt==size_t(-1))
+      return;
+    Snapshot::Entry e;
+    e.name     = std::move(entryName);
+    e.data     = std::move(entryBuf);
+    e.stored   = entryStored;
+    e.pixmap   = std::move(entryPixmap);
+    e.pixmapAt = entryPixmapAt;
+    snapshot->entries.emplace_back(std::move(e));
+    entryName.clear();
+    entryBuf.clear();
+    entryPixmap   = Tempest::Pixmap();
+    entryPixmapAt = size_t(-1);
+    return;
+    }
   if(fout==nullptr)
     return;
   if(entryBuf.empty())
     return;
 
-  mz_uint level  = entryBuf.size()>256 ? MZ_BEST_SPEED : MZ_NO_COMPRESSION;
-  mz_bool status = mz_zip_writer_add_mem(&impl, entryName.c_str(), entryBuf.data(), entryBuf.size(), level);
-  entryBuf .clear();
+  auto e = std::make_shared<PendingEntry>();
+  e->name    = std::move(entryName);
+  e->data    = std::move(entryBuf);
+  e->deflate = e->data.size()>256 && !entryStored;
+
   entryName.clear();
+  entryBuf.clear();
+  if(!spareBuf.empty()) {
+    entryBuf = std::move(spareBuf.back());
+    spareBuf.pop_back();
+    }
+
+  if(e->deflate)
+    e->task = Workers::async([e](){ e->compress(); });
+  pending.push_back(std::move(e));
+  flushEntries(2*Workers::maxThreads());
+  }
+
+void Serialize::flushEntries(size_t maxPending) {
+  while(!pending.empty()) {
+    // finished entries are written right away; wait only if too many are in flight
+    if(pending.size()>maxPending)
+      pending.front()->task.wait();
+    else if(!pending.front()->task.isDone())
+      break;
+    auto e = std::move(pending.front());
+    pending.erase(pending.begin());
+    writeEntry(*e);
+    }
+  }
+
+void Serialize::writeEntry(PendingEntry& e) {
+  mz_bool status = MZ_FALSE;
+  if(e.packed!=nullptr) {
+    status = mz_zip_writer_add_mem_ex_v2(&impl, e.name.c_str(), e.packed, e.packedSize, nullptr, 0,
+                                         MZ_BEST_SPEED | MZ_ZIP_FLAG_COMPRESSED_DATA, e.data.size(), e.crc,
+                                         nullptr, nullptr, 0, nullptr, 0);
+    } else {
+    status = mz_zip_writer_add_mem(&impl, e.name.c_str(), e.data.data(), e.data.size(), MZ_NO_COMPRESSION);
+    }
+  e.data.clear();
+  spareBuf.emplace_back(std::move(e.data));
   if(!status)
     throw std::runtime_error("unable to write entry in game archive");
   }
@@ -114,7 +222,10 @@ bool Serialize::implSetEntry(std::string_view fname) {
       }
     }
   closeEntry();
-  entryName = fname;
+  entryName   = fname;
+  entryStored = false;
+  if(snapshot!=nullptr)
+    return true;
   if(fout!=nullptr) {
     for(size_t i=prefix; i<entryName.size(); ++i) {
       if(entryName[i]=='/' && i+1<entryName.size()) {
@@ -273,6 +384,12 @@ void Serialize::implRead(SaveGameHeader& p) {
   }
 
 void Serialize::implWrite(const Tempest::Pixmap& p) {
+  if(snapshot!=nullptr && entryPixmapAt==size_t(-1)) {
+    // defer image encoding to writeSnapshot
+    entryPixmap   = p;
+    entryPixmapAt = entryBuf.size();
+    return;
+    }
   std::vector<uint8_t> tmp;
   tmp.reserve(4*1024*1024);
   Tempest::MemWriter w{tmp};
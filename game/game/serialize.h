@@ -7,6 +7,8 @@
 #include <Tempest/Matrix4x4>
 
 #include <vector>
+#include <memory>
+#include <string>
 #include <cstdint>
 #include <type_traits>
 #include <ctime>
@@ -34,8 +36,23 @@ class Serialize {
     enum Version : uint16_t {
       Current = 49
       };
+
+    // in-memory copy of savegame entries, see writeSnapshot
+    struct Snapshot {
+      struct Entry {
+        std::string          name;
+        std::vector<uint8_t> data;
+        bool                 stored   = false;
+        Tempest::Pixmap      pixmap; // encoded on write, inserted at pixmapAt
+        size_t               pixmapAt = size_t(-1);
+        };
+      std::vector<Entry> entries;
+      size_t             byteSize() const;
+      };
+
     Serialize(Tempest::ODevice& fout);
     Serialize(Tempest::IDevice&  fin);
+    Serialize(Snapshot& dst);
     Serialize(Serialize&&)=default;
     ~Serialize();
 
@@ -56,6 +73,9 @@ class Serialize {
       return implDirectorySize(s);
       }
 
+    // keep current entry uncompressed; for payloads that are compressed already
+    void setEntryStored() { entryStored = true; }
+
     void setContext(World* ctx) { this->ctx=ctx; }
     std::string_view worldName() const;
 
@@ -75,6 +95,9 @@ class Serialize {
 
     void readNpc(zenkit::DaedalusVm& vm, std::shared_ptr<zenkit::INpc>& npc);
 
+    // encodes, compresses and writes snapshot as a regular savegame archive
+    static void writeSnapshot(Tempest::ODevice& fout, Snapshot&& snap);
+
   private:
     Serialize();
 
@@ -267,7 +290,11 @@ class Serialize {
     static size_t writeFunc(void *pOpaque, uint64_t file_ofs, const void *pBuf, size_t n);
     static size_t readFunc (void *pOpaque, uint64_t file_ofs, void *pBuf, size_t n);
 
+    struct PendingEntry;
+
     void   closeEntry();
+    void   flushEntries(size_t maxPending);
+    void   writeEntry(PendingEntry& e);
     bool   implSetEntry(std::string_view e);
     uint32_t implDirectorySize(std::string_view e);
 
@@ -280,6 +307,13 @@ class Serialize {
     mz_zip_archive           impl      = {};
     std::string              entryName;
     std::vector<uint8_t>     entryBuf;
+    bool                     entryStored = false;
+    Snapshot*                snapshot    = nullptr;
+    Tempest::Pixmap          entryPixmap;
+    size_t                   entryPixmapAt = size_t(-1);
+    // entries compressed on workers; written to archive in order
+    std::vector<std::shared_ptr<PendingEntry>> pending;
+    std::vector<std::vector<uint8_t>>          spareBuf;
     uint64_t                 curOffset = 0;
     uint64_t                 readOffset = 0;
     Tempest::ODevice*        fout      = nullptr;
@@ -16,6 +16,7 @@ WorldStateStorage::WorldStateStorage(World &w)
 
 void WorldStateStorage::save(Serialize &fout) const {
   fout.setEntry("worlds/",name,".zip");
+  fout.setEntryStored();
   fout.write(storage);
   }
 
@@ -6,99 +6,125 @@
 
 #include "game/definitions/musicdefinitions.h"
 #include "dmusic/mixer.h"
+#include "utils/workers.h"
 #include "resources.h"
 
+#include <algorithm>
+#include <optional>
+#include <deque>
+
 using namespace Tempest;
 
 struct GameMusic::MusicProducer : Tempest::SoundProducer {
+  struct Request {
+    zenkit::IMusicTheme theme;
+    Tags                tags   = Tags::Day;
+    bool                reload = false;
+    };
+
+  struct Ready {
+    Dx8::Music          music;
+    float               volume = 1.f;
+    Tags                tags   = Tags::Day;
+    bool                reload = false;
+    bool                stop   = false;
+    };
+
+  static constexpr size_t MaxCached = 8;
+
   MusicProducer():SoundProducer(44100,2){
     }
 
+  ~MusicProducer() {
+    Workers::Task t;
+    {
+      std::lock_guard<std::mutex> guard(loadSync);
+      t = loader;
+    }
+    t.wait();
+    delete ready.exchange(nullptr);
+    }
+
   void renderSound(int16_t* out,size_t n) override {
     updateTheme();
     mix.mix(out,n);
     }
 
+  // audio thread: never loads or locks, only picks up what the loader has published
   void updateTheme() {
-    zenkit::IMusicTheme     theme;
-    bool                    updateTheme = false;
-    bool                    reloadTheme = false;
-    Tags                    tags        = Tags::Day;
-
-    {
-      std::lock_guard<std::mutex> guard(pendingSync);
-      if(hasPending && enable.load()) {
-        hasPending  = false;
-        updateTheme = true;
-        reloadTheme = this->reloadTheme;
-        theme       = pendingMusic;
-        tags        = pendingTags;
-        }
-    }
-
-    if(!updateTheme)
+    std::unique_ptr<Ready> r(ready.exchange(nullptr,std::memory_order_acquire));
+    if(r==nullptr)
       return;
-    updateTheme = false;
 
-    try {
-      if(reloadTheme) {
-        Dx8::PatternList p = Resources::loadDxMusic(theme.file);
-
-        Dx8::Music m;
-        m.addPattern(p);
-
-        const int cur  = currentTags&(Tags::Std|Tags::Fgt|Tags::Thr);
-        const int next = tags&(Tags::Std|Tags::Fgt|Tags::Thr);
-
-        Dx8::DMUS_EMBELLISHT_TYPES em = Dx8::DMUS_EMBELLISHT_END;
-        if(next==Tags::Std) {
-          if(cur!=Tags::Std)
-            em = Dx8::DMUS_EMBELLISHT_BREAK;
-          } else
-        if(next==Tags::Fgt){
-          if(cur==Tags::Thr)
-            em = Dx8::DMUS_EMBELLISHT_FILL;
-          } else
-        if(next==Tags::Thr){
-          if(cur==Tags::Fgt)
-            em = Dx8::DMUS_EMBELLISHT_NORMAL;
-          }
+    if(r->stop || !enable.load()) {
+      mix.setMusic(Dx8::Music());
+      return;
+      }
 
-        mix.setMusic(m,em);
-        currentTags=tags;
+    if(r->reload) {
+      const int cur  = currentTags&(Tags::Std|Tags::Fgt|Tags::Thr);
+      const int next = r->tags&(Tags::Std|Tags::Fgt|Tags::Thr);
+
+      Dx8::DMUS_EMBELLISHT_TYPES em = Dx8::DMUS_EMBELLISHT_END;
+      if(next==Tags::Std) {
+        if(cur!=Tags::Std)
+          em = Dx8::DMUS_EMBELLISHT_BREAK;
+        } else
+      if(next==Tags::Fgt){
+        if(cur==Tags::Thr)
+          em = Dx8::DMUS_EMBELLISHT_FILL;
+        } else
+      if(next==Tags::Thr){
+        if(cur==Tags::Fgt)
+          em = Dx8::DMUS_EMBELLISHT_NORMAL;
         }
-      mix.setMusicVolume(theme.vol);
-      }
-    catch(std::runtime_error&) {
-      Log::e("unable to load sound: \"",theme.file,"\"");
-      stopMusic();
-      }
-    catch(std::bad_alloc&) {
-      Log::e("out of memory for sound: \"",theme.file,"\"");
-      stopMusic();
+
+      mix.setMusic(r->music,em);
+      currentTags = r->tags;
       }
+    mix.setMusicVolume(r->volume);
     }
 
   bool setMusic(const zenkit::IMusicTheme &theme, Tags tags){
-    std::lock_guard<std::mutex> guard(pendingSync);
-    reloadTheme  = pendingMusic.file!=theme.file;
-    pendingMusic = theme;
-    pendingTags  = tags;
-    hasPending   = true;
+    std::lock_guard<std::mutex> guard(loadSync);
+    const bool reload = pendingMusic.file!=theme.file;
+    pendingMusic      = theme;
+    pendingTags       = tags;
+    request.reload    = reload || (hasRequest && request.reload);
+    request.theme     = theme;
+    request.tags      = tags;
+    hasRequest        = true;
+    startLoader();
     return true;
     }
 
+  void prefetch(const zenkit::IMusicTheme &theme) {
+    std::lock_guard<std::mutex> guard(loadSync);
+    if(theme.file.empty() || findCached(theme.file)!=nullptr)
+      return;
+    if(std::find(prefetchQ.begin(),prefetchQ.end(),theme.file)!=prefetchQ.end())
+      return;
+    prefetchQ.push_back(theme.file);
+    startLoader();
+    }
+
   void restartMusic(){
-    std::lock_guard<std::mutex> guard(pendingSync);
-    hasPending  = true;
-    reloadTheme = true;
     enable.store(true);
+    std::lock_guard<std::mutex> guard(loadSync);
+    if(pendingMusic.file.empty())
+      return;
+    request.theme  = pendingMusic;
+    request.tags   = pendingTags;
+    request.reload = true;
+    hasRequest     = true;
+    startLoader();
     }
 
   void stopMusic() {
     enable.store(false);
-    std::lock_guard<std::mutex> guard(pendingSync);
-    mix.setMusic(Dx8::Music());
+    auto r = std::make_unique<Ready>();
+    r->stop = true;
+    publish(std::move(r));
     }
 
   void setVolume(float v) {
@@ -109,15 +135,122 @@ struct GameMusic::MusicProducer : Tempest::SoundProducer {
     return enable.load();
     }
 
+  void startLoader() {
+    if(loaderActive)
+      return;
+    loaderActive = true;
+    loader       = Workers::async([this](){ drainLoader(); });
+    }
+
+  // worker thread: explicit requests go first, prefetch only when idle
+  void drainLoader() {
+    while(true) {
+      Request     rq;
+      std::string pf;
+      {
+        std::lock_guard<std::mutex> guard(loadSync);
+        if(hasRequest) {
+          rq         = std::move(request);
+          request    = Request();
+          hasRequest = false;
+          }
+        else if(!prefetchQ.empty()) {
+          pf = std::move(prefetchQ.front());
+          prefetchQ.pop_front();
+          }
+        else {
+          loaderActive = false;
+          return;
+          }
+      }
+
+      if(!pf.empty()) {
+        load(pf);
+        continue;
+        }
+
+      auto r = std::make_unique<Ready>();
+      r->volume = rq.theme.vol;
+      r->tags   = rq.tags;
+      r->reload = rq.reload;
+      if(rq.reload) {
+        auto m = load(rq.theme.file);
+        if(!m.has_value()) {
+          stopMusic();
+          continue;
+          }
+        r->music = std::move(*m);
+        }
+      publish(std::move(r));
+      }
+    }
+
+  std::optional<Dx8::Music> load(const std::string& file) {
+    {
+      std::lock_guard<std::mutex> guard(loadSync);
+      if(auto m = findCached(file))
+        return *m;
+    }
+
+    try {
+      Dx8::PatternList p = Resources::loadDxMusic(file);
+      Dx8::Music       m;
+      m.addPattern(p);
+
+      std::lock_guard<std::mutex> guard(loadSync);
+      if(cache.size()>=MaxCached)
+        cache.erase(cache.begin());
+      cache.emplace_back(file,m);
+      return m;
+      }
+    catch(std::runtime_error&) {
+      Log::e("unable to load sound: \"",file,"\"");
+      }
+    catch(std::bad_alloc&) {
+      Log::e("out of memory for sound: \"",file,"\"");
+      }
+    return std::nullopt;
+    }
+
+  // LRU: most recently used theme is at the back
+  const Dx8::Music* findCached(const std::string& file) {
+    for(size_t i=0; i<cache.size(); ++i) {
+      if(cache[i].first!=file)
+        continue;
+      std::rotate(cache.begin()+int(i),cache.begin()+int(i+1),cache.end());
+      return &cache.back().second;
+      }
+    return nullptr;
+    }
+
+  void publish(std::unique_ptr<Ready> r) {
+    std::lock_guard<std::mutex> guard(publishSync);
+    std::unique_ptr<Ready> prev(ready.exchange(nullptr,std::memory_order_acquire));
+    if(prev!=nullptr && !(r->reload || r->stop) && (prev->reload || prev->stop)) {
+      // plain volume update must not drop a theme switch the mixer hasn't seen yet
+      prev->volume = r->volume;
+      r = std::move(prev);
+      }
+    ready.store(r.release(),std::memory_order_release);
+    }
+
   Dx8::Mixer           mix;
 
-  std::mutex           pendingSync;
+  std::atomic<Ready*>  ready{nullptr};
+  std::mutex           publishSync;
   std::atomic_bool     enable{true};
-  bool                 hasPending=false;
-  bool                 reloadTheme=false;
+  Tags                 currentTags=Tags::Day;
+
+  std::mutex           loadSync;
+  Workers::Task        loader;
+  bool                 loaderActive=false;
+  bool                 hasRequest=false;
+  Request              request;
   zenkit::IMusicTheme  pendingMusic;
   Tags                 pendingTags=Tags::Day;
-  Tags                 currentTags=Tags::Day;
+
+  std::deque<std::string>                          prefetchQ;
+  std::vector<std::pair<std::string,Dx8::Music>>   cache;
   };
 
 struct GameMusic::Impl final {
@@ -134,6 +267,10 @@ struct GameMusic::Impl final {
     dxMixer->setMusic(theme,tags);
     }
 
+  void prefetch(const zenkit::IMusicTheme &theme) {
+    dxMixer->prefetch(theme);
+    }
+
   void setVolume(float v) {
     dxMixer->setVolume(v);
     }
@@ -204,6 +341,10 @@ void GameMusic::setMusic(const zenkit::IMusicTheme& theme, Tags tags) {
   impl->setMusic(theme,tags);
   }
 
+void GameMusic::prefetch(const zenkit::IMusicTheme& theme) {
+  impl->prefetch(theme);
+  }
+
 void GameMusic::stopMusic() {
   setEnabled(false);
   }
@@ -31,6 +31,8 @@ class GameMusic final {
     bool      isEnabled() const;
     void      setMusic(Music m);
     void      setMusic(const zenkit::IMusicTheme &theme, Tags t);
+    // loads theme in background, so a later setMusic doesn't wait for it
+    void      prefetch(const zenkit::IMusicTheme &theme);
     void      stopMusic();
 
   private:
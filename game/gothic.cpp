@@ -1,10 +1,13 @@
 #include "gothic.h"
 
+#include <Tempest/Application>
+#include <Tempest/File>
 #include <Tempest/Log>
 #include <Tempest/TextCodec>
 
 #include <cstring>
 #include <cctype>
+#include <filesystem>
 
 #include <zenkit/addon/daedalus.hh>
 
@@ -16,6 +19,7 @@
 #include "game/definitions/particlesdefinitions.h"
 
 #include "world/objects/npc.h"
+#include "game/serialize.h"
 
 #include "utils/fileutil.h"
 #include "utils/inifile.h"
@@ -216,6 +220,7 @@ Gothic::Gothic() {
   }
 
 Gothic::~Gothic() {
+  waitSnapshotSave();
   instance = nullptr;
   }
 
@@ -443,51 +448,91 @@ Gothic::LoadState Gothic::checkLoading() const {
 
 bool Gothic::finishLoading() {
   auto state = checkLoading();
-  if(state!=LoadState::Finalize && state!=LoadState::FailedLoad && state!=LoadState::FailedSave)
+  if(state!=LoadState::Finalize && state!=LoadState::FailedLoad)
     return false;
   if(loadingFlag.compare_exchange_strong(state,LoadState::Idle)){
     loaderTh.join();
     if(pendingGame!=nullptr)
       game = std::move(pendingGame);
-    saveTex = Texture2d();
     onWorldLoaded();
     return true;
     }
   return false;
   }
 
-void Gothic::startSave(Tempest::Texture2d&& tex,
-                       const std::function<std::unique_ptr<GameSession>(std::unique_ptr<GameSession>&&)> f) {
-  saveTex = std::move(tex);
-  implStartLoadSave("",false,f);
+bool Gothic::startSnapshotSave(std::string_view slot, std::string_view name, const Tempest::Pixmap& screen) {
+  if(game==nullptr || loadingFlag.load()!=LoadState::Idle)
+    return false;
+  waitSnapshotSave();
+
+  const uint64_t time0 = Application::tickCount();
+  auto snap = std::make_shared<Serialize::Snapshot>();
+  try {
+    Serialize s(*snap);
+    game->save(s,name,screen);
+    }
+  catch(std::exception& e) {
+    Log::e("saving error: ",e.what());
+    onPrint("unable to write savegame file");
+    return false;
+    }
+  Log::i("save snapshot: ",Application::tickCount()-time0,"ms, ",snap->byteSize()/1024,"kb");
+
+  try {
+    saverTh = std::thread([this,snap,file=std::string(slot)]() noexcept {
+      Workers::setThreadName("Saving thread");
+      // write to temporary file first: previous save in this slot must survive a failed write
+      const std::string tmp = file+".tmp";
+      std::error_code   ec;
+      try {
+        {
+        Tempest::WFile fout(tmp);
+        Serialize::writeSnapshot(fout,std::move(*snap));
+        }
+        std::filesystem::rename(tmp,file,ec);
+        if(ec)
+          throw std::system_error(ec);
+        }
+      catch(const std::exception& e) {
+        Log::e("saving error: ",e.what());
+        std::filesystem::remove(tmp,ec);
+        saveFailed.store(true);
+        }
+      });
+    }
+  catch(...) {
+    return false;
+    }
+  return true;
   }
 
-void Gothic::startLoad(std::string_view banner,
-                       const std::function<std::unique_ptr<GameSession>(std::unique_ptr<GameSession>&&)> f) {
-  implStartLoadSave(banner,true,f);
+void Gothic::waitSnapshotSave() {
+  if(saverTh.joinable())
+    saverTh.join();
   }
 
-void Gothic::implStartLoadSave(std::string_view banner,
-                               bool load,
-                               const std::function<std::unique_ptr<GameSession>(std::unique_ptr<GameSession>&&)> f) {
-  loadTex = banner.empty() ? &saveTex : Resources::loadTexture(banner);
+void Gothic::startLoad(std::string_view banner,
+                       const std::function<std::unique_ptr<GameSession>(std::unique_ptr<GameSession>&&)> f) {
+  loadTex = Resources::loadTexture(banner);
   loadProgress.store(0);
 
   auto zero=LoadState::Idle;
-  auto one =load ? LoadState::Loading : LoadState::Saving;
-  if(!loadingFlag.compare_exchange_strong(zero,one)){
+  if(!loadingFlag.compare_exchange_strong(zero,LoadState::Loading)){
     return; // loading already
     }
 
+  // savegame may be still in flight
+  waitSnapshotSave();
+
   onStartLoading();
   auto g = clearGame().release();
   try{
-    auto l = std::thread([this,f,g,one]() noexcept {
+    auto l = std::thread([this,f,g]() noexcept {
       Workers::setThreadName("Loading thread");
       std::unique_ptr<GameSession> game(g);
       std::unique_ptr<GameSession> next;
-      auto curState = one;
-      auto err = (curState==LoadState::Loading) ? LoadState::FailedLoad : LoadState::FailedSave;
+      auto curState = LoadState::Loading;
+      auto err      = LoadState::FailedLoad;
       try {
         next        = f(std::move(game));
         pendingGame = std::move(next);
@@ -513,10 +558,6 @@ void Gothic::implStartLoadSave(std::string_view banner,
         Tempest::Log::e("loading error: ", e.what());
         loadingFlag.compare_exchange_strong(curState,err);
         }
-      if(curState==LoadState::Saving) {
-        if(game!=nullptr)
-          pendingGame = std::move(game);
-        }
       });
     loaderTh=std::move(l);
     //loaderTh.join();
@@ -535,6 +576,9 @@ void Gothic::cancelLoading() {
   }
 
 void Gothic::tick(uint64_t dt) {
+  if(saveFailed.exchange(false))
+    onPrint("unable to write savegame file");
+
   if(pendingChapter){
     if(aiIsDlgFinished()) {
       onIntroChapter(chapter);
@@ -35,10 +35,8 @@ class Gothic final {
     enum class LoadState:int {
       Idle       = 0,
       Loading    = 1,
-      Saving     = 2,
-      Finalize   = 3,
-      FailedLoad = 4,
-      FailedSave = 5
+      Finalize   = 2,
+      FailedLoad = 3,
       };
 
     struct Options {
@@ -129,7 +127,10 @@ class Gothic final {
     LoadState    checkLoading() const;
     bool         finishLoading();
     void         startLoad(std::string_view banner, const std::function<std::unique_ptr<GameSession>(std::unique_ptr<GameSession>&&)> f);
-    void         startSave(Tempest::Texture2d&& tex, const std::function<std::unique_ptr<GameSession>(std::unique_ptr<GameSession>&&)> f);
+    // snapshot of current game is taken right away; game keeps running, while file is written in background
+    bool         startSnapshotSave(std::string_view slot, std::string_view name, const Tempest::Pixmap& screen);
+    // blocks until background save, if any, is written to disk
+    void         waitSnapshotSave();
     void         cancelLoading();
 
     void         tick(uint64_t dt);
@@ -207,10 +208,11 @@ class Gothic final {
     std::unique_ptr<IniFile>                systemPackIniFile;
 
     const Tempest::Texture2d*               loadTex=nullptr;
-    Tempest::Texture2d                      saveTex;
     std::atomic_int                         loadProgress{0};
     std::thread                             loaderTh;
     std::atomic<LoadState>                  loadingFlag{LoadState::Idle};
+    std::thread                             saverTh;
+    std::atomic_bool                        saveFailed{false};
 
     std::unique_ptr<GameSession>            game, pendingGame;
     std::unique_ptr<FightAi>                fight;
@@ -234,10 +236,6 @@ class Gothic final {
 
     static Gothic*                          instance;
 
-    void                                    implStartLoadSave(std::string_view banner,
-                                                              bool load,
-                                                              const std::function<std::unique_ptr<GameSession>(std::unique_ptr<GameSession>&&)> f);
-
     void                                    detectGothicVersion();
     void                                    setupSettings();
 
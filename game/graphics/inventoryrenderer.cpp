@@ -56,11 +56,16 @@ void InventoryRenderer::reset(bool full) {
   if(!full)
     prevItems = std::move(items);
   items.clear();
+  pending = false;
   }
 
 void InventoryRenderer::drawItem(int x, int y, int w, int h, const ::Item& item) {
   auto& itData = item.handle();
-  if(auto mesh=Resources::loadMesh(itData.visual)) {
+  // trade and chest pages can show dozens of new meshes at once: draw empty slot, until mesh is decoded
+  auto  async  = Resources::loadMeshAsync(itData.visual,Resources::Priority::High);
+  if(!async.isReady())
+    pending = true;
+  if(auto mesh=async.get(nullptr)) {
     float    sz  = (mesh->bbox[1]-mesh->bbox[0]).length();
     auto     mv  = (mesh->bbox[1]+mesh->bbox[0])*0.5f;
     ItmFlags flg = ItmFlags(item.mainFlag());
@@ -17,6 +17,8 @@ class InventoryRenderer {
 
     void reset(bool full=false);
     void drawItem(int x, int y, int w, int h, const Item &item);
+    // some of item meshes, from last draw, are still loading
+    bool hasPending() const { return pending; }
 
   private:
     struct PerFrame {
@@ -33,6 +35,7 @@ class InventoryRenderer {
     MeshObjects            itmGroup;
     std::vector<Itm>       items;
     std::vector<Itm>       prevItems; // reseve previous to avoid bucket reallocation
+    bool                   pending = false;
 
     const Tempest::RenderPipeline* pInventory = nullptr;
 
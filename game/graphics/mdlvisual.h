@@ -74,7 +74,7 @@ class MdlVisual final {
     bool                           isUsingTorch() const;
 
     const Pose&                    pose() const { return *skInst; }
-    bool                           updateAnimation(Npc* npc, World& world, uint64_t dt);
+    bool                           updateAnimation(Npc* npc, World& world, uint64_t dt, bool sample = true, size_t maxLayers = size_t(-1));
     void                           processLayers  (World& world);
     bool                           processEvents(World& world, uint64_t &barrier, Animation::EvCount &ev);
     auto                           mapBone(const size_t boneId) const -> Tempest::Vec3;
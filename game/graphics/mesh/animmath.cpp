@@ -18,6 +18,35 @@ zenkit::AnimationSample mix(const zenkit::AnimationSample& x, const zenkit::Anim
   return r;
 }
 
+void mix(zenkit::AnimationSample* out, const zenkit::AnimationSample* x, const zenkit::AnimationSample* y,
+         size_t count, float a) {
+  // no branches in loop body, so compiler is free to vectorize it
+  const float b = 1.f-a;
+  for(size_t i=0; i<count; ++i) {
+    auto& qx  = x[i].rotation;
+    auto& qy  = y[i].rotation;
+    float dot = qx.x*qy.x + qx.y*qy.y + qx.z*qy.z + qx.w*qy.w;
+    float ay  = std::copysign(a,dot);
+
+    float rx  = qx.x*b + qy.x*ay;
+    float ry  = qx.y*b + qy.y*ay;
+    float rz  = qx.z*b + qy.z*ay;
+    float rw  = qx.w*b + qy.w*ay;
+    float len = std::sqrt(rx*rx + ry*ry + rz*rz + rw*rw);
+    float inv = len>0.f ? 1.f/len : 0.f;
+
+    auto& r = out[i];
+    r.rotation.x = rx*inv;
+    r.rotation.y = ry*inv;
+    r.rotation.z = rz*inv;
+    r.rotation.w = rw*inv;
+
+    r.position.x = x[i].position.x*b + y[i].position.x*a;
+    r.position.y = x[i].position.y*b + y[i].position.y*a;
+    r.position.z = x[i].position.z*b + y[i].position.z*a;
+    }
+  }
+
 static Tempest::Matrix4x4 mkMatrix(float x,float y,float z,float w,
                                    float px,float py,float pz) {
   float m[4][4]={};
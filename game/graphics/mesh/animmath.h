@@ -6,4 +6,7 @@
 #include <zenkit/ModelAnimation.hh>
 
 zenkit::AnimationSample mix(const zenkit::AnimationSample& x, const zenkit::AnimationSample& y, float a);
+// batched key-frame interpolation: nlerp over the shortest arc, for close samples only
+void                    mix(zenkit::AnimationSample* out, const zenkit::AnimationSample* x, const zenkit::AnimationSample* y,
+                            size_t count, float a);
 Tempest::Matrix4x4      mkMatrix(const zenkit::AnimationSample& s);
@@ -309,7 +309,7 @@ void Pose::processLayers(AnimationSolver& solver, uint64_t tickCount) {
     }
   }
 
-bool Pose::update(uint64_t tickCount) {
+bool Pose::update(uint64_t tickCount, bool sample, size_t maxLayers) {
   if(lay.size()==0) {
     const bool ret = needToUpdate;
     if(needToUpdate || lastUpdate==0)
@@ -319,8 +319,11 @@ bool Pose::update(uint64_t tickCount) {
     return ret;
     }
 
-  if(lastUpdate!=tickCount) {
-    for(auto& i:lay) {
+  if(lastUpdate!=tickCount && sample) {
+    // layers are sorted by layer index: keep base locomotion, freeze overlays (torch, gestures) first
+    const size_t count = std::min(lay.size(),maxLayers);
+    for(size_t id=0; id<count; ++id) {
+      auto&                      i   = lay[id];
       const Animation::Sequence* seq = i.seq;
       if(0<i.comb && i.comb<=i.seq->comb.size()) {
         if(auto sx = i.seq->comb[size_t(i.comb-1)])
@@ -378,11 +381,18 @@ bool Pose::updateFrame(const Animation::Sequence &s, BodyState bs, uint64_t sBle
   const uint64_t blendMax = std::max(s.blendOut,s.blendIn);
   const uint64_t blend    = std::max<uint64_t>(0, now-sBlend);
 
+  // key-frames are interpolated in fixed-size batches
+  const size_t            batch = Resources::MAX_NUM_SKELETAL_NODES;
+  zenkit::AnimationSample keys[batch];
   for(size_t i=0; i<idSize; ++i) {
+    const size_t k = i%batch;
+    if(k==0)
+      mix(keys, sampleA+i, sampleB+i, std::min(idSize-i, batch), a);
+
     size_t idx = d.nodeIndex[i];
     if(idx>=numBones)
       continue;
-    auto smp = mix(sampleA[i],sampleB[i],a);
+    auto smp = keys[k];
     if(i==0) {
       if(bs==BS_CLIMB)
         smp.position.y = trY;
@@ -419,9 +429,7 @@ void Pose::mkSkeleton(const Tempest::Matrix4x4& mt) {
     return;
   Matrix4x4 m = mt;
   m.translate(mkBaseTranslation());
-  if(skeleton->ordered)
-    implMkSkeleton(m); else
-    implMkSkeleton(m,size_t(-1));
+  implMkSkeleton(m);
   }
 
 void Pose::implMkSkeleton(const Matrix4x4 &mt) {
@@ -429,7 +437,7 @@ void Pose::implMkSkeleton(const Matrix4x4 &mt) {
     return;
   auto& nodes      = skeleton->nodes;
   auto  BIP01_HEAD = skeleton->BIP01_HEAD;
-  for(size_t i=0; i<nodes.size(); ++i) {
+  for(size_t i:skeleton->order) {
     size_t parent = nodes[i].parent;
     auto   mat    = hasSamples[i] ? mkMatrix(base[i]) : nodes[i].tr;
 
@@ -445,19 +453,6 @@ void Pose::implMkSkeleton(const Matrix4x4 &mt) {
     }
   }
 
-void Pose::implMkSkeleton(const Tempest::Matrix4x4 &mt, size_t parent) {
-  if(skeleton==nullptr)
-    return;
-  auto& nodes = skeleton->nodes;
-  for(size_t i=0;i<nodes.size();++i){
-    if(nodes[i].parent!=parent)
-      continue;
-    auto mat = hasSamples[i] ? mkMatrix(base[i]) : nodes[i].tr;
-    tr[i] = mt*mat;
-    implMkSkeleton(tr[i],i);
-    }
-  }
-
 const Animation::Sequence* Pose::solveNext(const AnimationSolver &solver, const Layer& lay) {
   auto sq = lay.seq;
 
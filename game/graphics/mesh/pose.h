@@ -48,7 +48,8 @@ class Pose final {
     void               stopAllAnim();
 
     void               setObjectMatrix(const Tempest::Matrix4x4& obj, bool sync);
-    bool               update(uint64_t tickCount);
+    // sample==false: keep local pose from last update, only re-apply object matrix
+    bool               update(uint64_t tickCount, bool sample = true, size_t maxLayers = size_t(-1));
 
     void               processLayers(AnimationSolver &solver, uint64_t tickCount);
     bool               processEvents(uint64_t& barrier, uint64_t now, Animation::EvCount &ev) const;
@@ -116,7 +117,6 @@ class Pose final {
     auto mkBaseTranslation() -> Tempest::Vec3;
     void mkSkeleton(const Tempest::Matrix4x4 &mt);
     void implMkSkeleton(const Tempest::Matrix4x4 &mt);
-    void implMkSkeleton(const Tempest::Matrix4x4 &mt, size_t parent);
 
     bool updateFrame(const Animation::Sequence &s, BodyState bs, uint64_t sBlend, uint64_t barrier, uint64_t sTime, uint64_t now);
 
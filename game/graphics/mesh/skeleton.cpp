@@ -46,6 +46,7 @@ Skeleton::Skeleton(const zenkit::ModelHierarchy& src, const Animation* anim, std
       i.tr.translate(rootTr);
       }
   BIP01_HEAD = findNode("BIP01 HEAD");
+  mkOrder();
   mkSkeleton();
   }
 
@@ -86,18 +87,31 @@ float Skeleton::colisionHeight() const {
   return std::fabs(bboxCol[1].y-bboxCol[0].y);
   }
 
-void Skeleton::mkSkeleton() {
-  Matrix4x4 m;
-  m.identity();
-  mkSkeleton(m,size_t(-1));
+void Skeleton::mkOrder() {
+  order.clear();
+  order.reserve(nodes.size());
+  if(ordered) {
+    for(size_t i=0; i<nodes.size(); ++i)
+      order.push_back(uint16_t(i));
+    return;
+    }
+
+  // breadth-first from roots; nodes with broken parent links are not reachable
+  for(auto i:rootNodes)
+    order.push_back(uint16_t(i));
+  for(size_t r=0; r<order.size(); ++r) {
+    for(size_t i=0; i<nodes.size(); ++i)
+      if(nodes[i].parent==order[r])
+        order.push_back(uint16_t(i));
+    }
   }
 
-void Skeleton::mkSkeleton(const Tempest::Matrix4x4 &mt, size_t parent) {
-  for(size_t i=0; i<nodes.size(); ++i){
-    if(nodes[i].parent!=parent)
-      continue;
-    tr[i] = mt;
+void Skeleton::mkSkeleton() {
+  for(auto i:order) {
+    const size_t parent = nodes[i].parent;
+    if(parent<nodes.size())
+      tr[i] = tr[parent]; else
+      tr[i].identity();
     tr[i].mul(nodes[i].tr);
-    mkSkeleton(tr[i],i);
     }
   }
@@ -5,6 +5,7 @@
 #include <zenkit/ModelHierarchy.hh>
 
 #include <vector>
+#include <cstdint>
 
 #include "animation.h"
 
@@ -20,6 +21,7 @@ class Skeleton final {
 
     bool                            ordered=true;
     std::vector<Node>               nodes;
+    std::vector<uint16_t>           order; // nodes in parent-before-child order
     std::vector<size_t>             rootNodes;
     std::vector<Tempest::Matrix4x4> tr;
     Tempest::Vec3                   rootTr={};
@@ -44,6 +46,6 @@ class Skeleton final {
     std::string      fileName;
     const Animation* anim=nullptr;
 
+    void mkOrder();
     void mkSkeleton();
-    void mkSkeleton(const Tempest::Matrix4x4& mt,size_t parent);
   };
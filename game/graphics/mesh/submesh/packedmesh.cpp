@@ -3,9 +3,11 @@
 #include <Tempest/Application>
 #include <Tempest/Log>
 #include <fstream>
+#include <cstring>
 #include <algorithm>
 
 #include "game/compatibility/phoenix.h"
+#include "world/landcache.h"
 #include "gothic.h"
 
 using namespace Tempest;
@@ -14,6 +16,49 @@ static uint64_t mkUInt64(uint32_t a, uint32_t b) {
   return (uint64_t(a)<<32) | uint64_t(b);
   };
 
+static void writeRaw(std::vector<uint8_t>& out, const void* data, size_t size) {
+  const size_t at = out.size();
+  // keep every block 16-byte aligned
+  out.resize(at + ((size+15) & ~size_t(15)));
+  if(size>0)
+    std::memcpy(out.data()+at,data,size);
+  }
+
+template<class T>
+static void writeVec(std::vector<uint8_t>& out, const std::vector<T>& v) {
+  const uint64_t size = v.size();
+  writeRaw(out,&size,sizeof(size));
+  writeRaw(out,v.data(),v.size()*sizeof(T));
+  }
+
+static bool readRaw(const std::vector<uint8_t>& in, size_t& at, void* data, size_t size) {
+  const size_t sz = (size+15) & ~size_t(15);
+  if(at+sz>in.size())
+    return false;
+  if(size>0)
+    std::memcpy(data,in.data()+at,size);
+  at += sz;
+  return true;
+  }
+
+template<class T>
+static bool readVec(const std::vector<uint8_t>& in, size_t& at, std::vector<T>& v) {
+  uint64_t size = 0;
+  if(!readRaw(in,at,&size,sizeof(size)))
+    return false;
+  if(size>(in.size()-at)/sizeof(T))
+    return false;
+  v.resize(size_t(size));
+  return readRaw(in,at,v.data(),v.size()*sizeof(T));
+  }
+
+struct CachedSubMesh {
+  uint64_t iboOffset  = 0;
+  uint64_t iboLength  = 0;
+  uint32_t materialId = 0;
+  uint32_t group      = 0;
+  };
+
 static bool isVisuallySame(const zenkit::Material& a, const zenkit::Material& b) {
   return
           // a.name                         == b.name && // mat name
@@ -403,6 +448,19 @@ PackedMesh::PackedMesh(const zenkit::Mesh& mesh, PkgType type) {
     }
   }
 
+PackedMesh::PackedMesh(const zenkit::Mesh& mesh, PkgType type, const LandCache& cache) {
+  const auto kind = (type==PK_Physic) ? LandCache::K_PhysicMesh : LandCache::K_VisualMesh;
+
+  std::vector<uint8_t> blob;
+  if(cache.load(kind,blob) && implLoad(mesh,type,blob))
+    return;
+
+  *this = PackedMesh(mesh,type);
+  blob.clear();
+  implSave(blob);
+  cache.save(kind,blob.data(),blob.size());
+  }
+
 PackedMesh::PackedMesh(const zenkit::MultiResolutionMesh& mesh, PkgType type) {
   subMeshes.resize(mesh.sub_meshes.size());
   isUsingAlphaTest = mesh.alpha_test;
@@ -487,6 +545,7 @@ void PackedMesh::packPhysics(const zenkit::Mesh& mesh, PkgType type) {
       auto& m = mat[mId-size_t(zenkit::MaterialGroup::NONE)];
       sub.material.name  = m.name;
       sub.material.group = m.group;
+      sub.materialId     = uint32_t(mId-size_t(zenkit::MaterialGroup::NONE));
       }
 
     for(; i<prim.size() && prim[i].mat==mId; ++i) {
@@ -580,7 +639,8 @@ void PackedMesh::packMeshletsLnd(const zenkit::Mesh& mesh) {
       meshlets[i].updateBounds(mesh);
 
     SubMesh pack;
-    pack.material  = mesh.materials[mId];
+    pack.material   = mesh.materials[mId];
+    pack.materialId = mId;
     pack.iboOffset = indices.size();
     for(auto& i:meshlets)
       i.flush(vertices,indices,indices8,meshletBounds,mesh);
@@ -765,6 +825,66 @@ void PackedMesh::computeBbox() {
     }
   }
 
+void PackedMesh::implSave(std::vector<uint8_t>& out) const {
+  std::vector<CachedSubMesh> sub(subMeshes.size());
+  for(size_t i=0; i<subMeshes.size(); ++i) {
+    sub[i].iboOffset  = subMeshes[i].iboOffset;
+    sub[i].iboLength  = subMeshes[i].iboLength;
+    sub[i].materialId = subMeshes[i].materialId;
+    sub[i].group      = uint32_t(subMeshes[i].material.group);
+    }
+
+  const uint32_t alphaTest = isUsingAlphaTest ? 1 : 0;
+  writeRaw(out,&alphaTest,sizeof(alphaTest));
+  writeRaw(out,mBbox,sizeof(mBbox));
+  writeVec(out,vertices);
+  writeVec(out,indices);
+  writeVec(out,indices8);
+  writeVec(out,meshletBounds);
+  writeVec(out,sub);
+  }
+
+bool PackedMesh::implLoad(const zenkit::Mesh& mesh, PkgType type, const std::vector<uint8_t>& in) {
+  std::vector<CachedSubMesh> sub;
+  uint32_t         alphaTest = 0;
+  size_t           at        = 0;
+
+  if(!readRaw(in,at,&alphaTest,sizeof(alphaTest)) ||
+     !readRaw(in,at,mBbox,sizeof(mBbox)) ||
+     !readVec(in,at,vertices) ||
+     !readVec(in,at,indices) ||
+     !readVec(in,at,indices8) ||
+     !readVec(in,at,meshletBounds) ||
+     !readVec(in,at,sub))
+    return false;
+
+  isUsingAlphaTest = (alphaTest!=0);
+  subMeshes.resize(sub.size());
+  for(size_t i=0; i<sub.size(); ++i) {
+    auto& s = subMeshes[i];
+    if(sub[i].iboOffset+sub[i].iboLength>indices.size())
+      return false;
+    s.iboOffset  = size_t(sub[i].iboOffset);
+    s.iboLength  = size_t(sub[i].iboLength);
+    s.materialId = sub[i].materialId;
+    if(s.materialId==uint32_t(-1)) {
+      s.material.name  = "";
+      s.material.group = zenkit::MaterialGroup(sub[i].group);
+      continue;
+      }
+    if(s.materialId>=mesh.materials.size())
+      return false;
+    auto& m = mesh.materials[s.materialId];
+    if(type==PK_Physic) {
+      s.material.name  = m.name;
+      s.material.group = m.group;
+      } else {
+      s.material = m;
+      }
+    }
+  return true;
+  }
+
 void PackedMesh::dbgUtilization(const std::vector<Meshlet>& meshlets) {
   size_t usedV = 0, allocatedV = 0;
   size_t usedP = 0, allocatedP = 0;
@@ -11,6 +11,7 @@
 #include "resources.h"
 
 class Bounds;
+class LandCache;
 
 class PackedMesh {
   public:
@@ -24,6 +25,9 @@ class PackedMesh {
       MaxMeshlets = 16,
       };
 
+    // bump, when output of packing code changes: on-disk landscape cache is keyed by it
+    static constexpr uint32_t CacheFormat = 1;
+
     enum PkgType {
       PK_Visual,
       PK_VisualLnd,
@@ -33,8 +37,9 @@ class PackedMesh {
 
     struct SubMesh final {
       zenkit::Material material;
-      size_t           iboOffset = 0;
-      size_t           iboLength = 0;
+      size_t           iboOffset  = 0;
+      size_t           iboLength  = 0;
+      uint32_t         materialId = uint32_t(-1); // index of source material; landscape only
       };
 
     struct Cluster final {
@@ -55,6 +60,7 @@ class PackedMesh {
 
     PackedMesh(const zenkit::MultiResolutionMesh& mesh, PkgType type);
     PackedMesh(const zenkit::Mesh& mesh, PkgType type);
+    PackedMesh(const zenkit::Mesh& mesh, PkgType type, const LandCache& cache);
     PackedMesh(const zenkit::SoftSkinMesh& mesh);
 
     void debug(std::ostream &out) const;
@@ -118,6 +124,9 @@ class PackedMesh {
 
     void   computeBbox();
 
+    void   implSave(std::vector<uint8_t>& out) const;
+    bool   implLoad(const zenkit::Mesh& mesh, PkgType type, const std::vector<uint8_t>& in);
+
     void   dbgUtilization(const std::vector<Meshlet>& meshlets);
     void   dbgMeshlets(const zenkit::Mesh& mesh, const std::vector<Meshlet*>& meshlets);
   };
@@ -242,9 +242,9 @@ bool ObjVisual::isAnimExist(std::string_view name) const {
   return false;
   }
 
-bool ObjVisual::updateAnimation(Npc* npc, World& world, uint64_t dt) {
+bool ObjVisual::updateAnimation(Npc* npc, World& world, uint64_t dt, bool sample) {
   if(type==M_Mdl) {
-    bool ret = mdl.view.updateAnimation(npc,world,dt);
+    bool ret = mdl.view.updateAnimation(npc,world,dt,sample);
     if(ret)
       mdl.view.syncAttaches();
     return ret;
@@ -7,6 +7,9 @@
 
 #include "world/objects/npc.h"
 
+#include <algorithm>
+#include <atomic>
+
 using namespace Tempest;
 
 static uint64_t ppsDiff(const ParticleFx& decl, bool loop, uint64_t time0, uint64_t time1) {
@@ -24,11 +27,35 @@ static uint64_t ppsDiff(const ParticleFx& decl, bool loop, uint64_t time0, uint6
   return emitted1-emitted0;
   }
 
-float PfxBucket::ParState::lifeTime() const {
-  return 1.f-life/float(maxLife);
+void PfxBucket::Particles::resize(size_t sz) {
+  life   .resize(sz);
+  maxLife.resize(sz,1);
+  posX   .resize(sz);
+  posY   .resize(sz);
+  posZ   .resize(sz);
+  dirX   .resize(sz);
+  dirY   .resize(sz);
+  dirZ   .resize(sz);
+  }
+
+void PfxBucket::Particles::set(size_t i, const ParState& ps) {
+  life   [i] = ps.life;
+  maxLife[i] = ps.maxLife;
+  posX   [i] = ps.pos.x;
+  posY   [i] = ps.pos.y;
+  posZ   [i] = ps.pos.z;
+  dirX   [i] = ps.dir.x;
+  dirY   [i] = ps.dir.y;
+  dirZ   [i] = ps.dir.z;
   }
 
-std::mt19937 PfxBucket::rndEngine;
+void PfxBucket::Particles::clear(size_t i) {
+  set(i,ParState());
+  }
+
+float PfxBucket::Particles::lifeTime(size_t i) const {
+  return 1.f-life[i]/float(maxLife[i]);
+  }
 
 void PfxBucket::Draw::setPfxData(const Tempest::StorageBuffer& ssbo) {
   if(ssbo.isEmpty())
@@ -117,8 +144,12 @@ PfxBucket::PfxBucket(const ParticleFx &decl, PfxObjects& parent, const SceneGlob
     item.prepareUniforms(scene, decl.visMaterial);
     }
 
+  static std::atomic<uint32_t> seed{0};
+  rndEngine.seed(seed.fetch_add(1,std::memory_order_relaxed));
+
   if(decl.hasTrails()) {
-    maxTrlTime = uint64_t(decl.trlFadeSpeed*1000.f);
+    maxTrlTime  = uint64_t(decl.trlFadeSpeed*1000.f);
+    trlCapacity = size_t(std::clamp<uint64_t>(maxTrlTime/TrailMinStep+2,2,TrailMaxCapacity));
 
     Material mat = decl.visMaterial;
     mat.tex = decl.trlTexture;
@@ -175,14 +206,24 @@ size_t PfxBucket::allocBlock() {
   b.offset    = particles.size();
   b.timeTotal = 0;
 
-  particles.resize(particles.size()+blockSize);
-  pfxCpu   .resize(particles.size());
-
-  for(size_t i=0; i<blockSize; ++i)
-    particles[b.offset+i].life = 0;
+  resize(particles.size()+blockSize);
   return block.size()-1;
   }
 
+void PfxBucket::resize(size_t count) {
+  const size_t prev = particles.size();
+  particles.resize(count);
+  pfxCpu   .resize(count);
+  for(size_t i=prev; i<count; ++i)
+    particles.clear(i);
+  if(maxTrlTime!=0) {
+    trlRing  .resize(count);
+    trlPoints.resize(count*trlCapacity);
+    for(size_t i=prev; i<count; ++i)
+      trlRing[i] = TrailRing();
+    }
+  }
+
 void PfxBucket::freeBlock(size_t& i) {
   if(i==size_t(-1))
     return;
@@ -257,8 +298,7 @@ bool PfxBucket::shrink() {
     block.pop_back();
     }
   if(particles.size()!=block.size()*blockSize) {
-    particles.resize(block.size()*blockSize);
-    pfxCpu   .resize(particles.size());
+    resize(block.size()*blockSize);
     return true;
     }
   return false;
@@ -273,7 +313,7 @@ float PfxBucket::randf(float base, float var) {
   }
 
 void PfxBucket::init(PfxBucket::Block& block, ImplEmitter& emitter, size_t particle) {
-  auto& p   = particles[particle];
+  ParState p;
 
   p.life    = uint16_t(randf(decl.lspPartAvg,decl.lspPartVar));
   p.maxLife = p.life;
@@ -436,69 +476,99 @@ void PfxBucket::init(PfxBucket::Block& block, ImplEmitter& emitter, size_t parti
     float velocity = randf(decl.velAvg,decl.velVar);
     p.dir = p.dir*velocity/l;
     }
+
+  particles.set(particle,p);
+  if(maxTrlTime!=0)
+    trlRing[particle] = TrailRing();
   }
 
 void PfxBucket::finalize(size_t particle) {
-  particles[particle] = {};
-  pfxCpu   [particle] = {};
+  particles.clear(particle);
+  pfxCpu[particle] = {};
+  if(maxTrlTime!=0)
+    trlRing[particle] = TrailRing();
   }
 
-void PfxBucket::tick(Block& sys, ImplEmitter& emitter, size_t particle, uint64_t dt) {
-  ParState& ps = particles[particle+sys.offset];
-  if(ps.life==0)
-    return;
+void PfxBucket::tick(Block& sys, ImplEmitter& emitter, uint64_t dt) {
+  const size_t begin = sys.offset;
+  const size_t end   = sys.offset+blockSize;
+  uint16_t*    life  = particles.life.data();
 
-  if(ps.life<=dt){
-    ps.life = 0;
-    sys.count--;
-    finalize(particle+sys.offset);
-    return;
+  for(size_t i=begin; i<end; ++i) {
+    if(life[i]==0)
+      continue;
+    if(life[i]<=dt) {
+      sys.count--;
+      finalize(i);
+      continue;
+      }
+    life[i] = uint16_t(life[i]-dt);
     }
 
-  const float dtF = float(dt);
+  integrate(begin,end,float(dt));
+
+  if(maxTrlTime!=0) {
+    for(size_t i=begin; i<end; ++i)
+      if(life[i]!=0)
+        tickTrail(emitter,i);
+    }
+  }
 
-  // eval particle
-  ps.life  = uint16_t(ps.life-dt);
-  ps.pos  += ps.dir*dtF;
-  ps.dir  += decl.flyGravity*dtF;
+void PfxBucket::integrate(size_t begin, size_t end, float dtF) {
+  // branch-free loop over SoA streams, so compiler can vectorize it; dead particles are masked out
+  const uint16_t* life = particles.life.data();
+  float* posX = particles.posX.data();
+  float* posY = particles.posY.data();
+  float* posZ = particles.posZ.data();
+  float* dirX = particles.dirX.data();
+  float* dirY = particles.dirY.data();
+  float* dirZ = particles.dirZ.data();
 
-  if(maxTrlTime!=0)
-    tickTrail(ps,emitter,dt);
+  const Vec3 g = decl.flyGravity*dtF;
+  for(size_t i=begin; i<end; ++i) {
+    const float m = (life[i]!=0) ? 1.f : 0.f;
+    const float k = dtF*m;
+    posX[i] += dirX[i]*k;
+    posY[i] += dirY[i]*k;
+    posZ[i] += dirZ[i]*k;
+    dirX[i] += g.x*m;
+    dirY[i] += g.y*m;
+    dirZ[i] += g.z*m;
+    }
   }
 
-void PfxBucket::tickTrail(ParState& ps, ImplEmitter& emitter, uint64_t dt) {
-  for(auto& i:ps.trail)
-    i.time+=dt;
+void PfxBucket::tickTrail(ImplEmitter& emitter, size_t particle) {
+  // Trail::time is a timestamp here; trlTime is bucket-local clock
+  auto&  rg = trlRing[particle];
+  Trail* tr = &trlPoints[particle*trlCapacity];
 
   Trail tx;
+  tx.time = trlTime;
   if(decl.useEmittersFOR)
-    tx.pos = ps.pos + emitter.pos; else
-    tx.pos = ps.pos;
-
-  if(ps.trail.size()==0) {
-    ps.trail.push_back(tx);
-    }
-  else if(ps.trail.back().pos!=tx.pos) {
-    bool extrude = false;
-    if(false && ps.trail.size()>1) {
-      auto u = tx.pos              - ps.trail[ps.trail.size()-2].pos;
-      auto v = ps.trail.back().pos - ps.trail[ps.trail.size()-2].pos;
-      if(std::abs(Vec3::dotProduct(u,v)-u.length()*v.length()) < 0.001f)
-        extrude = true;
+    tx.pos = particles.pos(particle) + emitter.pos; else
+    tx.pos = particles.pos(particle);
+
+  if(rg.count==0) {
+    tr[rg.head] = tx;
+    rg.count    = 1;
+    } else {
+    auto& back = tr[(rg.head+rg.count-1)%trlCapacity];
+    if(back.pos!=tx.pos) {
+      if(size_t(rg.count)==trlCapacity) {
+        // full: drop oldest point
+        rg.head = uint16_t((rg.head+1)%trlCapacity);
+        rg.count--;
+        }
+      tr[(rg.head+rg.count)%trlCapacity] = tx;
+      rg.count++;
+      } else {
+      back.time = trlTime;
       }
-    if(extrude)
-      ps.trail.back() = tx; else
-      ps.trail.push_back(tx);
-    }
-  else {
-    ps.trail.back().time = 0;
     }
 
-  for(size_t rm=0; rm<=ps.trail.size(); ++rm) {
-    if(rm==ps.trail.size() || ps.trail[rm].time<maxTrlTime) {
-      ps.trail.erase(ps.trail.begin(),ps.trail.begin()+int(rm));
-      break;
-      }
+  while(rg.count>0 && trlTime-tr[rg.head].time>=maxTrlTime) {
+    rg.head = uint16_t((rg.head+1)%trlCapacity);
+    rg.count--;
     }
   }
 
@@ -510,8 +580,32 @@ void PfxBucket::tick(uint64_t dt, const Vec3& viewPos) {
   implTickCommon(dt,viewPos);
   }
 
+void PfxBucket::tickEmitters(uint64_t dt) {
+  if(decl.isDecal())
+    return;
+  for(size_t i=0; i<impl.size(); ++i) {
+    // NOTE: impl may grow, if child emitter is in same bucket
+    auto& emitter = impl[i];
+    if(emitter.st==S_Free)
+      continue;
+
+    if(emitter.next==nullptr && decl.ppsCreateEm!=nullptr && emitter.waitforNext<dt && emitter.st==S_Active) {
+      auto next = std::make_unique<PfxEmitter>(parent,decl.ppsCreateEm);
+      auto& e = *next;
+      e.setPosition(impl[i].pos.x,impl[i].pos.y,impl[i].pos.z);
+      e.setActive(true);
+      e.setLooped(impl[i].isLoop);
+      impl[i].next = std::move(next);
+      }
+
+    if(impl[i].waitforNext>=dt)
+      impl[i].waitforNext-=dt;
+    }
+  }
+
 void PfxBucket::implTickCommon(uint64_t dt, const Vec3& viewPos) {
   bool doShrink = false;
+  trlTime += dt;
   for(auto& emitter:impl) {
     if(emitter.st==S_Free)
       continue;
@@ -519,22 +613,10 @@ void PfxBucket::implTickCommon(uint64_t dt, const Vec3& viewPos) {
     const auto dp     = emitter.pos-viewPos;
     const bool nearby = (dp.quadLength()<PfxObjects::viewRage*PfxObjects::viewRage);
 
-    if(emitter.next==nullptr && decl.ppsCreateEm!=nullptr && emitter.waitforNext<dt && emitter.st==S_Active) {
-      emitter.next.reset(new PfxEmitter(parent,decl.ppsCreateEm));
-      auto& e = *emitter.next;
-      e.setPosition(emitter.pos.x,emitter.pos.y,emitter.pos.z);
-      e.setActive(true);
-      e.setLooped(emitter.isLoop);
-      }
-
-    if(emitter.waitforNext>=dt)
-      emitter.waitforNext-=dt;
-
     if(emitter.block!=size_t(-1)) {
       auto& p = getBlock(emitter);
       if(p.count>0) {
-        for(size_t i=0;i<blockSize;++i)
-          tick(p,emitter,i,dt);
+        tick(p,emitter,dt);
         if(p.count==0 && (emitter.st==S_Fade || !nearby)) {
           // free mem
           freeBlock(emitter.block);
@@ -574,7 +656,7 @@ void PfxBucket::implTickDecals(uint64_t, const Vec3&) {
       } else
     if(emitter.st==S_Fade) {
       for(size_t i=0; i<blockSize; ++i)
-        particles[p.offset+i].life = 0;
+        particles.life[p.offset+i] = 0;
       p.count = 0;
       freeBlock(emitter.block);
       emitter.st = S_Free;
@@ -586,12 +668,11 @@ void PfxBucket::tickEmit(Block& p, ImplEmitter& emitter, uint64_t emited) {
   size_t lastI = 0;
   for(size_t id=1; emited>0; ++id) {
     const size_t i  = id%blockSize;
-    ParState&    ps = particles[i+p.offset];
-    if(ps.life==0) { // free slot
+    if(particles.life[i+p.offset]==0) { // free slot
       --emited;
       lastI = i;
       init(p,emitter,i+p.offset);
-      if(ps.life==0)
+      if(particles.life[i+p.offset]==0)
         continue;
       p.count++;
       } else {
@@ -618,15 +699,15 @@ void PfxBucket::buildSsbo() {
       continue;
 
     for(size_t pId=0; pId<blockSize; ++pId) {
-      ParState& ps = particles[pId+p.offset];
-      auto&     px = pfxCpu   [pId+p.offset];
+      const size_t i  = pId+p.offset;
+      auto&        px = pfxCpu[i];
 
-      if(ps.life==0) {
+      if(particles.life[i]==0) {
         px.size = Vec3();
         continue;
         }
 
-      const float a     = ps.lifeTime();
+      const float a     = particles.lifeTime(i);
       const Vec3  cl    = colorS*(1.f-a)        + colorE*a;
       const float clA   = visAlphaStart*(1.f-a) + visAlphaEnd*a;
 
@@ -655,7 +736,7 @@ void PfxBucket::buildSsbo() {
         }
       uint32_t colorU32;
       std::memcpy(&colorU32,&color,4);
-      buildBilboard(px,p,ps, colorU32, szX,szY,szZ);
+      buildBilboard(px,p,i, colorU32, szX,szY,szZ);
       }
     }
   }
@@ -667,26 +748,30 @@ void PfxBucket::buildSsboTrails() {
   trlCpu.reserve(trlCpu.size());
   trlCpu.clear();
 
-  for(auto& p:particles) {
-    if(p.life==0)
+  for(size_t i=0; i<particles.size(); ++i) {
+    if(particles.life[i]==0)
       continue;
-    if(p.trail.size()<2)
+    const auto rg = trlRing[i];
+    if(rg.count<2)
       continue;
 
-    float maxT = float(std::min(maxTrlTime,p.trail[0].time));
-    for(size_t r=1; r<p.trail.size(); ++r) {
+    // segments are built from point age
+    const Trail* tr   = &trlPoints[i*trlCapacity];
+    auto         at   = [&](size_t r) { auto t = tr[(rg.head+r)%trlCapacity]; t.time = trlTime-t.time; return t; };
+    float        maxT = float(std::min(maxTrlTime,at(0).time));
+    for(size_t r=1; r<rg.count; ++r) {
       PfxState st;
-      buildTrailSegment(st,p.trail[r-1],p.trail[r],maxT);
+      buildTrailSegment(st,at(r-1),at(r),maxT);
       trlCpu.push_back(st);
       }
     }
   }
 
-void PfxBucket::buildBilboard(PfxState& v, const Block& p, const ParState& ps, const uint32_t color,
+void PfxBucket::buildBilboard(PfxState& v, const Block& p, size_t particle, const uint32_t color,
                               float szX, float szY, float szZ) {
   if(decl.useEmittersFOR)
-    v.pos = ps.pos + p.pos; else
-    v.pos = ps.pos;
+    v.pos = particles.pos(particle) + p.pos; else
+    v.pos = particles.pos(particle);
 
   v.size  = Vec3(szX,szY,szZ);
   v.color = color;
@@ -696,7 +781,7 @@ void PfxBucket::buildBilboard(PfxState& v, const Block& p, const ParState& ps, c
   v.bits0 |= uint32_t(decl.visYawAlign ? 1 : 0) << 2;
   v.bits0 |= uint32_t(0) << 3; // TODO: trails
   v.bits0 |= uint32_t(decl.visOrientation) << 4;
-  v.dir   = ps.dir;
+  v.dir   = particles.dir(particle);
   }
 
 void PfxBucket::buildTrailSegment(PfxState& v, const Trail& a, const Trail& b, float maxT) {
@@ -66,6 +66,9 @@ class PfxBucket {
     void                        freeEmitter(size_t& id);
 
     ImplEmitter&                get(size_t id) { return impl[id]; }
+    // spawns child emitters, may touch other buckets - not thread-safe
+    void                        tickEmitters(uint64_t dt);
+    // particle simulation: touches only this bucket
     void                        tick(uint64_t dt, const Tempest::Vec3& viewPos);
     void                        buildSsbo();
 
@@ -106,11 +109,32 @@ class PfxBucket {
     struct ParState final {
       uint16_t      life=0, maxLife=1;
       Tempest::Vec3 pos, dir;
+      };
+
+    // particle state as structure of arrays: simulation kernels are plain loops over streams
+    struct Particles final {
+      std::vector<uint16_t> life, maxLife;
+      std::vector<float>    posX, posY, posZ;
+      std::vector<float>    dirX, dirY, dirZ;
 
-      std::vector<Trail> trail;
+      size_t        size() const { return life.size(); }
+      void          resize(size_t sz);
+      void          set(size_t i, const ParState& ps);
+      void          clear(size_t i);
+
+      Tempest::Vec3 pos(size_t i) const { return Tempest::Vec3(posX[i],posY[i],posZ[i]); }
+      Tempest::Vec3 dir(size_t i) const { return Tempest::Vec3(dirX[i],dirY[i],dirZ[i]); }
+      float         lifeTime(size_t i) const;
+      };
 
-      float         lifeTime() const;
+    // trail points of one particle: ring of trlCapacity points in trlPoints
+    struct TrailRing final {
+      uint16_t head  = 0;
+      uint16_t count = 0;
       };
+    // one point per tick is added: ring must hold maxTrlTime at this frame time
+    static constexpr uint64_t TrailMinStep     = 4; // milliseconds
+    static constexpr size_t   TrailMaxCapacity = 1024;
 
     struct Draw {
       const Tempest::RenderPipeline* pMain   = nullptr;
@@ -134,22 +158,24 @@ class PfxBucket {
     size_t                      allocBlock();
     void                        freeBlock(size_t& s);
 
-    static float                randf();
-    static float                randf(float base, float var);
+    float                       randf();
+    float                       randf(float base, float var);
 
     Block&                      getBlock(ImplEmitter& emitter);
     Block&                      getBlock(PfxEmitter&  emitter);
 
     void                        init     (Block& block, ImplEmitter& emitter, size_t particle);
     void                        finalize (size_t particle);
-    void                        tick     (Block& sys, ImplEmitter& emitter, size_t particle, uint64_t dt);
-    void                        tickTrail(ParState& ps, ImplEmitter& emitter, uint64_t dt);
+    void                        tick     (Block& sys, ImplEmitter& emitter, uint64_t dt);
+    void                        integrate(size_t begin, size_t end, float dtF);
+    void                        tickTrail(ImplEmitter& emitter, size_t particle);
+    void                        resize   (size_t count);
 
     void                        implTickCommon(uint64_t dt, const Tempest::Vec3& viewPos);
     void                        implTickDecals(uint64_t dt, const Tempest::Vec3& viewPos);
 
     void                        buildSsboTrails();
-    void                        buildBilboard(PfxState& v, const Block& p, const ParState& ps, const uint32_t color,
+    void                        buildBilboard(PfxState& v, const Block& p, size_t particle, const uint32_t color,
                                               float szX, float szY, float szZ);
     void                        buildTrailSegment(PfxState& v, const Trail& a, const Trail& b, float maxT);
     uint32_t                    mkTrailColor(float clA) const;
@@ -162,15 +188,20 @@ class PfxBucket {
     Draw                        itemTrl[Resources::MaxFramesInFlight];
     std::vector<PfxState>       trlCpu;
 
-    uint64_t                    maxTrlTime = 0;
+    uint64_t                    maxTrlTime  = 0;
+    uint64_t                    trlTime     = 0;
+    size_t                      trlCapacity = 0;
     size_t                      blockSize = 0;
 
-    std::vector<ParState>       particles;
+    Particles                   particles;
+    std::vector<TrailRing>      trlRing;
+    std::vector<Trail>          trlPoints;
     std::vector<ImplEmitter>    impl;
     std::vector<Block>          block;
     bool                        forceUpdate[Resources::MaxFramesInFlight] = {};
 
-    static std::mt19937         rndEngine;
+    // per bucket: buckets are ticked on different workers
+    std::mt19937                rndEngine;
 
     friend class PfxEmitter;
   };
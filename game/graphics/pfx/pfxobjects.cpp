@@ -4,6 +4,7 @@
 #include <cstring>
 
 #include "graphics/sceneglobals.h"
+#include "utils/workers.h"
 
 #include "pfxbucket.h"
 #include "particlefx.h"
@@ -39,11 +40,21 @@ void PfxObjects::tick(uint64_t ticks) {
   if(dt==0)
     return;
 
+  // child emitters are allocated in other buckets - serial
   for(auto& i:bucket)
-    i.tick(dt,viewerPos);
+    i.tickEmitters(dt);
 
+  tickList.clear();
   for(auto& i:bucket)
-    i.buildSsbo();
+    tickList.push_back(&i);
+
+  const Vec3 viewPos = viewerPos;
+  // one task per bucket: bucket count is small, but each tick is heavy
+  Workers::parallelTasks(tickList.size(),[this,dt,viewPos](size_t id){
+    auto b = tickList[id];
+    b->tick(dt,viewPos);
+    b->buildSsbo();
+    });
 
   lastUpdate = ticks;
   }
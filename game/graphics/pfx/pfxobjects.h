@@ -51,6 +51,7 @@ class PfxObjects final {
     std::recursive_mutex          sync;
 
     std::list<PfxBucket>          bucket;
+    std::vector<PfxBucket*>       tickList;
     std::vector<SpriteEmitter>    spriteEmit;
 
     Tempest::Vec3                 viewerPos={};
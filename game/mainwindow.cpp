@@ -178,22 +178,18 @@ void MainWindow::paintEvent(PaintEvent& event) {
     }
 
   if(st!=Gothic::LoadState::Idle && st!=Gothic::LoadState::Finalize) {
-    if(st==Gothic::LoadState::Saving) {
-      drawSaving(p);
-      } else {
-      if(auto back = Gothic::inst().loadingBanner()) {
-        p.setBrush(Brush(*back,Painter::NoBlend));
-        p.drawRect(0,0,this->w(),this->h(),
-                   0,0,back->w(),back->h());
-        }
-      if(loadBox!=nullptr && !loadBox->isEmpty()) {
-        if(Gothic::inst().version().game==1) {
-          int lw = int(w()*0.5);
-          int lh = int(h()*0.05);
-          drawLoading(p,(w()-lw)/2, int(h()*0.75), lw, lh);
-          } else {
-          drawLoading(p,int(w()*0.92)-loadBox->w(), int(h()*0.12), loadBox->w(),loadBox->h());
-          }
+    if(auto back = Gothic::inst().loadingBanner()) {
+      p.setBrush(Brush(*back,Painter::NoBlend));
+      p.drawRect(0,0,this->w(),this->h(),
+                 0,0,back->w(),back->h());
+      }
+    if(loadBox!=nullptr && !loadBox->isEmpty()) {
+      if(Gothic::inst().version().game==1) {
+        int lw = int(w()*0.5);
+        int lh = int(h()*0.05);
+        drawLoading(p,(w()-lw)/2, int(h()*0.75), lw, lh);
+        } else {
+        drawLoading(p,int(w()*0.92)-loadBox->w(), int(h()*0.12), loadBox->w(),loadBox->h());
         }
       }
     } else {
@@ -257,7 +253,12 @@ void MainWindow::paintEvent(PaintEvent& event) {
 
   if(Gothic::inst().doFrate() && !Gothic::inst().isDesktop()) {
     char fpsT[64]={};
-    std::snprintf(fpsT,sizeof(fpsT),"fps = %.2f",fps.get());
+    if(world!=nullptr) {
+      auto& st = world->animationStats();
+      std::snprintf(fpsT,sizeof(fpsT),"fps = %.2f, anim = %u/%u",fps.get(),unsigned(st.sampled),unsigned(st.total));
+      } else {
+      std::snprintf(fpsT,sizeof(fpsT),"fps = %.2f",fps.get());
+      }
     //string_frm fpsT("fps = ", fps.get(), " ", info);
 
     auto& fnt = Resources::font();
@@ -698,46 +699,6 @@ void MainWindow::drawLoading(Painter &p, int x, int y, int w, int h) {
   drawProgress(p,x,y,w,h,v);
   }
 
-void MainWindow::drawSaving(Painter &p) {
-  if(auto back = Gothic::inst().loadingBanner()) {
-    p.setBrush(Brush(*back,Painter::NoBlend));
-    p.drawRect(0,0,this->w(),this->h(),
-               0,0,back->w(),back->h());
-    }
-
-  if(saveback==nullptr)
-    saveback = Resources::loadTexture("SAVING.TGA");
-  if(saveback==nullptr)
-    return;
-
-  const float scale = Gothic::options().interfaceScale;
-  int         szX   = Gothic::options().saveGameImageSize.w;
-  int         szY   = Gothic::options().saveGameImageSize.h;
-
-  if(szX<=460 || szY<=300) {
-    // way too small otherwise
-    szX = 460;
-    szY = 300;
-    }
-  szX = int(float(szX)*scale);
-  szY = int(float(szY)*scale);
-  drawSaving(p,*saveback,szX,szY,scale);
-  }
-
-void MainWindow::drawSaving(Painter& p, const Tempest::Texture2d& back, int sw, int sh, float scale) {
-  const int x = (w()-sw)/2, y = (h()-sh)/2;
-
-  // SAVING.TGA is semi-transparent image with the idea to accomulate alpha over time
-  // ... for loop for now
-  p.setBrush(back);
-  for(int i=0;i<10;++i) {
-    p.drawRect(x,y,sw,sh, 0,0,back.w(),back.h());
-    }
-
-  float v = float(Gothic::inst().loadingProgress())/100.f;
-  drawProgress(p, x+int(100.f*scale), y+sh-int(75.f*scale), sw-2*int(100.f*scale), int(40.f*scale), v);
-  }
-
 void MainWindow::isDialogClosed(bool& ret) {
   ret = !(dialogs.isActive() || document.isActive());
   }
@@ -837,12 +798,10 @@ uint64_t MainWindow::tick() {
   lastTick  = time;
 
   auto st = Gothic::inst().checkLoading();
-  if(st==Gothic::LoadState::Finalize || st==Gothic::LoadState::FailedLoad || st==Gothic::LoadState::FailedSave) {
+  if(st==Gothic::LoadState::Finalize || st==Gothic::LoadState::FailedLoad) {
     Gothic::inst().finishLoading();
     if(st==Gothic::LoadState::FailedLoad)
       rootMenu.setMainMenu();
-    if(st==Gothic::LoadState::FailedSave)
-      Gothic::inst().onPrint("unable to write savegame file");
     return 0;
     }
   else if(st!=Gothic::LoadState::Idle) {
@@ -1028,19 +987,7 @@ void MainWindow::saveGame(std::string_view slot, std::string_view name) {
   if(auto w = Gothic::inst().world(); w!=nullptr && w->currentCs()!=nullptr)
     return;
 
-  Gothic::inst().startSave(std::move(textureCast(tex)),[slot=std::string(slot),name=std::string(name),pm](std::unique_ptr<GameSession>&& game){
-    if(!game)
-      return std::move(game);
-
-    Tempest::WFile f(slot);
-    Serialize      s(f);
-    game->save(s,name,pm);
-
-    // no print yet, because threading
-    // gothic.print("Game saved");
-    return std::move(game);
-    });
-
+  Gothic::inst().startSnapshotSave(slot,name,pm);
   update();
   }
 
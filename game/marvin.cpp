@@ -129,6 +129,11 @@ Marvin::Marvin() {
     {"insert %c",                  C_Insert},
 
     {"toggle gi",                  C_ToggleGI},
+    {"toggle scriptstats",         C_ToggleScriptStats},
+    {"print scriptstats",          C_PrintScriptStats},
+    {"profile start",              C_ProfileStart},
+    {"profile stop",               C_ProfileStop},
+    {"profile dump",               C_ProfileDump},
     };
   }
 
@@ -367,6 +372,39 @@ bool Marvin::exec(std::string_view v) {
     case C_ToggleGI:
       Gothic::inst().toggleGi();
       return true;
+    case C_ToggleScriptStats: {
+      World* world = Gothic::inst().world();
+      if(world==nullptr)
+        return false;
+      auto& sc = world->script();
+      sc.setCallStatsEnabled(!sc.isCallStatsEnabled());
+      print(sc.isCallStatsEnabled() ? "script stats: on" : "script stats: off");
+      return true;
+      }
+    case C_PrintScriptStats: {
+      World* world = Gothic::inst().world();
+      if(world==nullptr)
+        return false;
+      return printScriptStats(world);
+      }
+    case C_ProfileStart:
+    case C_ProfileStop: {
+      World* world = Gothic::inst().world();
+      if(world==nullptr)
+        return false;
+      auto& prof = world->script().profiler();
+      if(ret.cmd.type==C_ProfileStart)
+        prof.start(); else
+        prof.stop();
+      print(prof.isActive() ? "script profiler: on" : "script profiler: off");
+      return true;
+      }
+    case C_ProfileDump: {
+      World* world = Gothic::inst().world();
+      if(world==nullptr)
+        return false;
+      return dumpScriptProfile(world);
+      }
     }
 
   return true;
@@ -426,6 +464,38 @@ bool Marvin::printVariable(World* world, std::string_view name) {
   return true;
   }
 
+bool Marvin::printScriptStats(World* world) {
+  auto& sc = world->script();
+  if(!sc.isCallStatsEnabled()) {
+    print("script stats are disabled, use 'toggle scriptstats'");
+    return true;
+    }
+  for(auto& i:sc.callStatsTop(16)) {
+    auto*  sym = sc.findSymbol(i.symbol);
+    float  ms  = float(i.time)/1000000.f;
+    float  avg = float(i.time)/float(i.calls)/1000.f;
+    string_frm<128> buf(sym!=nullptr ? std::string_view(sym->name()) : "?",": calls=",size_t(i.calls)," total=",ms,"ms avg=",avg,"us");
+    print(buf);
+    }
+  return true;
+  }
+
+bool Marvin::dumpScriptProfile(World* world) {
+  static const char* path = "scriptprofile.folded";
+
+  auto& prof = world->script().profiler();
+  if(!prof.dump(path))
+    return false;
+  for(auto& i:prof.top(10)) {
+    float self  = float(i.self) /1000000.f;
+    float total = float(i.total)/1000000.f;
+    string_frm<128> buf(prof.name(i.symbol),": calls=",size_t(i.calls)," self=",self,"ms total=",total,"ms");
+    print(buf);
+    }
+  print(string_frm("written: ",path));
+  return true;
+  }
+
 bool Marvin::setTime(World& world, std::string_view hh, std::string_view mm) {
   int hv = 0, mv = 0;
 
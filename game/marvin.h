@@ -51,6 +51,11 @@ class Marvin {
 
       // opengothic specific
       C_ToggleGI,
+      C_ToggleScriptStats,
+      C_PrintScriptStats,
+      C_ProfileStart,
+      C_ProfileStop,
+      C_ProfileDump,
       };
 
     struct Cmd {
@@ -76,6 +81,8 @@ class Marvin {
 
     bool   addItemOrNpcBySymbolName(World* world, std::string_view name, const Tempest::Vec3& at);
     bool   printVariable           (World* world, std::string_view name);
+    bool   printScriptStats        (World* world);
+    bool   dumpScriptProfile       (World* world);
     bool   setTime                 (World& world, std::string_view hh, std::string_view mm);
 
     std::vector<Cmd> cmd;
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <Tempest/Point>
+
+#include <unordered_map>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+
+// Uniform grid in xz-plane; bodies are bucketed by their pivot and moved between cells incrementally.
+// T provides: Tempest::Vec3 pos; uint64_t cell; size_t inCell;
+template<class T>
+class BodyGrid final {
+  public:
+    explicit BodyGrid(float cellSize):cellSize(cellSize){}
+
+    void link(T& n) {
+      n.cell   = cellOf(n.pos);
+      auto& c  = cells[n.cell];
+      n.inCell = c.size();
+      c.push_back(&n);
+      }
+
+    void unlink(T& n) {
+      auto  it = cells.find(n.cell);
+      auto& c  = it->second;
+      c[n.inCell]         = c.back();
+      c[n.inCell]->inCell = n.inCell;
+      c.pop_back();
+      if(c.empty())
+        cells.erase(it);
+      }
+
+    void onMove(T& n) {
+      if(cellOf(n.pos)==n.cell)
+        return;
+      unlink(n);
+      link(n);
+      }
+
+    // count of cells, touched by xz-area; used to pick a linear scan for long rays
+    uint64_t areaCells(float x0, float z0, float x1, float z1) const {
+      return uint64_t(cellCoord(x1)-cellCoord(x0)+1)*uint64_t(cellCoord(z1)-cellCoord(z0)+1);
+      }
+
+    size_t cellCount() const { return cells.size(); }
+
+    template<class F>
+    void forEach(float x0, float z0, float x1, float z1, const F& func) const {
+      const int32_t cx0 = cellCoord(x0), cx1 = cellCoord(x1);
+      const int32_t cz0 = cellCoord(z0), cz1 = cellCoord(z1);
+      for(int32_t z=cz0; z<=cz1; ++z)
+        for(int32_t x=cx0; x<=cx1; ++x) {
+          auto c = cells.find(cellKey(x,z));
+          if(c==cells.end())
+            continue;
+          for(auto i:c->second)
+            func(i);
+          }
+      }
+
+  private:
+    static uint64_t cellKey(int32_t x, int32_t z) {
+      return (uint64_t(uint32_t(x)) << 32) | uint64_t(uint32_t(z));
+      }
+
+    int32_t cellCoord(float v) const {
+      return int32_t(std::floor(v/cellSize));
+      }
+
+    uint64_t cellOf(const Tempest::Vec3& p) const {
+      return cellKey(cellCoord(p.x),cellCoord(p.z));
+      }
+
+    float                                        cellSize = 1;
+    std::unordered_map<uint64_t,std::vector<T*>> cells;
+  };
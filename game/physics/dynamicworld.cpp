@@ -3,15 +3,22 @@
 #include "collisionworld.h"
 #include "physicmeshshape.h"
 #include "physicvbo.h"
+#include "heightfield.h"
+#include "loscache.h"
+#include "bodygrid.h"
 #include "graphics/mesh/skeleton.h"
 
 #include <algorithm>
+#include <unordered_map>
 #include <cmath>
+#include <cstring>
 
 #include "graphics/mesh/submesh/packedmesh.h"
 #include "world/objects/item.h"
 #include "world/bullet.h"
 #include "world/world.h"
+#include "world/landcache.h"
+#include "utils/workers.h"
 
 const float DynamicWorld::ghostPadding=50-22.5f;
 const float DynamicWorld::ghostHeight =140;
@@ -43,8 +50,11 @@ struct DynamicWorld::NpcBody : btRigidBody {
   Tempest::Vec3 pos={};
   float         r=0, h=0, rX=0, rZ=0;
   bool          enable=true;
-  size_t        frozen=size_t(-1);
-  uint64_t      lastMove=0;
+
+  // location in NpcBodyList
+  size_t        index  = 0;
+  uint64_t      cell   = 0;
+  size_t        inCell = 0;
 
   Npc* toNpc() {
     return reinterpret_cast<Npc*>(getUserPointer());
@@ -61,14 +71,10 @@ struct DynamicWorld::NpcBody : btRigidBody {
   };
 
 struct DynamicWorld::NpcBodyList final {
-  struct Record final {
-    NpcBody* body = nullptr;
-    float    x    = 0.f;
-    };
+  static constexpr float CellSize = 256.f;
 
-  NpcBodyList(DynamicWorld& wrld):wrld(wrld){
-    body  .reserve(1024);
-    frozen.reserve(1024);
+  NpcBodyList(DynamicWorld& wrld):wrld(wrld),grid(CellSize){
+    body.reserve(1024);
     }
 
   NpcBody* create(const Tempest::Vec3 &min, const Tempest::Vec3 &max) {
@@ -97,44 +103,19 @@ struct DynamicWorld::NpcBodyList final {
     }
 
   void add(NpcBody* b){
-    Record r;
-    r.body = b;
-    r.x    = b->pos.x;
-    body.push_back(r);
+    b->index = body.size();
+    body.push_back(b);
+    grid.link(*b);
     }
 
-  bool del(void* b){
-    if(del(b,body))
-      return true;
-    if(del(b,frozen)){
-      srt=false;
-      return true;
-      }
-    return false;
-    }
-
-  bool del(void* b,std::vector<Record>& arr){
-    for(size_t i=0;i<arr.size();++i){
-      if(arr[i].body!=b)
-        continue;
-      arr[i]=arr.back();
-      arr.pop_back();
-      return true;
-      }
-    return false;
-    }
-
-  bool delMisordered(NpcBody* b,std::vector<Record>& arr){
-    auto&       fr = arr[b->frozen];
-    const float x  = fr.x;
-    if((b->frozen==0 || arr[b->frozen-1].x<x) &&
-       (b->frozen+1==arr.size() || x<arr[b->frozen+1].x)) {
-      fr.x = fr.body->pos.x;
+  bool del(NpcBody* b){
+    if(b==nullptr || b->index>=body.size() || body[b->index]!=b)
       return false;
-      } else {
-      fr.body = nullptr;
-      return true;
-      }
+    grid.unlink(*b);
+    body[b->index]        = body.back();
+    body[b->index]->index = b->index;
+    body.pop_back();
+    return true;
     }
 
   void resize(NpcBody& n, float h, float dx, float dz){
@@ -146,21 +127,11 @@ struct DynamicWorld::NpcBodyList final {
     n.h = h;
 
     maxR = std::max(maxR,n.r);
+    maxR = std::max(maxR,0.5f*(n.rX+n.rZ));
     }
 
   void onMove(NpcBody& n){
-    if(n.frozen!=size_t(-1)) {
-      if(delMisordered(&n,frozen)){
-        n.lastMove = tick;
-        n.frozen   = size_t(-1);
-
-        Record r;
-        r.body = &n;
-        body.push_back(r);
-        }
-      } else {
-      n.lastMove = tick;
-      }
+    grid.onMove(n);
     }
 
   bool rayTest(NpcBody& npc, const Tempest::Vec3& s, const Tempest::Vec3& e, float extR, float& proj) {
@@ -190,24 +161,25 @@ struct DynamicWorld::NpcBodyList final {
     NpcBody* ret     = nullptr;
     float    minProj = 2;
 
-    for(auto i:body) {
-      float proj = 0;
-      if(rayTest(*i.body, s, e, extR, proj)) {
-        if(proj<minProj) {
-          ret     = i.body;
-          minProj = proj;
-          }
-        }
-      }
-    for(auto i:frozen) {
+    auto test = [&](NpcBody* b) {
       float proj = 0;
-      if(i.body!=nullptr && rayTest(*i.body, s, e, extR, proj)) {
-        if(proj<minProj) {
-          ret     = i.body;
-          minProj = proj;
-          }
+      if(rayTest(*b, s, e, extR, proj) && proj<minProj) {
+        ret     = b;
+        minProj = proj;
         }
+      };
+
+    const float pad = maxR+std::max(extR,0.f);
+    const float x0  = std::min(s.x,e.x)-pad, x1 = std::max(s.x,e.x)+pad;
+    const float z0  = std::min(s.z,e.z)-pad, z1 = std::max(s.z,e.z)+pad;
+    if(grid.areaCells(x0,z0,x1,z1) > grid.cellCount()) {
+      // long ray: touches more cells, than there are occupied
+      for(auto i:body)
+        test(i);
+      return ret;
       }
+
+    grid.forEach(x0,z0,x1,z1,test);
     return ret;
     }
 
@@ -221,38 +193,12 @@ struct DynamicWorld::NpcBodyList final {
       return false;
     const NpcBody& n = *pn;
 
-    if(srt){
-      if(hasCollision(n,frozen,normal,true))
-        return true;
-      return hasCollision(n,body,normal,false);
-      } else {
-      if(hasCollision(n,body,normal,false))
-        return true;
-      //adjustSort();
-      return hasCollision(n,frozen,normal,false);
-      }
-    }
-
-  bool hasCollision(const NpcBody& n,const std::vector<Record>& arr,Tempest::Vec3& normal, bool sorted) {
-    auto l = arr.begin();
-    auto r = arr.end();
-
-    if(sorted) {
-      const float dX = maxR+n.r;
-      l = std::lower_bound(arr.begin(),arr.end(),n.pos.x-dX,[](const Record& b,float x){ return b.x<x; });
-      r = std::upper_bound(arr.begin(),arr.end(),n.pos.x+dX,[](float x,const Record& b){ return x<b.x; });
-      }
-
-    const auto dist = std::distance(l,r);
-    if(dist<=1)
-      return false;
-
-    bool ret=false;
-    for(;l!=r;++l){
-      auto& v = (*l);
-      if(v.body!=nullptr && v.body->enable && hasCollision(n,*v.body,normal))
+    const float dX  = maxR+n.r;
+    bool        ret = false;
+    grid.forEach(n.pos.x-dX,n.pos.z-dX,n.pos.x+dX,n.pos.z+dX,[&](NpcBody* i) {
+      if(i->enable && hasCollision(n,*i,normal))
         ret = true;
-      }
+      });
     return ret;
     }
 
@@ -273,53 +219,9 @@ struct DynamicWorld::NpcBodyList final {
     return true;
     }
 
-  void adjustSort() {
-    srt=true;
-    std::sort(frozen.begin(),frozen.end(),[](Record& a,Record& b){
-      return a.x < b.x;
-      });
-    for(size_t i=0; i<frozen.size(); ++i)
-      frozen[i].body->frozen = i;
-    }
-
-  void tickAabbs() {
-    for(size_t i=0;i<body.size();) {
-      if(body[i].body->lastMove!=tick){
-        auto b = body[i];
-        body[i]=body.back();
-        body.pop_back();
-
-        b.x = b.body->pos.x;
-        frozen.push_back(b);
-        } else {
-        ++i;
-        }
-      }
-
-    for(size_t i=0;i<frozen.size();) {
-      if(frozen[i].body==nullptr) {
-        frozen[i]=frozen.back();
-        frozen.pop_back();
-        }
-      else if(frozen[i].body->lastMove==tick){
-        frozen[i].body->frozen=size_t(-1);
-        body.push_back(frozen[i]);
-        frozen[i]=frozen.back();
-        frozen.pop_back();
-        }
-      else {
-        ++i;
-        }
-      }
-
-    adjustSort();
-    tick++;
-    }
-
   DynamicWorld&         wrld;
-  std::vector<Record>   body, frozen;
-  bool                  srt=false;
-  uint64_t              tick=0;
+  std::vector<NpcBody*> body;
+  BodyGrid<NpcBody>     grid;
   float                 maxR=0;
   };
 
@@ -411,11 +313,96 @@ struct DynamicWorld::BBoxList final {
   DynamicWorld&          wrld;
   };
 
-DynamicWorld::DynamicWorld(World& owner,const zenkit::Mesh& worldMesh) {
+struct DynamicWorld::RayCallback:btCollisionWorld::ClosestRayResultCallback {
+  using ClosestRayResultCallback::ClosestRayResultCallback;
+  zenkit::MaterialGroup matId  = zenkit::MaterialGroup::UNDEFINED;
+  const char*           sector = nullptr;
+  Category              colCat = C_Null;
+  uint8_t               mask   = RM_Default;
+
+  bool needsCollision(btBroadphaseProxy* proxy0) const override {
+    auto obj=reinterpret_cast<btCollisionObject*>(proxy0->m_clientObject);
+    if(isInMask(*obj,mask))
+      return ClosestRayResultCallback::needsCollision(proxy0);
+    return false;
+    }
+
+  btScalar addSingleResult(btCollisionWorld::LocalRayResult& rayResult, bool normalInWorldSpace) override {
+    auto shape = rayResult.m_collisionObject->getCollisionShape();
+    if(shape!=nullptr) {
+      auto s  = reinterpret_cast<const btMultimaterialTriangleMeshShape*>(shape);
+      auto mt = reinterpret_cast<const PhysicVbo*>(s->getMeshInterface());
+
+      size_t id = size_t(rayResult.m_localShapeInfo->m_shapePart);
+      matId  = mt->materialId(id);
+      sector = mt->sectorName(id);
+      }
+    colCat = Category(rayResult.m_collisionObject->getUserIndex());
+    return ClosestRayResultCallback::addSingleResult(rayResult,normalInWorldSpace);
+    }
+  };
+
+static uint64_t meshLayoutHash(PhysicVbo& mesh) {
+  // bvh refers to triangles by subpart and index: cached tree is valid only for exactly same triangle layout
+  uint64_t h   = 0xcbf29ce484222325ull;
+  auto     mix = [&h](uint64_t v) {
+    h ^= v;
+    h *= 0x100000001b3ull;
+    };
+
+  auto& parts = mesh.getIndexedMeshArray();
+  mix(uint64_t(parts.size()));
+  for(int i=0; i<parts.size(); ++i) {
+    auto& p = parts[i];
+    mix(uint64_t(p.m_numTriangles));
+    mix(uint64_t(p.m_numVertices));
+    auto ibo = reinterpret_cast<const uint32_t*>(p.m_triangleIndexBase);
+    for(size_t r=0; r<size_t(p.m_numTriangles)*3; ++r)
+      mix(ibo[r]);
+    }
+  if(parts.size()>0) {
+    auto vbo = reinterpret_cast<const btVector3*>(parts[0].m_vertexBase);
+    for(int i=0; i<parts[0].m_numVertices; ++i) {
+      const float f[3] = {vbo[i].x(), vbo[i].y(), vbo[i].z()};
+      uint32_t    v[3] = {};
+      std::memcpy(v,f,sizeof(v));
+      mix(v[0]);
+      mix(v[1]);
+      mix(v[2]);
+      }
+    }
+  return h;
+  }
+
+static btCollisionShape* mkLandShape(PhysicVbo& mesh, const LandCache& cache, LandCache::Kind k, std::vector<uint8_t>& bvhData) {
+  const bool     quantized = mesh.useQuantization();
+  const uint64_t layout    = meshLayoutHash(mesh);
+  if(cache.load(k,bvhData,layout)) {
+    // bvh is deserialized in place: bvhData must outlive the shape
+    auto bvh = btOptimizedBvh::deSerializeInPlace(bvhData.data(),unsigned(bvhData.size()),false);
+    if(bvh!=nullptr && bvh->isQuantized()==quantized) {
+      auto shape = new btMultimaterialTriangleMeshShape(&mesh,quantized,false);
+      shape->setOptimizedBvh(static_cast<btOptimizedBvh*>(bvh));
+      return shape;
+      }
+    }
+  bvhData.clear();
+
+  auto shape = new btMultimaterialTriangleMeshShape(&mesh,quantized,true);
+  if(auto bvh = shape->getOptimizedBvh()) {
+    std::vector<uint8_t> blob(bvh->calculateSerializeBufferSize());
+    if(bvh->serializeInPlace(blob.data(),unsigned(blob.size()),false))
+      cache.save(k,blob.data(),blob.size(),layout);
+    }
+  return shape;
+  }
+
+DynamicWorld::DynamicWorld(World& owner, const zenkit::Mesh& worldMesh, const LandCache& cache) {
   world.reset(new CollisionWorld());
+  los  .reset(new LosCache());
 
   {
-  PackedMesh pkg(worldMesh,PackedMesh::PK_Physic);
+  PackedMesh pkg(worldMesh,PackedMesh::PK_Physic,cache);
   sectors.resize(pkg.subMeshes.size());
   for(size_t i=0;i<sectors.size();++i)
     sectors[i] = pkg.subMeshes[i].material.name;
@@ -428,24 +415,30 @@ DynamicWorld::DynamicWorld(World& owner,const zenkit::Mesh& worldMesh) {
 
   landMesh .reset(new PhysicVbo(&landVbo));
   waterMesh.reset(new PhysicVbo(&landVbo));
+  landGrid .reset(new HeightField(landVbo));
+  waterGrid.reset(new HeightField(landVbo));
 
   for(size_t i=0;i<pkg.subMeshes.size();++i) {
     auto& sm = pkg.subMeshes[i];
     if(!sm.material.disable_collision && sm.iboLength>0) {
       if(sm.material.group==zenkit::MaterialGroup::WATER) {
         waterMesh->addIndex(pkg.indices,sm.iboOffset,sm.iboLength,sm.material.group);
+        waterGrid->addIndex(pkg.indices,sm.iboOffset,sm.iboLength,sm.material.group,nullptr);
         } else {
         landMesh ->addIndex(pkg.indices,sm.iboOffset,sm.iboLength,sm.material.group,sectors[i].c_str());
+        landGrid ->addIndex(pkg.indices,sm.iboOffset,sm.iboLength,sm.material.group,sectors[i].c_str());
         }
       }
     }
+  landGrid ->build();
+  waterGrid->build();
   }
 
   btVector3 bbox[2] = {btVector3(0,0,0), btVector3(0,0,0)};
   if(!landMesh->isEmpty()) {
     Tempest::Matrix4x4 mt;
     mt.identity();
-    landShape.reset(new btMultimaterialTriangleMeshShape(landMesh.get(),landMesh->useQuantization(),true));
+    landShape.reset(mkLandShape(*landMesh,cache,LandCache::K_LandBvh,landBvh));
     landBody = world->addCollisionBody(*landShape,mt,DynamicWorld::materialFriction(zenkit::MaterialGroup::NONE));
     landBody->setUserIndex(C_Landscape);
 
@@ -458,7 +451,7 @@ DynamicWorld::DynamicWorld(World& owner,const zenkit::Mesh& worldMesh) {
   if(!waterMesh->isEmpty()) {
     Tempest::Matrix4x4 mt;
     mt.identity();
-    waterShape.reset(new btMultimaterialTriangleMeshShape(waterMesh.get(),waterMesh->useQuantization(),true));
+    waterShape.reset(mkLandShape(*waterMesh,cache,LandCache::K_WaterBvh,waterBvh));
     waterBody = world->addCollisionBody(*waterShape,mt,0);
     waterBody->setUserIndex(C_Water);
     waterBody->setCollisionFlags(btCollisionObject::CF_STATIC_OBJECT | btCollisionObject::CF_NO_CONTACT_RESPONSE);
@@ -516,7 +509,20 @@ DynamicWorld::RayWaterResult DynamicWorld::implWaterRay(const Tempest::Vec3& fro
   CallBack callback{CollisionWorld::toMeters(from), CollisionWorld::toMeters(to)};
   callback.m_flags = btTriangleRaycastCallback::kF_KeepUnflippedNormal | btTriangleRaycastCallback::kF_FilterBackfaces;
 
-  if(waterBody!=nullptr) {
+  HeightField::Hit     fast;
+  HeightField::Status  fastSt = HeightField::S_Ambiguous;
+  if(from.x==to.x && from.z==to.z)
+    fastSt = waterGrid->rayTest(callback.m_rayFromWorld,callback.m_rayToWorld.y(),fast);
+
+  if(fastSt==HeightField::S_Done) {
+    if(fast.hasCol) {
+      callback.m_closestHitFraction = fast.fraction;
+      callback.m_hitPointWorld      = fast.v;
+      callback.m_collisionObject    = waterBody.get();
+      }
+    }
+  else if(fastSt==HeightField::S_Ambiguous && waterBody!=nullptr) {
+    // NOTE: S_Outside - no water triangles at this point
     btTransform rayFromTrans,rayToTrans;
     rayFromTrans.setIdentity();
     rayFromTrans.setOrigin(callback.m_rayFromWorld);
@@ -548,37 +554,90 @@ DynamicWorld::RayWaterResult DynamicWorld::implWaterRay(const Tempest::Vec3& fro
   return ret;
   }
 
-DynamicWorld::RayLandResult DynamicWorld::ray(const Tempest::Vec3& from, const Tempest::Vec3& to) const {
-  struct CallBack:btCollisionWorld::ClosestRayResultCallback {
-    using ClosestRayResultCallback::ClosestRayResultCallback;
-    zenkit::MaterialGroup matId  = zenkit::MaterialGroup::UNDEFINED;
-    const char*           sector = nullptr;
-    Category              colCat = C_Null;
+bool DynamicWorld::fastRay(const Tempest::Vec3& from, const Tempest::Vec3& to, RayLandResult& out) const {
+  if(from.x!=to.x || from.z!=to.z)
+    return false;
 
-    bool needsCollision(btBroadphaseProxy* proxy0) const override {
-      auto obj=reinterpret_cast<btCollisionObject*>(proxy0->m_clientObject);
-      if(obj->getUserIndex()==C_Landscape || obj->getUserIndex()==C_Object)
-        return ClosestRayResultCallback::needsCollision(proxy0);
-      return false;
-      }
+  const btVector3  src = CollisionWorld::toMeters(from);
+  HeightField::Hit hit;
+  if(landGrid->rayTest(src,CollisionWorld::toMeters(to).y(),hit)!=HeightField::S_Done)
+    return false;
 
-    btScalar addSingleResult(btCollisionWorld::LocalRayResult& rayResult, bool normalInWorldSpace) override {
-      auto shape = rayResult.m_collisionObject->getCollisionShape();
-      if(shape!=nullptr) {
-        auto s  = reinterpret_cast<const btMultimaterialTriangleMeshShape*>(shape);
-        auto mt = reinterpret_cast<const PhysicVbo*>(s->getMeshInterface());
+  if(auto objects = landGrid->objectsAt(src)) {
+    // vobs, that stand on this cell: only hits above the ground are of interest
+    RayCallback callback{src, CollisionWorld::toMeters(to)};
+    callback.m_flags              = btTriangleRaycastCallback::kF_KeepUnflippedNormal | btTriangleRaycastCallback::kF_FilterBackfaces;
+    callback.m_closestHitFraction = hit.fraction;
 
-        size_t id = size_t(rayResult.m_localShapeInfo->m_shapePart);
-        matId  = mt->materialId(id);
-        sector = mt->sectorName(id);
-        }
-      colCat = Category(rayResult.m_collisionObject->getUserIndex());
-      return ClosestRayResultCallback::addSingleResult(rayResult,normalInWorldSpace);
+    btTransform rayFromTrans,rayToTrans;
+    rayFromTrans.setIdentity();
+    rayFromTrans.setOrigin(callback.m_rayFromWorld);
+    rayToTrans.setIdentity();
+    rayToTrans.setOrigin(callback.m_rayToWorld);
+    for(auto obj:*objects)
+      world->rayTestSingle(rayFromTrans, rayToTrans, obj,
+                           obj->getCollisionShape(),
+                           obj->getWorldTransform(),
+                           callback);
+
+    if(callback.hasHit()) {
+      out             = RayLandResult();
+      out.v           = CollisionWorld::toCentimeters(callback.m_hitPointWorld);
+      out.mat         = callback.matId;
+      out.hasCol      = true;
+      out.hitFraction = callback.m_closestHitFraction;
+      out.sector      = callback.sector;
+      return true;
       }
-    };
+    }
 
-  CallBack callback{CollisionWorld::toMeters(from), CollisionWorld::toMeters(to)};
+  out             = RayLandResult();
+  out.v           = hit.hasCol ? CollisionWorld::toCentimeters(hit.v) : to;
+  out.n           = Tempest::Vec3(hit.n.x(),hit.n.y(),hit.n.z());
+  out.mat         = hit.mat;
+  out.hasCol      = hit.hasCol;
+  out.hitFraction = hit.fraction;
+  out.sector      = hit.sector;
+  return true;
+  }
+
+void DynamicWorld::linkObject(btCollisionObject& obj, bool link) {
+  btVector3 b[2] = {};
+  obj.getCollisionShape()->getAabb(obj.getWorldTransform(),b[0],b[1]);
+  // door or mover may open/close line of sight
+  los->invalidate(CollisionWorld::toCentimeters(b[0]),CollisionWorld::toCentimeters(b[1]));
+  if(landGrid==nullptr)
+    return;
+  if(link)
+    landGrid->addObject(obj,b[0],b[1]); else
+    landGrid->removeObject(obj,b[0],b[1]);
+  }
+
+bool DynamicWorld::isInMask(const btCollisionObject& obj, uint8_t mask) {
+  switch(obj.getUserIndex()) {
+    case C_Landscape:
+      return (mask & RM_Landscape)!=0;
+    case C_Object:
+      return (mask & RM_Object)!=0;
+    case C_Water:
+      return (mask & RM_Water)!=0;
+    }
+  return false;
+  }
+
+DynamicWorld::RayLandResult DynamicWorld::ray(const Tempest::Vec3& from, const Tempest::Vec3& to) const {
+  return implRay(from,to,RM_Default);
+  }
+
+DynamicWorld::RayLandResult DynamicWorld::implRay(const Tempest::Vec3& from, const Tempest::Vec3& to, uint8_t mask) const {
+  // height field knows landscape and lists collision objects per cell
+  RayLandResult fast;
+  if((mask & (RM_Landscape|RM_Water))==RM_Landscape && fastRay(from,to,fast))
+    return fast;
+
+  RayCallback callback{CollisionWorld::toMeters(from), CollisionWorld::toMeters(to)};
   callback.m_flags = btTriangleRaycastCallback::kF_KeepUnflippedNormal | btTriangleRaycastCallback::kF_FilterBackfaces;
+  callback.mask    = mask;
 
   world->rayCast(from,to,callback);
 
@@ -601,6 +660,15 @@ DynamicWorld::RayLandResult DynamicWorld::ray(const Tempest::Vec3& from, const T
   return ret;
   }
 
+bool DynamicWorld::rayLos(const Npc& observer, const Npc& target, const Tempest::Vec3& from, const Tempest::Vec3& to) const {
+  bool visible = false;
+  if(los->find(&observer,&target,from,to,visible))
+    return visible;
+  visible = !ray(from,to).hasCol;
+  los->insert(&observer,&target,from,to,visible);
+  return visible;
+  }
+
 DynamicWorld::RayQueryResult DynamicWorld::rayNpc(const Tempest::Vec3& from, const Tempest::Vec3& to) const {
   RayQueryResult r;
   static_cast<RayLandResult&>(r) = ray(from,to);
@@ -612,17 +680,44 @@ DynamicWorld::RayQueryResult DynamicWorld::rayNpc(const Tempest::Vec3& from, con
   }
 
 float DynamicWorld::soundOclusion(const Tempest::Vec3& from, const Tempest::Vec3& to) const {
+  return implOclusion(from,to,RM_Landscape|RM_Water|RM_Object);
+  }
+
+void DynamicWorld::rayBatch(const RaySegment* seg, size_t count, RayBatchResult* out) const {
+  if(count==0)
+    return;
+  // broadphase must be up to date, before concurrent ray-tests
+  world->updateAabbs();
+  Workers::parallelTasks(count,[this,seg,out](size_t id){
+    auto& s = seg[id];
+    auto& r = out[id];
+    r = RayBatchResult();
+    if(s.mask & RM_Occlusion) {
+      r.occlusion = implOclusion(s.from,s.to,s.mask);
+      return;
+      }
+    static_cast<RayLandResult&>(r) = implRay(s.from,s.to,s.mask);
+    if((s.mask & RM_Npc)==0)
+      return;
+    if(auto ptr = npcList->rayTest(s.from,(r.hasCol ? r.v : s.to),1)) {
+      r.npcHit = ptr->toNpc();
+      r.hasCol = true;
+      }
+    });
+  }
+
+float DynamicWorld::implOclusion(const Tempest::Vec3& from, const Tempest::Vec3& to, uint8_t mask) const {
   struct CallBack:btCollisionWorld::AllHitsRayResultCallback {
     using AllHitsRayResultCallback::AllHitsRayResultCallback;
 
     enum { FRAC_MAX=16 };
     uint32_t           cnt            = 0;
     float              frac[FRAC_MAX] = {};
+    uint8_t            mask           = RM_Default;
 
     bool needsCollision(btBroadphaseProxy* proxy0) const override {
       auto obj=reinterpret_cast<btCollisionObject*>(proxy0->m_clientObject);
-      int id = obj->getUserIndex();
-      if(id==C_Landscape || id==C_Water || id==C_Object)
+      if(isInMask(*obj,mask))
         return AllHitsRayResultCallback::needsCollision(proxy0);
       return false;
       }
@@ -637,6 +732,7 @@ float DynamicWorld::soundOclusion(const Tempest::Vec3& from, const Tempest::Vec3
 
   CallBack callback(CollisionWorld::toMeters(from), CollisionWorld::toMeters(to));
   callback.m_flags = btTriangleRaycastCallback::kF_KeepUnflippedNormal;
+  callback.mask    = mask;
 
   world->rayCast(from,to,callback);
   if(callback.cnt<2)
@@ -686,6 +782,7 @@ DynamicWorld::Item DynamicWorld::createObj(btCollisionShape* shape, bool ownShap
     case IT_Static:
       obj = world->addCollisionBody(*shape,m,friction);
       obj->setUserIndex(C_Object);
+      linkObject(*obj,true);
       break;
     case IT_Dynamic:
       obj = world->addDynamicBody(*shape,m,friction,mass);
@@ -818,7 +915,6 @@ void DynamicWorld::moveBullet(BulletBody &b, const Tempest::Vec3& dir, uint64_t
   }
 
 void DynamicWorld::tick(uint64_t dt) {
-  npcList   ->tickAabbs();
   bulletList->tick(dt);
   world     ->tick(dt);
   }
@@ -1015,6 +1111,8 @@ bool DynamicWorld::NpcItem::hasCollision() const {
   }
 
 DynamicWorld::Item::~Item() {
+  if(obj!=nullptr && obj->getUserIndex()==C_Object)
+    owner->linkObject(*obj,false);
   delete obj;
   delete shp;
   }
@@ -1026,9 +1124,15 @@ void DynamicWorld::Item::setObjMatrix(const Tempest::Matrix4x4 &m) {
     trans.getOrigin()*=0.01f;
     if(obj->getWorldTransform()==trans)
       return;
+    // both, old and new placement, may affect cached rays
+    const bool link = (obj->getUserIndex()==C_Object);
+    if(link)
+      owner->linkObject(*obj,false);
     obj->setWorldTransform(trans);
     //owner->world->touchAabbs(); // TOO SLOW!
     owner->world->updateSingleAabb(obj);
+    if(link)
+      owner->linkObject(*obj,true);
     }
   }
 
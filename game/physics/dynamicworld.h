@@ -14,6 +14,7 @@ class btVector3;
 
 class PhysicMeshShape;
 class PhysicVbo;
+class HeightField;
 class PackedMesh;
 class Bounds;
 
@@ -24,6 +25,8 @@ class Item;
 class Interactive;
 
 class CollisionWorld;
+class LandCache;
+class LosCache;
 
 class DynamicWorld final {
   private:
@@ -32,6 +35,7 @@ class DynamicWorld final {
     struct NpcBodyList;
     struct BulletsList;
     struct BBoxList;
+    struct RayCallback;
 
   public:
     static constexpr float gravityMS   = 9.8f; // meters per second^2
@@ -40,7 +44,7 @@ class DynamicWorld final {
     static constexpr float spellSpeed  = 1; // centimeters per milliseconds
     static const     float ghostPadding;
 
-    DynamicWorld(World &world, const zenkit::Mesh& mesh);
+    DynamicWorld(World &world, const zenkit::Mesh& mesh, const LandCache& cache);
     DynamicWorld(const DynamicWorld&)=delete;
     ~DynamicWorld();
 
@@ -149,6 +153,25 @@ class DynamicWorld final {
       Npc* npcHit = nullptr;
       };
 
+    enum RayMask : uint8_t {
+      RM_Landscape = 1<<0,
+      RM_Object    = 1<<1,
+      RM_Water     = 1<<2,
+      RM_Npc       = 1<<3, // closest npc in front of static hit, as in rayNpc
+      RM_Occlusion = 1<<4, // all-hits occlusion estimate, as in soundOclusion
+      RM_Default   = RM_Landscape | RM_Object,
+      };
+
+    struct RaySegment {
+      Tempest::Vec3 from = {};
+      Tempest::Vec3 to   = {};
+      uint8_t       mask = RM_Default;
+      };
+
+    struct RayBatchResult : RayQueryResult {
+      float occlusion = 0;
+      };
+
     struct BulletCallback {
       virtual ~BulletCallback()=default;
       virtual void onStop(){}
@@ -231,7 +254,12 @@ class DynamicWorld final {
 
     RayLandResult  ray          (const Tempest::Vec3& from, const Tempest::Vec3& to) const;
     RayQueryResult rayNpc       (const Tempest::Vec3& from, const Tempest::Vec3& to) const;
+    // line of sight from observer to target, cached while both stay in place
+    bool           rayLos       (const Npc& observer, const Npc& target, const Tempest::Vec3& from, const Tempest::Vec3& to) const;
+    const LosCache& losCache() const { return *los; }
     float          soundOclusion(const Tempest::Vec3& from, const Tempest::Vec3& to) const;
+    // independent queries, executed in parallel; out[i] is result of seg[i]
+    void           rayBatch     (const RaySegment* seg, size_t count, RayBatchResult* out) const;
 
     NpcItem        ghostObj  (std::string_view visual);
     Item           staticObj (const PhysicMeshShape *src, const Tempest::Matrix4x4& m);
@@ -263,6 +291,11 @@ class DynamicWorld final {
 
     void           moveBullet(BulletBody& b, const Tempest::Vec3& dir, uint64_t dt);
     RayWaterResult implWaterRay(const Tempest::Vec3& from, const Tempest::Vec3& to) const;
+    bool           fastRay(const Tempest::Vec3& from, const Tempest::Vec3& to, RayLandResult& out) const;
+    RayLandResult  implRay(const Tempest::Vec3& from, const Tempest::Vec3& to, uint8_t mask) const;
+    float          implOclusion(const Tempest::Vec3& from, const Tempest::Vec3& to, uint8_t mask) const;
+    static bool    isInMask(const btCollisionObject& obj, uint8_t mask);
+    void           linkObject(btCollisionObject& obj, bool link);
     bool           hasCollision(const NpcItem &it, CollisionTest& out);
 
     std::unique_ptr<CollisionWorld>    world;
@@ -270,6 +303,7 @@ class DynamicWorld final {
     std::vector<std::string>           sectors;
 
     std::vector<btVector3>             landVbo;
+    std::vector<uint8_t>               landBvh, waterBvh; // in-place bvh, loaded from LandCache
     std::unique_ptr<PhysicVbo>         landMesh;
     std::unique_ptr<btCollisionShape>  landShape;
     std::unique_ptr<btRigidBody>       landBody;
@@ -278,6 +312,10 @@ class DynamicWorld final {
     std::unique_ptr<btRigidBody>       waterBody;
     std::unique_ptr<PhysicVbo>         waterMesh;
 
+    // O(1) vertical rays: ground and water layers, plus collision objects listed per cell
+    std::unique_ptr<HeightField>       landGrid, waterGrid;
+    std::unique_ptr<LosCache>          los;
+
     std::unique_ptr<NpcBodyList>       npcList;
     std::unique_ptr<BulletsList>       bulletList;
     std::unique_ptr<BBoxList>          bboxList;
@@ -0,0 +1,229 @@
+#include "heightfield.h"
+
+#include <algorithm>
+#include <cmath>
+
+HeightField::HeightField(const std::vector<btVector3>& vert)
+  :vert(vert) {
+  }
+
+void HeightField::addIndex(const std::vector<uint32_t>& index, size_t iboOff, size_t iboLen,
+                           zenkit::MaterialGroup material, const char* sector) {
+  if(iboLen==0)
+    return;
+
+  Segment sgm;
+  sgm.mat    = material;
+  sgm.sector = sector;
+  segments.push_back(sgm);
+
+  const uint32_t sId = uint32_t(segments.size()-1);
+  for(size_t i=0; i<iboLen; i+=3) {
+    // same winding as in PhysicVbo
+    Tri t;
+    t.id[0]   = index[iboOff+i+0];
+    t.id[1]   = index[iboOff+i+2];
+    t.id[2]   = index[iboOff+i+1];
+    t.segment = sId;
+    tri.push_back(t);
+    }
+  }
+
+void HeightField::build() {
+  cellOffset.clear();
+  cellTri.clear();
+  ambiguous.clear();
+  objects.clear();
+  w = 0;
+  h = 0;
+  if(tri.empty())
+    return;
+
+  float x1 = vert[tri[0].id[0]].x(), z1 = vert[tri[0].id[0]].z();
+  x0 = x1;
+  z0 = z1;
+  for(auto& t:tri)
+    for(auto i:t.id) {
+      x0 = std::min(x0,vert[i].x());
+      z0 = std::min(z0,vert[i].z());
+      x1 = std::max(x1,vert[i].x());
+      z1 = std::max(z1,vert[i].z());
+      }
+
+  w = int32_t(std::floor((x1-x0)/CellSize))+1;
+  h = int32_t(std::floor((z1-z0)/CellSize))+1;
+
+  const size_t cellCount = size_t(w)*size_t(h);
+  cellOffset.assign(cellCount+1,0);
+  ambiguous .assign(cellCount,0);
+
+  // two passes: count, then fill
+  for(int pass=0; pass<2; ++pass) {
+    for(size_t id=0; id<tri.size(); ++id) {
+      auto& t = tri[id];
+      auto& a = vert[t.id[0]];
+      auto& b = vert[t.id[1]];
+      auto& c = vert[t.id[2]];
+
+      const int32_t cx0 = clampX(std::min({a.x(),b.x(),c.x()}));
+      const int32_t cx1 = clampX(std::max({a.x(),b.x(),c.x()}));
+      const int32_t cz0 = clampZ(std::min({a.z(),b.z(),c.z()}));
+      const int32_t cz1 = clampZ(std::max({a.z(),b.z(),c.z()}));
+      for(int32_t z=cz0; z<=cz1; ++z)
+        for(int32_t x=cx0; x<=cx1; ++x) {
+          const size_t cell = size_t(z)*size_t(w)+size_t(x);
+          if(pass==0)
+            cellOffset[cell+1]++; else
+            cellTri[cellOffset[cell]++] = uint32_t(id);
+          }
+      }
+
+    if(pass==0) {
+      for(size_t i=0; i<cellCount; ++i)
+        cellOffset[i+1] += cellOffset[i];
+      cellTri.resize(cellOffset[cellCount]);
+      } else {
+      // fill-pass advanced every offset to the end of its cell
+      for(size_t i=cellCount; i>0; --i)
+        cellOffset[i] = cellOffset[i-1];
+      cellOffset[0] = 0;
+      }
+    }
+
+  for(size_t i=0; i<cellCount; ++i)
+    if(cellOffset[i+1]-cellOffset[i]>MaxLayers)
+      ambiguous[i] = 1;
+  }
+
+void HeightField::addObject(btCollisionObject& obj, const btVector3& aabbMin, const btVector3& aabbMax) {
+  if(w==0 || h==0)
+    return;
+  const int32_t cx0 = clampX(aabbMin.x()), cx1 = clampX(aabbMax.x());
+  const int32_t cz0 = clampZ(aabbMin.z()), cz1 = clampZ(aabbMax.z());
+  for(int32_t z=cz0; z<=cz1; ++z)
+    for(int32_t x=cx0; x<=cx1; ++x)
+      objects[uint32_t(z*w+x)].push_back(&obj);
+  }
+
+void HeightField::removeObject(btCollisionObject& obj, const btVector3& aabbMin, const btVector3& aabbMax) {
+  if(w==0 || h==0)
+    return;
+  // same aabb as in addObject, so same cells
+  const int32_t cx0 = clampX(aabbMin.x()), cx1 = clampX(aabbMax.x());
+  const int32_t cz0 = clampZ(aabbMin.z()), cz1 = clampZ(aabbMax.z());
+  for(int32_t z=cz0; z<=cz1; ++z)
+    for(int32_t x=cx0; x<=cx1; ++x) {
+      auto it = objects.find(uint32_t(z*w+x));
+      if(it==objects.end())
+        continue;
+      auto& c = it->second;
+      for(size_t i=0; i<c.size(); ++i)
+        if(c[i]==&obj) {
+          c[i] = c.back();
+          c.pop_back();
+          break;
+          }
+      if(c.empty())
+        objects.erase(it);
+      }
+  }
+
+auto HeightField::objectsAt(const btVector3& at) const -> const std::vector<btCollisionObject*>* {
+  int32_t cx = 0, cz = 0;
+  if(!cellOf(at.x(),at.z(),cx,cz))
+    return nullptr;
+  auto it = objects.find(uint32_t(cz*w+cx));
+  if(it==objects.end())
+    return nullptr;
+  return &it->second;
+  }
+
+HeightField::Status HeightField::rayTest(const btVector3& from, float toY, Hit& out) const {
+  out = Hit();
+
+  int32_t cx = 0, cz = 0;
+  if(!cellOf(from.x(),from.z(),cx,cz))
+    return S_Outside;
+
+  const size_t cell = size_t(cz)*size_t(w)+size_t(cx);
+  if(ambiguous[cell])
+    return S_Ambiguous;
+  if(auto obj = objects.find(uint32_t(cell)); obj!=objects.end() && obj->second.size()>MaxObjects)
+    return S_Ambiguous;
+
+  const btVector3 to(from.x(),toY,from.z());
+  float    hitFraction = 1.f;
+  uint32_t hitTri      = uint32_t(-1);
+  for(uint32_t i=cellOffset[cell]; i<cellOffset[cell+1]; ++i) {
+    auto& t     = tri[cellTri[i]];
+    auto& vert0 = vert[t.id[0]];
+    auto& vert1 = vert[t.id[1]];
+    auto& vert2 = vert[t.id[2]];
+
+    const btVector3 v10    = vert1 - vert0;
+    const btVector3 v20    = vert2 - vert0;
+    const btVector3 normal = v10.cross(v20);
+
+    const btScalar dist   = vert0.dot(normal);
+    const btScalar distA  = normal.dot(from) - dist;
+    const btScalar distB  = normal.dot(to)   - dist;
+    if(distA*distB >= btScalar(0))
+      continue;  // same side
+    if(distA <= btScalar(0))
+      continue;  // backface
+
+    const btScalar projLength = distA - distB;
+    const btScalar distance   = distA/projLength;
+    if(distance>=hitFraction)
+      continue;
+
+    const btScalar  edgeTolerance = normal.length2()*btScalar(-0.0001);
+    const btVector3 point = from.lerp(to,distance);
+    const btVector3 v0p   = vert0 - point;
+    const btVector3 v1p   = vert1 - point;
+    const btVector3 v2p   = vert2 - point;
+    if(v0p.cross(v1p).dot(normal) < edgeTolerance)
+      continue;
+    if(v1p.cross(v2p).dot(normal) < edgeTolerance)
+      continue;
+    if(v2p.cross(v0p).dot(normal) < edgeTolerance)
+      continue;
+
+    hitFraction = float(distance);
+    hitTri      = cellTri[i];
+    }
+
+  out.fraction = hitFraction;
+  if(hitTri==uint32_t(-1))
+    return S_Done;
+
+  auto& t     = tri[hitTri];
+  auto& vert0 = vert[t.id[0]];
+  out.n       = (vert[t.id[1]]-vert0).cross(vert[t.id[2]]-vert0).normalized();
+  out.v       = from.lerp(to,hitFraction);
+  out.mat     = segments[t.segment].mat;
+  out.sector  = segments[t.segment].sector;
+  out.hasCol  = true;
+  return S_Done;
+  }
+
+bool HeightField::cellOf(float x, float z, int32_t& cx, int32_t& cz) const {
+  if(w==0 || h==0)
+    return false;
+  const float fx = std::floor((x-x0)/CellSize);
+  const float fz = std::floor((z-z0)/CellSize);
+  if(fx<0 || fz<0 || fx>=float(w) || fz>=float(h))
+    return false;
+  cx = int32_t(fx);
+  cz = int32_t(fz);
+  return true;
+  }
+
+int32_t HeightField::clampX(float x) const {
+  // clamp in float domain first: object bounds might be far outside of landscape
+  return int32_t(std::clamp(std::floor((x-x0)/CellSize),0.f,float(w-1)));
+  }
+
+int32_t HeightField::clampZ(float z) const {
+  return int32_t(std::clamp(std::floor((z-z0)/CellSize),0.f,float(h-1)));
+  }
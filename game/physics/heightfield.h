@@ -0,0 +1,79 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+#include <zenkit/Material.hh>
+
+#include "physics/physics.h"
+
+// Tiled 2.5D index over a static triangle mesh, for vertical ray queries.
+// Each cell keeps every triangle, that overlaps it in xz-plane - so caves and bridges are just extra layers.
+// Collision objects are listed per cell, for caller to test them one by one.
+// Cells with too many layers or objects are ambiguous: caller must fall back to exact ray.
+// All coordinates are in meters, same as in bullet.
+class HeightField final {
+  public:
+    explicit HeightField(const std::vector<btVector3>& vert);
+
+    enum Status : uint8_t {
+      S_Done,
+      S_Outside,
+      S_Ambiguous,
+      };
+
+    struct Hit {
+      btVector3             v        = {0,0,0};
+      btVector3             n        = {0,0,0};
+      float                 fraction = 1.f;
+      zenkit::MaterialGroup mat      = zenkit::MaterialGroup::UNDEFINED;
+      const char*           sector   = nullptr;
+      bool                  hasCol   = false;
+      };
+
+    void   addIndex(const std::vector<uint32_t>& index, size_t iboOff, size_t iboLen,
+                    zenkit::MaterialGroup material, const char* sector);
+    void   build();
+    bool   isEmpty() const { return tri.empty(); }
+
+    void   addObject   (btCollisionObject& obj, const btVector3& aabbMin, const btVector3& aabbMax);
+    void   removeObject(btCollisionObject& obj, const btVector3& aabbMin, const btVector3& aabbMax);
+    // objects, whose aabb covers cell of 'at', or nullptr
+    auto   objectsAt(const btVector3& at) const -> const std::vector<btCollisionObject*>*;
+    // segment from-to must be vertical; mirrors btTriangleRaycastCallback with kF_FilterBackfaces
+    Status rayTest(const btVector3& from, float toY, Hit& out) const;
+
+  private:
+    enum {
+      MaxLayers  = 128,
+      MaxObjects = 16,
+      };
+    static constexpr float CellSize = 4.f;
+
+    struct Segment {
+      zenkit::MaterialGroup mat    = zenkit::MaterialGroup::UNDEFINED;
+      const char*           sector = nullptr;
+      };
+
+    struct Tri {
+      uint32_t id[3] = {};
+      uint32_t segment = 0;
+      };
+
+    bool   cellOf(float x, float z, int32_t& cx, int32_t& cz) const;
+    int32_t clampX(float x) const;
+    int32_t clampZ(float z) const;
+
+    const std::vector<btVector3>& vert;
+    std::vector<Tri>              tri;
+    std::vector<Segment>          segments;
+
+    float                         x0 = 0, z0 = 0;
+    int32_t                       w  = 0, h  = 0;
+    std::vector<uint32_t>         cellOffset; // CSR: triangles of cell i are cellTri[cellOffset[i]..cellOffset[i+1]]
+    std::vector<uint32_t>         cellTri;
+    std::vector<uint8_t>          ambiguous;
+    // sparse: static vobs cover small part of the map
+    std::unordered_map<uint32_t,std::vector<btCollisionObject*>> objects;
+  };
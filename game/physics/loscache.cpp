@@ -0,0 +1,153 @@
+#include "loscache.h"
+
+#include <cmath>
+#include <cstring>
+
+bool LosCache::Key::operator ==(const Key& k) const {
+  return a==k.a && b==k.b &&
+         std::memcmp(from,k.from,sizeof(from))==0 &&
+         std::memcmp(to,  k.to,  sizeof(to))==0;
+  }
+
+size_t LosCache::KeyHash::operator()(const Key& k) const {
+  uint64_t h = 14695981039346656037ull;
+  auto mix = [&h](uint64_t v) {
+    h ^= v;
+    h *= 1099511628211ull;
+    };
+  mix(reinterpret_cast<uintptr_t>(k.a));
+  mix(reinterpret_cast<uintptr_t>(k.b));
+  for(int i=0; i<3; ++i) {
+    mix(uint32_t(k.from[i]));
+    mix(uint32_t(k.to[i]));
+    }
+  return size_t(h);
+  }
+
+LosCache::Key LosCache::mkKey(const void* a, const void* b, const Tempest::Vec3& from, const Tempest::Vec3& to) {
+  Key k;
+  k.a       = a;
+  k.b       = b;
+  k.from[0] = int32_t(std::floor(from.x/Quant));
+  k.from[1] = int32_t(std::floor(from.y/Quant));
+  k.from[2] = int32_t(std::floor(from.z/Quant));
+  k.to[0]   = int32_t(std::floor(to.x/Quant));
+  k.to[1]   = int32_t(std::floor(to.y/Quant));
+  k.to[2]   = int32_t(std::floor(to.z/Quant));
+  return k;
+  }
+
+int32_t LosCache::cellOf(float v) {
+  return int32_t(std::floor(v/CellSize));
+  }
+
+uint64_t LosCache::cellKey(int32_t x, int32_t z) {
+  return (uint64_t(uint32_t(x))<<32) | uint64_t(uint32_t(z));
+  }
+
+bool LosCache::intersects(const Entry& e, const Tempest::Vec3& min, const Tempest::Vec3& max) {
+  // slab test; box is padded by quantization step, as cached ray can be off by that much
+  const float a[3] = {e.from.x, e.from.y, e.from.z};
+  const float b[3] = {e.to.x,   e.to.y,   e.to.z  };
+  const float l[3] = {min.x-Quant, min.y-Quant, min.z-Quant};
+  const float h[3] = {max.x+Quant, max.y+Quant, max.z+Quant};
+
+  float t0 = 0, t1 = 1;
+  for(int i=0; i<3; ++i) {
+    const float d = b[i]-a[i];
+    if(std::abs(d)<1e-6f) {
+      if(a[i]<l[i] || a[i]>h[i])
+        return false;
+      continue;
+      }
+    float tl = (l[i]-a[i])/d;
+    float th = (h[i]-a[i])/d;
+    if(tl>th)
+      std::swap(tl,th);
+    t0 = std::max(t0,tl);
+    t1 = std::min(t1,th);
+    if(t0>t1)
+      return false;
+    }
+  return true;
+  }
+
+bool LosCache::find(const void* a, const void* b, const Tempest::Vec3& from, const Tempest::Vec3& to, bool& visible) {
+  queries.fetch_add(1,std::memory_order_relaxed);
+
+  const Key k = mkKey(a,b,from,to);
+  std::lock_guard<std::mutex> guard(sync);
+  auto it = entries.find(k);
+  if(it==entries.end())
+    return false;
+  visible = it->second.visible;
+  hits.fetch_add(1,std::memory_order_relaxed);
+  return true;
+  }
+
+void LosCache::insert(const void* a, const void* b, const Tempest::Vec3& from, const Tempest::Vec3& to, bool visible) {
+  const Key k = mkKey(a,b,from,to);
+  std::lock_guard<std::mutex> guard(sync);
+  if(entries.size()>=MaxEntries || cellKeys>=MaxCellKeys) {
+    // moving npc leave stale cells behind; cheaper to start over, than to track age
+    entries.clear();
+    cells.clear();
+    cellKeys = 0;
+    }
+
+  auto [it,inserted] = entries.try_emplace(k);
+  it->second.visible = visible;
+  if(!inserted)
+    return;
+  it->second.from = from;
+  it->second.to   = to;
+
+  const int32_t x0 = cellOf(std::min(from.x,to.x)-Quant), x1 = cellOf(std::max(from.x,to.x)+Quant);
+  const int32_t z0 = cellOf(std::min(from.z,to.z)-Quant), z1 = cellOf(std::max(from.z,to.z)+Quant);
+  for(int32_t z=z0; z<=z1; ++z)
+    for(int32_t x=x0; x<=x1; ++x)
+      cells[cellKey(x,z)].push_back(k);
+  cellKeys += size_t(x1-x0+1)*size_t(z1-z0+1);
+  }
+
+void LosCache::invalidate(const Tempest::Vec3& min, const Tempest::Vec3& max) {
+  const int32_t x0 = cellOf(min.x-Quant), x1 = cellOf(max.x+Quant);
+  const int32_t z0 = cellOf(min.z-Quant), z1 = cellOf(max.z+Quant);
+
+  std::lock_guard<std::mutex> guard(sync);
+  if(entries.empty())
+    return;
+  for(int32_t z=z0; z<=z1; ++z)
+    for(int32_t x=x0; x<=x1; ++x) {
+      auto c = cells.find(cellKey(x,z));
+      if(c==cells.end())
+        continue;
+      auto& keys = c->second;
+      size_t n = 0;
+      for(size_t i=0; i<keys.size(); ++i) {
+        auto it = entries.find(keys[i]);
+        if(it==entries.end())
+          continue; // dropped via other cell
+        if(intersects(it->second,min,max)) {
+          entries.erase(it);
+          ++dropped;
+          continue;
+          }
+        keys[n++] = keys[i];
+        }
+      cellKeys -= keys.size()-n;
+      keys.resize(n);
+      if(keys.empty())
+        cells.erase(c);
+      }
+  }
+
+LosCache::Stats LosCache::stats() const {
+  std::lock_guard<std::mutex> guard(sync);
+  Stats s;
+  s.queries = queries.load();
+  s.hits    = hits.load();
+  s.dropped = dropped;
+  s.size    = entries.size();
+  return s;
+  }
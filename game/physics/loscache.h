@@ -0,0 +1,69 @@
+#pragma once
+
+#include <Tempest/Point>
+
+#include <unordered_map>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+
+// Line-of-sight results between pairs of observers, reused while both ends stay within one quantization cell.
+// Entries are bucketed by coarse xz-cells, so moving object drops only rays, that pass through its bounds.
+class LosCache final {
+  public:
+    LosCache() = default;
+
+    struct Stats {
+      uint64_t queries = 0;
+      uint64_t hits    = 0;
+      uint64_t dropped = 0;
+      size_t   size    = 0;
+      };
+
+    bool   find  (const void* a, const void* b, const Tempest::Vec3& from, const Tempest::Vec3& to, bool& visible);
+    void   insert(const void* a, const void* b, const Tempest::Vec3& from, const Tempest::Vec3& to, bool visible);
+    // drop every entry, that passes through box min-max (centimeters)
+    void   invalidate(const Tempest::Vec3& min, const Tempest::Vec3& max);
+
+    Stats  stats() const;
+
+  private:
+    enum {
+      MaxEntries  = 8192,
+      MaxCellKeys = MaxEntries*16,
+      };
+    static constexpr float Quant    = 25.f;   // centimeters
+    static constexpr float CellSize = 1000.f; // centimeters
+
+    struct Key {
+      const void* a = nullptr;
+      const void* b = nullptr;
+      int32_t     from[3] = {};
+      int32_t     to  [3] = {};
+      bool operator == (const Key& k) const;
+      };
+
+    struct KeyHash {
+      size_t operator()(const Key& k) const;
+      };
+
+    struct Entry {
+      Tempest::Vec3 from, to;
+      bool          visible = false;
+      };
+
+    static Key      mkKey(const void* a, const void* b, const Tempest::Vec3& from, const Tempest::Vec3& to);
+    static int32_t  cellOf(float v);
+    static uint64_t cellKey(int32_t x, int32_t z);
+    static bool     intersects(const Entry& e, const Tempest::Vec3& min, const Tempest::Vec3& max);
+
+    mutable std::mutex                                  sync;
+    std::unordered_map<Key,Entry,KeyHash>               entries;
+    std::unordered_map<uint64_t,std::vector<Key>>       cells;
+    size_t                                              cellKeys = 0;
+
+    std::atomic<uint64_t>                               queries{0};
+    std::atomic<uint64_t>                               hits{0};
+    uint64_t                                            dropped = 0;
+  };
@@ -33,6 +33,7 @@
 
 #include "gothic.h"
 #include "utils/string_frm.h"
+#include "utils/workers.h"
 
 using namespace Tempest;
 
@@ -73,9 +74,6 @@ Resources::Resources(Tempest::Device &device)
   // switch-build
   dxMusic->addPath(Gothic::nestedPath({u"_work",u"Data",u"Music"},Dir::FT_Dir));
 
-  fBuff .reserve(8*1024*1024);
-  ddsBuf.reserve(8*1024*1024);
-
   {
   Pixmap pm(1,1,TextureFormat::RGBA8);
   uint8_t* pix = reinterpret_cast<uint8_t*>(pm.data());
@@ -144,11 +142,15 @@ void Resources::loadVdfs(const std::vector<std::u16string>& modvdfs, bool modFil
   }
 
 Resources::~Resources() {
+  {
+  std::unique_lock<std::mutex> g(syncQueue);
+  queue.clear();
+  queueIdle.wait(g,[this](){ return loaders==0; });
+  }
   inst=nullptr;
   }
 
 bool Resources::hasFile(std::string_view name) {
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
   return inst->gothicAssets.find(name) != nullptr;
   }
 
@@ -283,23 +285,15 @@ int64_t Resources::vdfTimestamp(const std::u16string& name) {
     }
   }
 
-Tempest::Texture2d* Resources::implLoadTexture(TextureCache& cache, std::string_view cname) {
+std::unique_ptr<Texture2d> Resources::implLoadTexture(std::string_view cname) {
   if(cname.empty())
     return nullptr;
 
-  std::string name = std::string(cname);
-  auto it=cache.find(name);
-  if(it!=cache.end())
-    return it->second.get();
-
-  if(FileExt::hasExt(name,"TGA")) {
+  if(FileExt::hasExt(cname,"TGA")) {
+    std::string name = std::string(cname);
     name.resize(name.size() + 2);
     std::memcpy(&name[0]+name.size()-6,"-C.TEX",6);
 
-    it=cache.find(name);
-    if(it!=cache.end())
-      return it->second.get();
-
     if(const auto* entry = Resources::vdfsIndex().find(name)) {
       zenkit::Texture tex;
 
@@ -314,7 +308,7 @@ Tempest::Texture2d* Resources::implLoadTexture(TextureCache& cache, std::string_
         auto dds = zenkit::to_dds(tex);
         auto ddsRead = zenkit::Read::from(dds);
 
-        auto t = implLoadTexture(cache, std::string(cname), *ddsRead);
+        auto t = implLoadTexture(*ddsRead);
         if(t!=nullptr)
           return t;
         } else {
@@ -323,11 +317,7 @@ Tempest::Texture2d* Resources::implLoadTexture(TextureCache& cache, std::string_
         try {
           Tempest::Pixmap    pm(tex.width(), tex.height(), TextureFormat::RGBA8);
           std::memcpy(pm.data(), rgba.data(), rgba.size());
-
-          std::unique_ptr<Texture2d> t{new Texture2d(dev.texture(pm))};
-          Texture2d* ret=t.get();
-          cache[std::move(name)] = std::move(t);
-          return ret;
+          return std::make_unique<Texture2d>(dev.texture(pm));
           }
         catch (...) {
           }
@@ -337,14 +327,13 @@ Tempest::Texture2d* Resources::implLoadTexture(TextureCache& cache, std::string_
 
   if(auto* entry = Resources::vdfsIndex().find(cname)) {
     auto reader = entry->open_read();
-    return implLoadTexture(cache,std::string(cname),*reader);
+    return implLoadTexture(*reader);
     }
 
-  cache[name]=nullptr;
   return nullptr;
   }
 
-Texture2d *Resources::implLoadTexture(TextureCache& cache, std::string&& name, zenkit::Read& data) {
+std::unique_ptr<Texture2d> Resources::implLoadTexture(zenkit::Read& data) {
   try {
     std::vector<uint8_t> raw;
     data.seek(0, zenkit::Whence::END);
@@ -354,32 +343,63 @@ Texture2d *Resources::implLoadTexture(TextureCache& cache, std::string&& name, z
 
     Tempest::MemReader rd((uint8_t*)raw.data(), raw.size());
     Tempest::Pixmap    pm(rd);
-
-    std::unique_ptr<Texture2d> t{new Texture2d(dev.texture(pm))};
-    Texture2d* ret=t.get();
-    cache[std::move(name)] = std::move(t);
-    return ret;
+    return std::make_unique<Texture2d>(dev.texture(pm));
     }
   catch(...){
     return nullptr;
     }
   }
 
+template<class T, class F>
+T* Resources::implLoadOnce(std::mutex& sync, Loading& busy, std::unordered_map<std::string,std::unique_ptr<T>>& cache,
+                           std::string key, const F& load) {
+  const auto self = std::this_thread::get_id();
+  bool       own  = false;
+  {
+  std::unique_lock<std::mutex> g(sync);
+  while(true) {
+    auto it = cache.find(key);
+    if(it!=cache.end())
+      return it->second.get();
+    auto b = busy.names.find(key);
+    if(b==busy.names.end() || b->second==self)
+      break; // not in flight, or recursive load on this thread
+    busy.ready.wait(g);
+    }
+  own = busy.names.emplace(key,self).second;
+  }
+
+  std::unique_ptr<T> t;
+  try {
+    t = load();
+    }
+  catch(...) {
+    std::lock_guard<std::mutex> g(sync);
+    if(own)
+      busy.names.erase(key);
+    busy.ready.notify_all();
+    throw;
+    }
+
+  std::lock_guard<std::mutex> g(sync);
+  if(own)
+    busy.names.erase(key);
+  busy.ready.notify_all();
+  auto ins = cache.emplace(std::move(key),std::move(t));
+  return ins.first->second.get();
+  }
+
 ProtoMesh* Resources::implLoadMesh(std::string_view name) {
   if(name.size()==0)
     return nullptr;
 
   auto cname = std::string(name);
-  auto it    = aniMeshCache.find(cname);
-  if(it!=aniMeshCache.end())
-    return it->second.get();
-
-  auto  t   = implLoadMeshMain(cname);
-  auto  ret = t.get();
-  aniMeshCache[cname] = std::move(t);
-  if(ret==nullptr)
-    Log::e("unable to load mesh \"",cname,"\"");
-  return ret;
+  return implLoadOnce(syncMesh,meshLoading,aniMeshCache,cname,[this,&cname](){
+    auto t = implLoadMeshMain(cname);
+    if(t==nullptr)
+      Log::e("unable to load mesh \"",cname,"\"");
+    return t;
+    });
   }
 
 std::unique_ptr<ProtoMesh> Resources::implLoadMeshMain(std::string name) {
@@ -617,10 +637,11 @@ Tempest::Sound Resources::implLoadSoundBuffer(std::string_view name) {
   if(name.empty())
     return Tempest::Sound();
 
-  if(!getFileData(name,fBuff))
+  std::vector<uint8_t> data;
+  if(!getFileData(name,data))
     return Tempest::Sound();
   try {
-    Tempest::MemReader rd(fBuff.data(),fBuff.size());
+    Tempest::MemReader rd(data.data(),data.size());
     return Tempest::Sound(rd);
     }
   catch(...) {
@@ -697,14 +718,18 @@ GthFont &Resources::implLoadFont(std::string_view name, FontType type) {
   }
 
 const Texture2d *Resources::loadTexture(std::string_view name) {
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
-  return inst->implLoadTexture(inst->texCache,name);
+  if(name.empty())
+    return nullptr;
+
+  return inst->implLoadOnce(inst->syncTex,inst->texLoading,inst->texCache,std::string(name),[name](){
+    return inst->implLoadTexture(name);
+    });
   }
 
 const Texture2d* Resources::loadTexture(Tempest::Color color) {
   if(color==Color())
     return nullptr;
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
+  std::lock_guard<std::mutex> g(inst->syncTex);
   auto& cache = inst->pixCache;
   auto it = cache.find(color);
   if(it!=cache.end())
@@ -791,14 +816,13 @@ Material Resources::loadMaterial(const zenkit::Material& src, bool enableAlphaTe
 const ProtoMesh* Resources::loadMesh(std::string_view name) {
   if(name.size()==0)
     return nullptr;
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
   return inst->implLoadMesh(name);
   }
 
 const PfxEmitterMesh* Resources::loadEmiterMesh(std::string_view name) {
   if(name.empty())
     return nullptr;
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
+  std::lock_guard<std::mutex> g(inst->syncEmi);
   return inst->implLoadEmiterMesh(name);
   }
 
@@ -811,40 +835,32 @@ const Skeleton* Resources::loadSkeleton(std::string_view name) {
 
 const Animation* Resources::loadAnimation(std::string_view name) {
   auto cname = std::string(name);
-
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
-  auto& cache = inst->animCache;
-  auto it=cache.find(cname);
-  if(it!=cache.end())
-    return it->second.get();
-  auto t       = inst->implLoadAnimation(cname);
-  auto ret     = t.get();
-  cache[cname] = std::move(t);
-  return ret;
+  return inst->implLoadOnce(inst->syncAnim,inst->animLoading,inst->animCache,cname,[&cname](){
+    return inst->implLoadAnimation(cname);
+    });
   }
 
 Tempest::Sound Resources::loadSoundBuffer(std::string_view name) {
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
   return inst->implLoadSoundBuffer(name);
   }
 
 Dx8::PatternList Resources::loadDxMusic(std::string_view name) {
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
+  std::lock_guard<std::recursive_mutex> g(inst->syncMusic);
   return inst->implLoadDxMusic(name);
   }
 
 const ProtoMesh* Resources::decalMesh(const zenkit::VirtualObject& vob) {
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
+  std::lock_guard<std::mutex> g(inst->syncMesh);
   return inst->implDecalMesh(vob);
   }
 
 const Resources::VobTree* Resources::loadVobBundle(std::string_view name) {
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
+  std::lock_guard<std::mutex> g(inst->syncZen);
   return inst->implLoadVobBundle(name);
   }
 
 void Resources::resetRecycled(uint8_t fId) {
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
+  std::lock_guard<std::mutex> g(inst->syncRecycle);
   inst->recycledId = fId;
   inst->recycled[fId].ds.clear();
   inst->recycled[fId].ssbo.clear();
@@ -853,14 +869,14 @@ void Resources::resetRecycled(uint8_t fId) {
 void Resources::recycle(Tempest::DescriptorSet&& ds) {
   if(ds.isEmpty())
     return;
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
+  std::lock_guard<std::mutex> g(inst->syncRecycle);
   inst->recycled[inst->recycledId].ds.emplace_back(std::move(ds));
   }
 
 void Resources::recycle(Tempest::StorageBuffer&& ssbo) {
   if(ssbo.isEmpty())
     return;
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
+  std::lock_guard<std::mutex> g(inst->syncRecycle);
   inst->recycled[inst->recycledId].ssbo.emplace_back(std::move(ssbo));
   }
 
@@ -893,7 +909,7 @@ const Resources::VobTree* Resources::implLoadVobBundle(std::string_view filename
   }
 
 const AttachBinder *Resources::bindMesh(const ProtoMesh &anim, const Skeleton &s) {
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
+  std::lock_guard<std::mutex> g(inst->syncBind);
 
   if(anim.submeshId.size()==0){
     static AttachBinder empty;
@@ -911,6 +927,185 @@ const AttachBinder *Resources::bindMesh(const ProtoMesh &anim, const Skeleton &s
   return p;
   }
 
+auto Resources::loadTextureAsync(std::string_view name, Priority p) -> Async<Texture2d> {
+  if(name.empty())
+    return Async<Texture2d>();
+  return Async<Texture2d>(inst->implRequest(R_Texture,name,p));
+  }
+
+auto Resources::loadMeshAsync(std::string_view name, Priority p) -> Async<ProtoMesh> {
+  if(name.empty())
+    return Async<ProtoMesh>();
+  return Async<ProtoMesh>(inst->implRequest(R_Mesh,name,p));
+  }
+
+auto Resources::loadAnimationAsync(std::string_view name, Priority p) -> Async<Animation> {
+  if(name.empty())
+    return Async<Animation>();
+  return Async<Animation>(inst->implRequest(R_Animation,name,p));
+  }
+
+void Resources::prefetch(std::string_view name, Priority p) {
+  if(name.empty())
+    return;
+  if(FileExt::hasExt(name,"TGA")) {
+    inst->implRequest(R_Texture,name,p);
+    return;
+    }
+  if(FileExt::hasExt(name,"3DS") || FileExt::hasExt(name,"MMS") || FileExt::hasExt(name,"MMB") ||
+     FileExt::hasExt(name,"MDS") || FileExt::hasExt(name,"MDM") || FileExt::hasExt(name,"ASC") ||
+     FileExt::hasExt(name,"MDL")) {
+    inst->implRequest(R_Mesh,name,p);
+    return;
+    }
+  }
+
+const void* Resources::wait(Request& r) {
+  if(r.claimed.exchange(true,std::memory_order_acq_rel)) {
+    // someone else is decoding this request
+    r.done.wait(false,std::memory_order_acquire);
+    return r.result.load(std::memory_order_relaxed);
+    }
+  try {
+    r.result.store(implLoad(r.type,r.name),std::memory_order_relaxed);
+    }
+  catch(...) {
+    r.done.store(true,std::memory_order_release);
+    r.done.notify_all();
+    throw;
+    }
+  r.done.store(true,std::memory_order_release);
+  r.done.notify_all();
+  return r.result.load(std::memory_order_relaxed);
+  }
+
+const void* Resources::implLoad(RequestType type, std::string_view name) {
+  switch(type) {
+    case R_Texture:
+      return loadTexture(name);
+    case R_Mesh:
+      return loadMesh(name);
+    case R_Animation:
+      return loadAnimation(name);
+    }
+  return nullptr;
+  }
+
+const void* Resources::implCached(RequestType type, std::string_view name, bool& found) {
+  const std::string key = std::string(name);
+  found = false;
+  switch(type) {
+    case R_Texture: {
+      std::lock_guard<std::mutex> g(syncTex);
+      auto it = texCache.find(key);
+      if(it==texCache.end())
+        return nullptr;
+      found = true;
+      return it->second.get();
+      }
+    case R_Mesh: {
+      std::lock_guard<std::mutex> g(syncMesh);
+      auto it = aniMeshCache.find(key);
+      if(it==aniMeshCache.end())
+        return nullptr;
+      found = true;
+      return it->second.get();
+      }
+    case R_Animation: {
+      std::lock_guard<std::mutex> g(syncAnim);
+      auto it = animCache.find(key);
+      if(it==animCache.end())
+        return nullptr;
+      found = true;
+      return it->second.get();
+      }
+    }
+  return nullptr;
+  }
+
+std::shared_ptr<Resources::Request> Resources::implRequest(RequestType type, std::string_view name, Priority p) {
+  bool found = false;
+  if(auto ptr = implCached(type,name,found); found) {
+    // already loaded: complete request right away, without queue round-trip
+    auto r = std::make_shared<Request>();
+    r->name = std::string(name);
+    r->type = type;
+    r->result.store(ptr,std::memory_order_relaxed);
+    r->claimed.store(true,std::memory_order_relaxed);
+    r->done.store(true,std::memory_order_release);
+    return r;
+    }
+
+  std::string key = std::string(name);
+  key.push_back(char('0'+type));
+
+  std::lock_guard<std::mutex> g(syncQueue);
+  auto it = inFlight.find(key);
+  if(it!=inFlight.end()) {
+    auto& r = it->second;
+    if(r->done.load(std::memory_order_acquire)) {
+      inFlight.erase(it);
+      } else {
+      if(r->prio.load()<p) {
+        // re-push with higher priority; stale heap entry is skipped later
+        r->prio.store(p);
+        queue.push_back(QueueItem{p,queueSeq++,r});
+        std::push_heap(queue.begin(),queue.end());
+        }
+      return r;
+      }
+    }
+
+  auto r = std::make_shared<Request>();
+  r->name = std::string(name);
+  r->type = type;
+  r->prio.store(p);
+  inFlight[std::move(key)] = r;
+
+  queue.push_back(QueueItem{p,queueSeq++,r});
+  std::push_heap(queue.begin(),queue.end());
+
+  const uint32_t maxLoaders = std::max<uint32_t>(Workers::maxThreads()/2u,1u);
+  if(loaders<maxLoaders) {
+    ++loaders;
+    Workers::async([this](){ implDrainQueue(); });
+    }
+  return r;
+  }
+
+void Resources::implDrainQueue() {
+  while(true) {
+    std::shared_ptr<Request> r;
+    {
+    std::lock_guard<std::mutex> g(syncQueue);
+    if(queue.empty()) {
+      --loaders;
+      queueIdle.notify_all();
+      return;
+      }
+    std::pop_heap(queue.begin(),queue.end());
+    r = std::move(queue.back().req);
+    queue.pop_back();
+    }
+
+    if(r->done.load(std::memory_order_acquire))
+      continue;
+    try {
+      wait(*r);
+      }
+    catch(...) {
+      Log::e("unable to load asset \"",r->name,"\"");
+      }
+
+    std::string key = r->name;
+    key.push_back(char('0'+r->type));
+    std::lock_guard<std::mutex> g(syncQueue);
+    auto it = inFlight.find(key);
+    if(it!=inFlight.end() && it->second==r)
+      inFlight.erase(it);
+    }
+  }
+
 Tempest::VertexBuffer<Resources::Vertex> Resources::sphere(int passCount, float R){
   std::vector<Resources::Vertex> r;
   r.reserve( size_t(4*pow(3, passCount+1)) );
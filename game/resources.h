@@ -11,6 +11,11 @@
 #include <tuple>
 #include <string_view>
 #include <map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <memory>
 
 #include "graphics/material.h"
 #include "sound/soundfx.h"
@@ -30,10 +35,48 @@ class PatternList;
 }
 
 class Resources final {
+  private:
+    struct Request;
+
   public:
     explicit Resources(Tempest::Device& device);
     ~Resources();
 
+    enum class Priority : uint8_t {
+      Low,
+      Normal,
+      High,
+      };
+
+    // handle to asset, that is being decoded in background
+    template<class T>
+    class Async final {
+      public:
+        Async() = default;
+
+        bool     isReady() const { return req==nullptr || req->done.load(std::memory_order_acquire); }
+        // non-blocking: returns placeholder, until asset is ready
+        const T* get(const T* placeholder) const {
+          if(req==nullptr)
+            return placeholder;
+          if(!req->done.load(std::memory_order_acquire))
+            return placeholder;
+          return reinterpret_cast<const T*>(req->result.load(std::memory_order_relaxed));
+          }
+        // blocking: loads asset on calling thread, if not ready yet
+        const T* get() const {
+          if(req==nullptr)
+            return nullptr;
+          return reinterpret_cast<const T*>(Resources::wait(*req));
+          }
+
+      private:
+        explicit Async(std::shared_ptr<Request> r):req(std::move(r)){}
+        std::shared_ptr<Request> req;
+
+      friend class Resources;
+      };
+
     enum class FontType : uint8_t {
       Normal,
       Hi,
@@ -110,6 +153,12 @@ class Resources final {
 
     static const VobTree*            loadVobBundle(std::string_view name);
 
+    static auto                      loadTextureAsync  (std::string_view name, Priority p = Priority::Normal) -> Async<Tempest::Texture2d>;
+    static auto                      loadMeshAsync     (std::string_view name, Priority p = Priority::Normal) -> Async<ProtoMesh>;
+    static auto                      loadAnimationAsync(std::string_view name, Priority p = Priority::Normal) -> Async<Animation>;
+    // hint for background loader; asset kind is deduced from file extension
+    static void                      prefetch(std::string_view name, Priority p = Priority::Low);
+
     template<class V>
     static Tempest::VertexBuffer<V>  vbo(const V* data,size_t sz){ return inst->dev.vbo(data,sz); }
 
@@ -165,15 +214,57 @@ class Resources final {
         }
       };
 
+    enum RequestType : uint8_t {
+      R_Texture,
+      R_Mesh,
+      R_Animation,
+      };
+
+    struct Request {
+      std::string              name;
+      RequestType              type = R_Texture;
+      std::atomic<Priority>    prio{Priority::Low};
+      std::atomic<const void*> result{nullptr};
+      std::atomic_bool         claimed{false};
+      std::atomic_bool         done{false};
+      };
+
+    struct QueueItem {
+      Priority                 prio = Priority::Low;
+      uint64_t                 seq  = 0;
+      std::shared_ptr<Request> req;
+      bool operator < (const QueueItem& other) const {
+        // max-heap: higher priority first, then FIFO
+        if(prio!=other.prio)
+          return prio<other.prio;
+        return seq>other.seq;
+        }
+      };
+
+    // names, that are being decoded right now: other threads wait for the result, instead of decoding it again
+    struct Loading {
+      std::condition_variable                         ready;
+      std::unordered_map<std::string,std::thread::id> names;
+      };
+
     using TextureCache = std::unordered_map<std::string,std::unique_ptr<Tempest::Texture2d>>;
 
     int64_t               vdfTimestamp(const std::u16string& name);
     void                  detectVdf(std::vector<Archive>& ret, const std::u16string& root);
 
-    Tempest::Texture2d*   implLoadTexture(TextureCache& cache, std::string_view cname);
-    Tempest::Texture2d*   implLoadTexture(TextureCache& cache, std::string &&name, zenkit::Read& data);
+    static const void*    wait(Request& r);
+    static const void*    implLoad(RequestType type, std::string_view name);
+    const void*           implCached(RequestType type, std::string_view name, bool& found);
+    std::shared_ptr<Request> implRequest(RequestType type, std::string_view name, Priority p);
+    void                  implDrainQueue();
+
+    std::unique_ptr<Tempest::Texture2d> implLoadTexture(std::string_view cname);
+    std::unique_ptr<Tempest::Texture2d> implLoadTexture(zenkit::Read& data);
     ProtoMesh*            implLoadMesh(std::string_view name);
     std::unique_ptr<ProtoMesh> implLoadMeshMain(std::string name);
+    template<class T, class F>
+    T*                    implLoadOnce(std::mutex& sync, Loading& busy, std::unordered_map<std::string,std::unique_ptr<T>>& cache,
+                                       std::string key, const F& load);
     std::unique_ptr<Animation> implLoadAnimation(std::string name);
     ProtoMesh*            implDecalMesh(const zenkit::VirtualObject& vob);
     Tempest::Sound        implLoadSoundBuffer(std::string_view name);
@@ -213,13 +304,23 @@ class Resources final {
     Tempest::Device&                  dev;
     Tempest::SoundDevice              sound;
 
-    std::recursive_mutex              sync;
     std::unique_ptr<Dx8::DirectMusic> dxMusic;
     zenkit::Vfs                       gothicAssets;
 
-    std::vector<uint8_t>              fBuff, ddsBuf;
     Tempest::VertexBuffer<VertexFsq>  fsq;
 
+    // NOTE: decoding happens outside of cache locks; one decode per name at a time
+    std::mutex                        syncTex, syncMesh, syncEmi, syncAnim, syncBind, syncZen, syncRecycle;
+    Loading                           texLoading, meshLoading, animLoading;
+    std::recursive_mutex              syncMusic;
+
+    std::mutex                        syncQueue;
+    std::condition_variable           queueIdle;
+    std::vector<QueueItem>            queue;
+    std::unordered_map<std::string,std::shared_ptr<Request>> inFlight;
+    uint64_t                          queueSeq = 0;
+    uint32_t                          loaders  = 0;
+
     struct DeleteQueue {
       std::vector<Tempest::DescriptorSet> ds;
       std::vector<Tempest::StorageBuffer> ssbo;
@@ -976,6 +976,8 @@ void GameMenu::updateSavTitle(GameMenu::Item& sel) {
   char fname[64]={};
   std::snprintf(fname,sizeof(fname)-1,"save_slot_%d.sav",int(id));
 
+  // slot file is replaced at the end of background save
+  Gothic::inst().waitSnapshotSave();
   if(!FileUtil::exists(TextCodec::toUtf16(fname))) {
     sel.handle->text[0] = "---";
     return;
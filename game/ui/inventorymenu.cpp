@@ -207,6 +207,9 @@ void InventoryMenu::tick(uint64_t /*dt*/) {
     return;
     }
 
+  if(renderer.hasPending())
+    update();
+
   if(state==State::LockPicking) {
     if(chest->isCracked()) {
       state = State::Chest;
@@ -0,0 +1,31 @@
+#include "symbol.h"
+
+#include <mutex>
+#include <memory>
+#include <unordered_map>
+
+struct SymbolTable {
+  std::mutex                                                        sync;
+  std::unordered_map<std::string_view,std::unique_ptr<std::string>> str;
+
+  const std::string* intern(std::string_view s) {
+    std::lock_guard<std::mutex> guard(sync);
+    auto it = str.find(s);
+    if(it!=str.end())
+      return it->second.get();
+    auto p   = std::make_unique<std::string>(s);
+    auto ret = p.get();
+    str.emplace(std::string_view(*ret),std::move(p));
+    return ret;
+    }
+  };
+
+static SymbolTable& table() {
+  static SymbolTable t;
+  return t;
+  }
+
+Symbol::Symbol(std::string_view s) {
+  if(!s.empty())
+    ptr = table().intern(s);
+  }
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <functional>
+
+// interned string: equal names share storage, so compare and hash are pointer-sized
+class Symbol final {
+  public:
+    Symbol() = default;
+    explicit Symbol(std::string_view s);
+
+    std::string_view str()   const { return ptr==nullptr ? std::string_view() : std::string_view(*ptr); }
+    bool             empty() const { return ptr==nullptr; }
+
+    bool operator == (const Symbol& other) const { return ptr==other.ptr; }
+    bool operator == (std::string_view s)  const { return str()==s; }
+
+    struct Hash {
+      size_t operator()(const Symbol& s) const { return std::hash<const void*>()(s.ptr); }
+      };
+
+  private:
+    // never released; table holds vob/trigger names, which are bounded by world content
+    const std::string* ptr = nullptr;
+  };
@@ -60,24 +60,59 @@ void Workers::setThreadName(const char* threadName) { (void)threadName; }
 
 using namespace Tempest;
 
+struct Workers::TaskState : Job {
+  std::function<void()>                   func;
+  std::atomic<int32_t>                    pending{1};
+  std::atomic_bool                        queued{false};
+  std::atomic_bool                        started{false};
+  std::atomic_bool                        done{false};
+  std::mutex                              sync;
+  std::vector<std::shared_ptr<TaskState>> next;
+  std::shared_ptr<TaskState>              self;
+  };
+
+static thread_local int32_t  workerId  = -1;
+static thread_local uint32_t stealSeed = 0;
+
 const size_t Workers::taskPerThread = 128;
 const size_t Workers::taskPerStep   = 16;
 
+bool Workers::Task::isDone() const {
+  return impl==nullptr || impl->done.load(std::memory_order_acquire);
+  }
+
+void Workers::Task::wait() const {
+  if(impl==nullptr)
+    return;
+  auto& t = *impl;
+  inst().helpUntil([&t](){
+    // not picked by workers yet - run inline
+    if(t.queued.load(std::memory_order_acquire) && !t.started.exchange(true))
+      runTask(t);
+    return t.done.load(std::memory_order_acquire);
+    });
+  }
+
 Workers::Workers() {
-  size_t id=0;
-  for(auto& i:th) {
-    i = std::thread([this,id]() noexcept {
+  // pool always has one worker for async tasks, but on a single core splitting a loop is pure overhead
+  maxHelpers = maxThreads()-1u;
+  const uint32_t cnt = std::max<uint32_t>(uint32_t(maxHelpers), 1u);
+  local.reset(new Queue[cnt]);
+  th.resize(cnt);
+  for(uint32_t id=0; id<cnt; ++id) {
+    th[id] = std::thread([this,id]() noexcept {
       threadFunc(id);
       });
-    ++id;
     }
   }
 
 Workers::~Workers() {
-  running  = false;
-  workSet  = nullptr;
-  workSize = MAX_THREADS;
-  execWork(minWorkSize<void,void>());
+  running.store(false);
+  {
+  std::lock_guard<std::mutex> guard(sleepSync);
+  ++sleepEpoch;
+  }
+  sleepCnd.notify_all();
   for(auto& i:th)
     i.join();
   }
@@ -87,113 +122,282 @@ Workers &Workers::inst() {
   return w;
   }
 
-uint8_t Workers::maxThreads() {
+uint32_t Workers::maxThreads() {
   int32_t th = int32_t(std::thread::hardware_concurrency());
   if(th<=0)
     th = 1;
-  if(th>MAX_THREADS)
-    return MAX_THREADS;
-  return uint8_t(th);
+  return uint32_t(th);
   }
 
-void Workers::threadFunc(size_t id) {
+void Workers::waitAll(const std::vector<Task>& tasks) {
+  for(auto& i:tasks)
+    i.wait();
+  }
+
+void Workers::threadFunc(uint32_t id) {
   {
   string_frm tname("Workers [",int(id),"]");
   setThreadName(tname.c_str());
   }
+  workerId  = int32_t(id);
+  stealSeed = id;
 
   while(true) {
+    if(tryExecOne(true))
+      continue;
+
+    bool found = false;
+    for(int i=0; i<MAX_STEAL_SPIN && !found; ++i) {
+      std::this_thread::yield();
+      found = tryExecOne(true);
+      }
+    if(found)
+      continue;
+
+    // register as sleeper before the final check, so a concurrent push either
+    // is observed by findJob or sees sleeping>0 and bumps the epoch
+    sleeping.fetch_add(1);
+    uint64_t epoch = 0;
     {
-    std::unique_lock<std::mutex> lck(sync);
-    workWait.wait(lck, [this]() { return workTbd>0; });
-    --workTbd;
+    std::lock_guard<std::mutex> guard(sleepSync);
+    epoch = sleepEpoch;
     }
 
-    if(!running) {
-      taskDone.fetch_add(1);
+    if(Job* j = findJob(true)) {
+      sleeping.fetch_sub(1);
+      j->exec(*j);
+      continue;
+      }
+    if(!running.load()) {
+      sleeping.fetch_sub(1);
       return;
       }
 
-    if(workSet==nullptr) {
-      auto idx = progressIt.fetch_add(1);
-      workFunc(workSet+idx, 1);
-      } else {
-      taskLoop();
+    {
+    std::unique_lock<std::mutex> lck(sleepSync);
+    sleepCnd.wait(lck, [this,epoch]() { return sleepEpoch!=epoch || !running.load(); });
+    }
+    sleeping.fetch_sub(1);
+    }
+  }
+
+void Workers::push(Job* j) {
+  push(&j,1);
+  }
+
+void Workers::push(Job** j, size_t cnt) {
+  const int32_t id = workerId;
+  Queue&        q  = (id>=0 ? local[size_t(id)] : global);
+  {
+  std::lock_guard<std::mutex> guard(q.sync);
+  for(size_t i=0; i<cnt; ++i)
+    q.jobs.push_back(j[i]);
+  }
+  wakeup(cnt>1);
+  }
+
+void Workers::wakeup(bool all) {
+  if(sleeping.load()==0)
+    return;
+  {
+  std::lock_guard<std::mutex> guard(sleepSync);
+  ++sleepEpoch;
+  }
+  if(all)
+    sleepCnd.notify_all(); else
+    sleepCnd.notify_one();
+  }
+
+Workers::Job* Workers::findJob(bool withTasks) {
+  const int32_t id = workerId;
+  if(id>=0) {
+    // own queue: LIFO, to keep nested work hot in cache
+    auto& q = local[size_t(id)];
+    std::lock_guard<std::mutex> guard(q.sync);
+    if(!q.jobs.empty()) {
+      Job* j = q.jobs.back();
+      q.jobs.pop_back();
+      return j;
+      }
+    }
+
+  {
+  std::lock_guard<std::mutex> guard(global.sync);
+  if(!global.jobs.empty()) {
+    Job* j = global.jobs.front();
+    global.jobs.pop_front();
+    return j;
+    }
+  }
+
+  // steal: FIFO from other workers
+  const size_t cnt   = th.size();
+  const size_t start = stealSeed++;
+  for(size_t i=0; i<cnt; ++i) {
+    const size_t victim = (start+i)%cnt;
+    if(int32_t(victim)==id)
+      continue;
+    auto& q = local[victim];
+    std::lock_guard<std::mutex> guard(q.sync);
+    if(!q.jobs.empty()) {
+      Job* j = q.jobs.front();
+      q.jobs.pop_front();
+      return j;
+      }
+    }
+
+  if(withTasks) {
+    std::lock_guard<std::mutex> guard(tasks.sync);
+    if(!tasks.jobs.empty()) {
+      Job* j = tasks.jobs.front();
+      tasks.jobs.pop_front();
+      return j;
       }
+    }
+  return nullptr;
+  }
+
+bool Workers::tryExecOne(bool withTasks) {
+  if(Job* j = findJob(withTasks)) {
+    j->exec(*j);
+    return true;
+    }
+  return false;
+  }
 
-    taskDone.fetch_add(1);
-    // if(size_t(taskDone.fetch_add(1)+1)==taskCount)
-    //   std::this_thread::yield();
+template<class Pred>
+void Workers::helpUntil(const Pred& p) {
+  // NOTE: only parallel-for helpers - those are short
+  while(!p()) {
+    if(!tryExecOne(false))
+      std::this_thread::yield();
     }
   }
 
-uint32_t Workers::taskLoop() {
-  uint32_t count = 0;
+void Workers::forLoop(ForJob& job) {
   while(true) {
-    size_t b = size_t(progressIt.fetch_add(taskPerStep));
-    size_t e = std::min(b+taskPerStep, workSize);
-    if(e<=b)
+    const size_t b = job.progress.fetch_add(job.step);
+    if(b>=job.size)
       break;
-
-    void* d = workSet + b*workEltSize;
-    workFunc(d,e-b);
-    count += uint32_t(e-b);
+    const size_t e = std::min(b+job.step, job.size);
+    job.func(job.ctx, job.data, b, e);
     }
-  return count;
   }
 
-void Workers::execWork(uint32_t& minElts) {
-  if(workSize==0)
+void Workers::execHelper(Job& j) {
+  auto& job = *static_cast<ForHelper&>(j).owner;
+  forLoop(job);
+  // NOTE: job and helper are owned by the waiting thread - do not touch after this point
+  job.done.fetch_add(1, std::memory_order_release);
+  }
+
+void Workers::runRange(ForJob& job, size_t step, const void* ctx, RangeFn fn) {
+  job.ctx  = ctx;
+  job.func = fn;
+  job.step = step;
+  if(job.size==0)
     return;
 
-  if(workSet!=nullptr) {
-    const auto maxTheads = maxThreads();
-    taskCount = uint32_t((workSize+taskPerThread-1)/taskPerThread);
-    taskCount--; // main thread also do tasks
-    if(taskCount>maxTheads)
-      taskCount = maxTheads;
-    if(taskCount<=0)
-      taskCount = 1;
+  size_t helpers = 0;
+  if(step>1) {
+    if(job.size<=taskPerThread) {
+      fn(ctx, job.data, 0, job.size);
+      return;
+      }
+    helpers = (job.size+taskPerThread-1)/taskPerThread - 1; // calling thread also does tasks
     } else {
-    taskCount = uint32_t(workSize);
+    helpers = job.size-1;
     }
-
-  if(running && taskCount==1) {
-    workFunc(workSet, workSize);
+  helpers = std::min(helpers, maxHelpers);
+  if(helpers==0) {
+    fn(ctx, job.data, 0, job.size);
     return;
     }
+  if(step>1) {
+    // big ranges: ~8 steps per thread, instead of an atomic per taskPerStep elements
+    job.step = std::max(step, job.size/((helpers+1)*8));
+    }
+
+  ForHelper              stkHelp[32];
+  Job*                   stkPtr [32];
+  std::vector<ForHelper> heapHelp;
+  std::vector<Job*>      heapPtr;
+  ForHelper*             help = stkHelp;
+  Job**                  ptr  = stkPtr;
+  if(helpers>std::size(stkHelp)) {
+    heapHelp.resize(helpers);
+    heapPtr .resize(helpers);
+    help = heapHelp.data();
+    ptr  = heapPtr.data();
+    }
 
-  minElts = std::max<uint32_t>(minElts, taskPerThread);
+  for(size_t i=0; i<helpers; ++i) {
+    help[i].exec  = execHelper;
+    help[i].owner = &job;
+    ptr[i]        = &help[i];
+    }
+  push(ptr,helpers);
 
-  if(workSet!=nullptr && workSize<=minElts && true) {
-    workFunc(workSet, workSize);
-    if(minElts > workSize*2)
-      minElts = 0;
-    return;
+  forLoop(job);
+  helpUntil([&job,helpers](){ return job.done.load(std::memory_order_acquire)==helpers; });
+  }
+
+Workers::Task Workers::schedule(std::function<void()>&& fn, const Task* deps, size_t depsCnt) {
+  auto t  = std::make_shared<TaskState>();
+  t->exec = execTask;
+  t->func = std::move(fn);
+
+  for(size_t i=0; i<depsCnt; ++i) {
+    auto& d = deps[i].impl;
+    if(d==nullptr)
+      continue;
+    std::lock_guard<std::mutex> guard(d->sync);
+    if(d->done.load())
+      continue;
+    t->pending.fetch_add(1);
+    d->next.push_back(t);
     }
 
-  progressIt.store(0);
-  taskDone.store(0);
+  Task ret(t);
+  if(t->pending.fetch_sub(1)==1)
+    enqueue(std::move(t));
+  return ret;
+  }
 
+void Workers::enqueue(std::shared_ptr<TaskState> t) {
+  auto* j = t.get();
+  j->self = std::move(t);
   {
-  std::unique_lock<std::mutex> lck(sync);
-  workTbd = int32_t(taskCount);
+  std::lock_guard<std::mutex> guard(tasks.sync);
+  tasks.jobs.push_back(j);
+  }
+  j->queued.store(true, std::memory_order_release);
+  wakeup(false);
   }
-  workWait.notify_all();
 
-  uint32_t cnt = 0;
-  if(workSet==nullptr) {
-    std::this_thread::yield();
-    } else {
-    cnt = taskLoop(); (void)cnt;
-    }
+void Workers::execTask(Job& j) {
+  auto& t    = static_cast<TaskState&>(j);
+  auto  self = std::move(t.self);
+  if(t.started.exchange(true))
+    return; // already executed by waiting thread
+  runTask(t);
+  }
 
-  while(true) {
-    int expect = int(taskCount);
-    if(taskDone.load()==expect) {
-      taskDone.store(0);
-      break;
-      }
-    std::this_thread::yield();
+void Workers::runTask(TaskState& t) {
+  t.func();
+  t.func = nullptr;
+  inst().finish(t);
+  }
+
+void Workers::finish(TaskState& t) {
+  std::vector<std::shared_ptr<TaskState>> next;
+  {
+  std::lock_guard<std::mutex> guard(t.sync);
+  t.done.store(true, std::memory_order_release);
+  next.swap(t.next);
+  }
+  for(auto& i:next) {
+    if(i->pending.fetch_sub(1)==1)
+      enqueue(std::move(i));
     }
   }
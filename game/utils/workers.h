@@ -3,22 +3,45 @@
 #include <thread>
 #include <mutex>
 #include <vector>
+#include <deque>
+#include <memory>
 #include <functional>
 #include <atomic>
 #include <algorithm>
 #include <condition_variable>
+#include <initializer_list>
 #include <new>
 
 class Workers final {
+  private:
+    struct Job;
+    struct TaskState;
+
   public:
     Workers();
     ~Workers();
 
+    class Task final {
+      public:
+        Task() = default;
+
+        bool isValid() const { return impl!=nullptr; }
+        bool isDone()  const;
+        // waits for completion; calling thread helps with parallel-for jobs, or runs this task inline
+        void wait()    const;
+
+      private:
+        explicit Task(std::shared_ptr<TaskState> impl):impl(std::move(impl)){}
+        std::shared_ptr<TaskState> impl;
+
+      friend class Workers;
+      };
+
     static void setThreadName(const char* threadName);
 
     template<class T,class F>
     static void parallelFor(T* b, T* e, const F& func) {
-      inst().runParallelFor(b,std::distance(b,e),func);
+      inst().runParallelFor(b,size_t(std::distance(b,e)),func);
       }
 
     template<class T,class F>
@@ -36,65 +59,117 @@ class Workers final {
       inst().runParallelTasks<F>(taskCount,func);
       }
 
-    static uint8_t maxThreads();
+    // schedules func for asynchronous execution
+    template<class F>
+    static Task async(F&& func) {
+      return inst().schedule(std::function<void()>(std::forward<F>(func)),nullptr,0);
+      }
+
+    // schedules func as continuation: it runs once all of deps are finished
+    template<class F>
+    static Task async(std::initializer_list<Task> deps, F&& func) {
+      return inst().schedule(std::function<void()>(std::forward<F>(func)),deps.begin(),deps.size());
+      }
+
+    template<class F>
+    static Task async(const std::vector<Task>& deps, F&& func) {
+      return inst().schedule(std::function<void()>(std::forward<F>(func)),deps.data(),deps.size());
+      }
+
+    static void     waitAll(const std::vector<Task>& tasks);
+    static uint32_t maxThreads();
 
   private:
-    enum { MAX_THREADS=16 };
+    enum {
+      MAX_STEAL_SPIN = 64,
+      };
+
+    using RangeFn = void(*)(const void* ctx, uint8_t* data, size_t begin, size_t end);
+
+    struct Job {
+      void (*exec)(Job& self) = nullptr;
+      };
+
+    struct alignas(64) Queue {
+      std::mutex        sync;
+      std::deque<Job*>  jobs;
+      };
+
+    struct ForJob;
+    struct ForHelper : Job {
+      ForJob* owner = nullptr;
+      };
+
+    struct ForJob {
+      const void*           ctx     = nullptr;
+      RangeFn               func    = nullptr;
+      uint8_t*              data    = nullptr;
+      size_t                eltSize = 0;
+      size_t                size    = 0;
+      size_t                step    = 0;
+      std::atomic<size_t>   progress{0};
+      std::atomic<uint32_t> done{0};
+      };
 
-    void            threadFunc(size_t id);
-    void            execWork(uint32_t& minWorkSize);
-    uint32_t        taskLoop();
     static Workers& inst();
 
-    template<class T,class F>
-    static uint32_t&  minWorkSize() {
-      static uint32_t data = 0;
-      return data;
-      }
-
+    void     threadFunc(uint32_t id);
+    void     runRange(ForJob& job, size_t step, const void* ctx, RangeFn fn);
+    static void execHelper(Job& j);
+    static void execTask  (Job& j);
+    static void forLoop   (ForJob& job);
+    static void runTask   (TaskState& t);
+
+    void     push(Job* j);
+    void     push(Job** j, size_t cnt);
+    void     wakeup(bool all);
+    Job*     findJob(bool withTasks);
+    bool     tryExecOne(bool withTasks);
+    template<class Pred>
+    void     helpUntil(const Pred& p);
+
+    Task     schedule(std::function<void()>&& fn, const Task* deps, size_t depsCnt);
+    void     enqueue(std::shared_ptr<TaskState> t);
+    void     finish(TaskState& t);
 
     template<class T,class F>
     void runParallelFor(T* data, size_t sz, const F& func) {
-      workSet     = reinterpret_cast<uint8_t*>(data);
-      workSize    = sz;
-      workEltSize = sizeof(T);
-
-      workFunc = [&func](void* data, size_t sz) {
-        T* tdata = reinterpret_cast<T*>(data);
-        for(size_t i=0;i<sz;++i)
+      ForJob job;
+      job.data    = reinterpret_cast<uint8_t*>(data);
+      job.eltSize = sizeof(T);
+      job.size    = sz;
+      runRange(job, taskPerStep, &func, [](const void* ctx, uint8_t* data, size_t b, size_t e) {
+        auto& func  = *reinterpret_cast<const F*>(ctx);
+        T*    tdata = reinterpret_cast<T*>(data);
+        for(size_t i=b; i<e; ++i)
           func(tdata[i]);
-        };
-
-      execWork(minWorkSize<T,F>());
+        });
       }
 
     template<class F>
     void runParallelTasks(size_t taskCount, const F& func) {
-      workSet     = nullptr;
-      workSize    = taskCount;
-      workEltSize = 1;
-
-      workFunc = [&func](void* data, size_t sz) {
-        func(reinterpret_cast<uintptr_t>(data));
-        };
-      execWork(minWorkSize<void,F>());
+      ForJob job;
+      job.size = taskCount;
+      runRange(job, 1, &func, [](const void* ctx, uint8_t*, size_t b, size_t e) {
+        auto& func = *reinterpret_cast<const F*>(ctx);
+        for(size_t i=b; i<e; ++i)
+          func(i);
+        });
       }
 
     static const size_t               taskPerThread;
     static const size_t               taskPerStep;
-    bool                              running=true;
-
-    std::thread                       th[MAX_THREADS];
-
-    std::mutex                        sync;
-    std::condition_variable           workWait;
-    int32_t                           workTbd = 0;
-
-    uint8_t*                          workSet=nullptr;
-    size_t                            workSize=0, workEltSize=0;
-    std::function<void(void*,size_t)> workFunc;
 
-    std::atomic_int                   progressIt{0};
-    uint32_t                          taskCount = 0;
-    std::atomic_int                   taskDone{0};
+    std::atomic_bool                  running{true};
+    std::vector<std::thread>          th;
+    size_t                            maxHelpers = 0;
+    std::unique_ptr<Queue[]>          local;
+    Queue                             global;
+    // async tasks: only picked by workers, so waiting threads never get stuck in long unrelated jobs
+    Queue                             tasks;
+
+    std::mutex                        sleepSync;
+    std::condition_variable           sleepCnd;
+    std::atomic<int32_t>              sleeping{0};
+    uint64_t                          sleepEpoch = 0;
   };
@@ -22,7 +22,7 @@ CollisionZone::CollisionZone(World& w, const Tempest::Vec3& pos, const Tempest::
 
 CollisionZone::CollisionZone(CollisionZone&& other)
   : owner(other.owner), cb(std::move(other.cb)), time0(other.time0), type(other.type), pos(other.pos), size(other.size),
-    pfx(other.pfx), intersect(std::move(other.intersect)) {
+    pfx(other.pfx), moved(other.moved), intersect(std::move(other.intersect)) {
   other.owner = nullptr;
   if(owner!=nullptr) {
     owner->enableCollizionZone (*this);
@@ -43,6 +43,7 @@ CollisionZone& CollisionZone::operator =(CollisionZone&& other) {
   std::swap(pos,       other.pos);
   std::swap(size,      other.size);
   std::swap(pfx,       other.pfx);
+  std::swap(moved,     other.moved);
   std::swap(intersect, other.intersect);
 
   if(other.owner!=nullptr)
@@ -78,6 +79,15 @@ void CollisionZone::load(Serialize& fin) {
       }
   }
 
+std::pair<Tempest::Vec3,Tempest::Vec3> CollisionZone::bbox() const {
+  Tempest::Vec3 ext;
+  if(type==T_BBox)
+    ext = Tempest::Vec3(std::fabs(size.x),std::fabs(size.y),std::fabs(size.z));
+  else if(type==T_Capsule)
+    ext = Tempest::Vec3(std::fabs(size.x),std::fabs(size.y),std::fabs(size.x));
+  return {pos-ext, pos+ext};
+  }
+
 bool CollisionZone::checkPos(const Tempest::Vec3& p) const {
   auto dp = p - pos;
   if(type==T_BBox) {
@@ -130,5 +140,8 @@ void CollisionZone::setCallback(std::function<void(Npc&)> f) {
   }
 
 void CollisionZone::setPosition(const Tempest::Vec3& p) {
-  pos = p;
+  if(pos==p)
+    return;
+  moved = true;
+  pos   = p;
   }
@@ -29,6 +29,10 @@ class CollisionZone final {
 
     const std::vector<Npc*>& intersections() const { return intersect; }
 
+    // pfx zones grow over time; box zones become dynamic, once moved
+    bool          isDynamic() const { return type==T_Capsule || moved; }
+    std::pair<Tempest::Vec3,Tempest::Vec3> bbox() const;
+
     bool          checkPos(const Tempest::Vec3& pos) const;
     void          onIntersect(Npc& npc);
     void          tick(uint64_t dt);
@@ -45,6 +49,7 @@ class CollisionZone final {
     Type              type = T_BBox;
     Tempest::Vec3     pos, size;
     const ParticleFx* pfx = nullptr;
+    bool              moved = false;
 
     std::vector<Npc*> intersect;
   };
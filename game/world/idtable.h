@@ -0,0 +1,38 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+// object -> index in an owning array; rebuilt lazily after the array changes, so a save is O(N)
+class IdTable final {
+  public:
+    void invalidate() { valid = false; }
+
+    // key maps an element to the pointer it is looked up by
+    template<class T, class Key>
+    uint32_t find(const std::vector<std::unique_ptr<T>>& arr, const void* ptr, const Key& key) {
+      for(int pass=0; pass<2; ++pass) {
+        if(!valid || id.size()!=arr.size()) {
+          id.clear();
+          id.reserve(arr.size());
+          for(size_t i=0; i<arr.size(); ++i)
+            id[key(*arr[i])] = uint32_t(i);
+          valid = true;
+          }
+        auto it = id.find(ptr);
+        if(it==id.end())
+          return uint32_t(-1);
+        if(it->second<arr.size() && key(*arr[it->second])==ptr)
+          return it->second;
+        // array was reordered without invalidate
+        valid = false;
+        }
+      return uint32_t(-1);
+      }
+
+  private:
+    std::unordered_map<const void*,uint32_t> id;
+    bool                                     valid = false;
+  };
@@ -0,0 +1,115 @@
+#include "landcache.h"
+
+#include <Tempest/Log>
+#include <zenkit/Vfs.hh>
+
+#include "graphics/mesh/submesh/packedmesh.h"
+
+#include <fstream>
+#include <cstring>
+
+using namespace Tempest;
+
+static uint64_t mix(uint64_t h, uint64_t v) {
+  // 64-bit FNV-1a over 8-byte words, with extra avalanche step
+  h ^= v;
+  h *= 0x100000001b3ull;
+  h ^= (h >> 29);
+  return h;
+  }
+
+LandCache::LandCache(std::string_view world, zenkit::Read& zen)
+  :world(world) {
+  zen.seek(0, zenkit::Whence::END);
+  const size_t size = zen.tell();
+  zen.seek(0, zenkit::Whence::BEG);
+
+  std::vector<uint8_t> chunk(1024*1024);
+  uint64_t h = 0xcbf29ce484222325ull;
+  h = mix(h,size);
+  for(size_t at=0; at<size; ) {
+    const size_t sz = std::min(chunk.size(),size-at);
+    zen.read(chunk.data(),sz);
+
+    size_t i = 0;
+    for(; i+8<=sz; i+=8) {
+      uint64_t v = 0;
+      std::memcpy(&v,&chunk[i],8);
+      h = mix(h,v);
+      }
+    for(; i<sz; ++i)
+      h = mix(h,chunk[i]);
+    at += sz;
+    }
+  hash = h;
+  }
+
+bool LandCache::load(Kind k, std::vector<uint8_t>& payload, uint64_t tag) const {
+  payload.clear();
+
+  std::ifstream fin(path(k), std::ios::binary);
+  if(!fin)
+    return false;
+
+  Header hdr, ref;
+  if(!fin.read(reinterpret_cast<char*>(&hdr),sizeof(hdr)))
+    return false;
+  if(std::memcmp(hdr.magic,ref.magic,sizeof(hdr.magic))!=0 || hdr.version!=ref.version ||
+     hdr.hash!=hash || hdr.kind!=uint32_t(k) || hdr.format!=PackedMesh::CacheFormat || hdr.tag!=tag)
+    return false;
+
+  // don't trust header size: truncated or corrupted file must not cause huge allocation
+  const auto at = fin.tellg();
+  fin.seekg(0,std::ios::end);
+  const auto end = fin.tellg();
+  if(at<0 || end<at || hdr.size>uint64_t(end-at))
+    return false;
+  fin.seekg(at);
+
+  payload.resize(size_t(hdr.size));
+  if(!fin.read(reinterpret_cast<char*>(payload.data()),std::streamsize(payload.size()))) {
+    payload.clear();
+    return false;
+    }
+  return true;
+  }
+
+void LandCache::save(Kind k, const void* payload, size_t size, uint64_t tag) const {
+  std::error_code ec;
+  const auto file = path(k);
+  std::filesystem::create_directories(file.parent_path(),ec);
+
+  // write to temporary file first: partially written cache should never be observed
+  auto tmp = file;
+  tmp += ".tmp";
+  {
+  std::ofstream fout(tmp, std::ios::binary | std::ios::trunc);
+  if(!fout) {
+    Log::e("unable to write landscape cache: \"",tmp.string(),"\"");
+    return;
+    }
+  Header hdr;
+  hdr.hash   = hash;
+  hdr.size   = size;
+  hdr.kind   = k;
+  hdr.format = PackedMesh::CacheFormat;
+  hdr.tag    = tag;
+  fout.write(reinterpret_cast<const char*>(&hdr),sizeof(hdr));
+  fout.write(reinterpret_cast<const char*>(payload),std::streamsize(size));
+  if(!fout) {
+    fout.close();
+    std::filesystem::remove(tmp,ec);
+    return;
+    }
+  }
+  std::filesystem::rename(tmp,file,ec);
+  if(ec)
+    std::filesystem::remove(tmp,ec);
+  }
+
+std::filesystem::path LandCache::path(Kind k) const {
+  static const char* ext[] = {".vis", ".phy", ".bvh", ".wbvh"};
+  std::string name = world;
+  name += ext[k];
+  return std::filesystem::path("cache") / name;
+  }
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <filesystem>
+
+namespace zenkit {
+class Read;
+}
+
+// On-disk cache for landscape data, that depends only on content of zen-file.
+// Entries are keyed by content hash of zen-file, format version of cache and of PackedMesh, and optional caller tag;
+// stale or broken entries are ignored.
+// Payload is stored 16-byte aligned right after the header, so it can be used in place.
+class LandCache final {
+  public:
+    enum Kind : uint8_t {
+      K_VisualMesh,
+      K_PhysicMesh,
+      K_LandBvh,
+      K_WaterBvh,
+      };
+
+    LandCache(std::string_view world, zenkit::Read& zen);
+
+    // tag: caller-defined check value, for data derived from other cached data
+    bool     load(Kind k, std::vector<uint8_t>& payload, uint64_t tag = 0) const;
+    void     save(Kind k, const void* payload, size_t size, uint64_t tag = 0) const;
+
+    uint64_t contentHash() const { return hash; }
+
+  private:
+    enum {
+      Version = 2,
+      };
+
+    struct Header {
+      char     magic[4] = {'O','G','L','C'};
+      uint32_t version  = Version;
+      uint64_t hash     = 0;
+      uint64_t size     = 0;
+      uint32_t kind     = 0;
+      uint32_t format   = 0;
+      uint64_t tag      = 0;
+      uint64_t padding  = 0;
+      };
+
+    std::filesystem::path path(Kind k) const;
+
+    std::string world;
+    uint64_t    hash = 0;
+  };
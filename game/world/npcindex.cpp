@@ -0,0 +1,84 @@
+#include "npcindex.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "world/objects/npc.h"
+
+void NpcIndex::build(const std::unique_ptr<Npc>* npc, size_t count) {
+  ent.resize(count);
+  for(size_t i=0; i<count; ++i) {
+    auto p = npc[i]->position();
+    ent[i].cell = cellKey(cellCoord(p.x),cellCoord(p.z));
+    ent[i].npc  = npc[i].get();
+    }
+  // stable: keep npc order within a cell, so queries are deterministic
+  std::stable_sort(ent.begin(),ent.end(),[](const Entry& a, const Entry& b){
+    return a.cell<b.cell;
+    });
+
+  cells.clear();
+  for(size_t i=0; i<ent.size(); ) {
+    size_t e = i+1;
+    while(e<ent.size() && ent[e].cell==ent[i].cell)
+      ++e;
+    cells[ent[i].cell] = Range{uint32_t(i),uint32_t(e)};
+    i = e;
+    }
+  valid = true;
+  }
+
+uint64_t NpcIndex::cellKey(int32_t x, int32_t z) {
+  const uint32_t ux = uint32_t(x)+0x80000000u;
+  const uint32_t uz = uint32_t(z)+0x80000000u;
+  return (uint64_t(ux) << 32) | uint64_t(uz);
+  }
+
+int32_t NpcIndex::cellCoord(float v) {
+  return int32_t(std::floor(v/CellSize));
+  }
+
+template<class F>
+void NpcIndex::forEachCandidate(const Tempest::Vec3& p, float R, const F& f) const {
+  const float   ext = R+MaxDrift;
+  const int32_t x0  = cellCoord(p.x-ext), x1 = cellCoord(p.x+ext);
+  const int32_t z0  = cellCoord(p.z-ext), z1 = cellCoord(p.z+ext);
+  for(int32_t z=z0; z<=z1; ++z)
+    for(int32_t x=x0; x<=x1; ++x) {
+      auto c = cells.find(cellKey(x,z));
+      if(c==cells.end())
+        continue;
+      for(uint32_t i=c->second.begin; i<c->second.end; ++i)
+        f(*ent[i].npc);
+      }
+  }
+
+void NpcIndex::implFind(const Tempest::Vec3& p, float R, const void* ctx, void (*func)(const void*, Npc&)) const {
+  const float maxDist = R*R;
+  forEachCandidate(p,R,[&](Npc& n){
+    if((n.position()-p).quadLength()<maxDist)
+      func(ctx,n);
+    });
+  }
+
+Npc* NpcIndex::implFindNearest(const Tempest::Vec3& p, float R, const void* ctx, bool (*pred)(const void*, Npc&)) const {
+  struct Candidate {
+    float dist = 0;
+    Npc*  npc  = nullptr;
+    };
+
+  const float            maxDist = R*R;
+  std::vector<Candidate> cand;
+  forEachCandidate(p,R,[&](Npc& n){
+    const float d = (n.position()-p).quadLength();
+    if(d<maxDist)
+      cand.push_back({d,&n});
+    });
+  std::stable_sort(cand.begin(),cand.end(),[](const Candidate& a, const Candidate& b){
+    return a.dist<b.dist;
+    });
+  for(auto& i:cand)
+    if(pred(ctx,*i.npc))
+      return i.npc;
+  return nullptr;
+  }
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <unordered_map>
+#include <Tempest/Point>
+
+class Npc;
+
+// Uniform grid over npc positions, rebuilt once per world tick.
+// Queries test current positions, so npcs moving in between rebuilds are found,
+// as long as they didn't travel further than MaxDrift.
+class NpcIndex final {
+  public:
+    NpcIndex() = default;
+
+    static constexpr float MaxDrift = 500.f;
+
+    void   build(const std::unique_ptr<Npc>* npc, size_t count);
+    void   invalidate() { valid = false; }
+    bool   isValid() const { return valid; }
+
+    template<class F>
+    void   find(const Tempest::Vec3& p, float R, const F& f) const {
+      implFind(p,R,&f,[](const void* ctx, Npc& n){
+        auto& f = *reinterpret_cast<const F*>(ctx);
+        f(n);
+        });
+      }
+
+    // nearest npc within R, that satisfies predicate; candidates are tested in order of distance
+    template<class F>
+    Npc*   findNearest(const Tempest::Vec3& p, float R, const F& pred) const {
+      return implFindNearest(p,R,&pred,[](const void* ctx, Npc& n) -> bool {
+        auto& f = *reinterpret_cast<const F*>(ctx);
+        return f(n);
+        });
+      }
+
+  private:
+    static constexpr float CellSize = 1000.f;
+
+    struct Entry {
+      uint64_t cell = 0;
+      Npc*     npc  = nullptr;
+      };
+
+    struct Range {
+      uint32_t begin = 0;
+      uint32_t end   = 0;
+      };
+
+    static uint64_t cellKey(int32_t x, int32_t z);
+    static int32_t  cellCoord(float v);
+
+    template<class F>
+    void   forEachCandidate(const Tempest::Vec3& p, float R, const F& f) const;
+
+    void   implFind(const Tempest::Vec3& p, float R, const void* ctx, void (*func)(const void*, Npc&)) const;
+    Npc*   implFindNearest(const Tempest::Vec3& p, float R, const void* ctx, bool (*pred)(const void*, Npc&)) const;
+
+    std::vector<Entry>                  ent;
+    std::unordered_map<uint64_t,Range>  cells;
+    bool                                valid = false;
+  };
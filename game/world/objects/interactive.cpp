@@ -203,8 +203,8 @@ void Interactive::setVisual(const zenkit::VirtualObject& vob) {
   setAnim(Interactive::Active); // setup default anim
   }
 
-void Interactive::updateAnimation(uint64_t dt) {
-  if(visual.updateAnimation(nullptr,world,dt))
+void Interactive::updateAnimation(uint64_t dt, bool sample) {
+  if(visual.updateAnimation(nullptr,world,dt,sample))
     animChanged = true;
   }
 
@@ -22,6 +22,14 @@ using namespace Tempest;
 
 static std::string_view humansTorchOverlay = "_TORCH.MDS";
 
+// senses are tested against bbox center, not against npc pivot
+static const float SenseSearchExt = 500.f;
+
+// same set, as WorldObjects::npcNear: only npcs close to player are part of perception
+static bool isNear(const Npc& n) {
+  return n.processPolicy()==Npc::AiNormal || n.processPolicy()==Npc::Player;
+  }
+
 void Npc::GoTo::save(Serialize& fout) const {
   fout.write(npc, uint8_t(flag), wp, pos);
   }
@@ -360,6 +368,10 @@ void Npc::loadTrState(Serialize& fin) {
 bool Npc::setPosition(float ix, float iy, float iz) {
   if(x==ix && y==iy && z==iz)
     return false;
+  // teleport: npc index only tolerates small drift in between rebuilds
+  const float dx = ix-x, dy = iy-y, dz = iz-z;
+  if(dx*dx+dy*dy+dz*dz>NpcIndex::MaxDrift*NpcIndex::MaxDrift)
+    owner.invalidateNpcIndex();
   x = ix;
   y = iy;
   z = iz;
@@ -1712,7 +1724,7 @@ bool Npc::implAiFlee(uint64_t dt) {
   const WayPoint* wp      = nullptr;
   const float     maxDist = 5*100; // 5 meters
 
-  owner.findWayPoint(position(),[&](const WayPoint& p) {
+  owner.findWayPoint(position(),maxDist,[&](const WayPoint& p) {
     if(p.useCounter()>0 || qDistTo(&p)>maxDist*maxDist)
       return false;
     if(p.underWater)
@@ -1926,16 +1938,14 @@ Npc *Npc::updateNearestEnemy() {
     dist = qDistTo(*ret);
     }
 
-  owner.detectNpcNear([this,&ret,&dist](Npc& n){
-    if(!isEnemy(n) || n.isDown() || &n==this)
-      return;
-
-    float d = qDistTo(n);
-    if(d<dist && canSenseNpc(n,true)!=SensesBit::SENSE_NONE) {
-      ret  = &n;
-      dist = d;
-      }
+  const float r   = float(hnpc->senses_range)+SenseSearchExt;
+  Npc*        enm = owner.findNearestNpc(position(),r,[this,dist](Npc& n){
+    if(!isNear(n) || !isEnemy(n) || n.isDown() || &n==this)
+      return false;
+    return qDistTo(n)<dist && canSenseNpc(n,true)!=SensesBit::SENSE_NONE;
     });
+  if(enm!=nullptr)
+    ret = enm;
   nearestEnemy = ret;
   return nearestEnemy;
   }
@@ -1944,20 +1954,10 @@ Npc* Npc::updateNearestBody() {
   if(aiPolicy!=ProcessPolicy::AiNormal)
     return nullptr;
 
-  Npc*  ret  = nullptr;
-  float dist = std::numeric_limits<float>::max();
-
-  owner.detectNpcNear([this,&ret,&dist](Npc& n){
-    if(!n.isDead())
-      return;
-
-    float d = qDistTo(n);
-    if(d<dist && canSenseNpc(n,true)!=SensesBit::SENSE_NONE) {
-      ret  = &n;
-      dist = d;
-      }
+  const float r = float(hnpc->senses_range)+SenseSearchExt;
+  return owner.findNearestNpc(position(),r,[this](Npc& n){
+    return isNear(n) && n.isDead() && canSenseNpc(n,true)!=SensesBit::SENSE_NONE;
     });
-  return ret;
   }
 
 void Npc::tickTimedEvt(Animation::EvCount& ev) {
@@ -4154,10 +4154,10 @@ void Npc::stopWalking() {
 
 bool Npc::canSeeNpc(const Npc &oth, bool freeLos) const {
   const auto mid = oth.bounds().midTr;
-  if(canSeeNpc(mid,freeLos))
+  if(canRayHitPoint(mid,freeLos,0,&oth))
     return true;
   const auto ppos = oth.physic.position();
-  if(oth.isDown() && canSeeNpc(ppos,freeLos)) {
+  if(oth.isDown() && canRayHitPoint(ppos,freeLos,0,&oth)) {
     // mid of dead npc may endedup inside a wall; extra check for physical center
     return true;
     }
@@ -4166,7 +4166,7 @@ bool Npc::canSeeNpc(const Npc &oth, bool freeLos) const {
   if(oth.visual.visualSkeleton()->BIP01_HEAD==size_t(-1))
     return false;
   auto head = oth.visual.mapHeadBone();
-  if(canSeeNpc(head,freeLos))
+  if(canRayHitPoint(head,freeLos,0,&oth))
     return true;
   return false;
   }
@@ -4185,7 +4185,7 @@ bool Npc::canSeeNpc(const Vec3 pos, bool freeLos) const {
   return canRayHitPoint(pos, freeLos);
   }
 
-bool Npc::canRayHitPoint(const Tempest::Vec3 pos, bool freeLos, float extRange) const {
+bool Npc::canRayHitPoint(const Tempest::Vec3 pos, bool freeLos, float extRange, const Npc* oth) const {
   const float range = float(hnpc->senses_range) + extRange;
   if(qDistTo(pos)>range*range)
     return false;
@@ -4194,15 +4194,20 @@ bool Npc::canRayHitPoint(const Tempest::Vec3 pos, bool freeLos, float extRange)
   const DynamicWorld* w   = owner.physic();
   // npc eyesight height
   auto head = visual.mapHeadBone();
-  if(freeLos) {
+  auto los  = [&]() {
+    if(oth!=nullptr)
+      return w->rayLos(*this,*oth,head,pos);
     return !w->ray(head, pos).hasCol;
+    };
+  if(freeLos) {
+    return los();
     }
 
   float dx  = x-pos.x, dz=z-pos.z;
   float dir = angleDir(dx,dz);
   float da  = float(M_PI)*(visual.viewDirection()-dir)/180.f;
   if(double(std::cos(da))<=ref) {
-    if(!w->ray(head, pos).hasCol)
+    if(los())
       return true;
     }
   return false;
@@ -4213,10 +4218,10 @@ SensesBit Npc::canSenseNpc(const Npc &oth, bool freeLos, float extRange) const {
   const auto st      = oth.bodyStateMasked();
   // https://github.com/Try/OpenGothic/pull/589#issuecomment-2045897394
   const bool isNoisy = (st!=BodyState::BS_SNEAK && oth.isPlayer());
-  return canSenseNpc(mid,freeLos,isNoisy,extRange);
+  return canSenseNpc(mid,freeLos,isNoisy,extRange,&oth);
   }
 
-SensesBit Npc::canSenseNpc(const Tempest::Vec3 pos, bool freeLos, bool isNoisy, float extRange) const {
+SensesBit Npc::canSenseNpc(const Tempest::Vec3 pos, bool freeLos, bool isNoisy, float extRange, const Npc* oth) const {
   const float range = float(hnpc->senses_range)+extRange;
   if(qDistTo(pos)>range*range)
     return SensesBit::SENSE_NONE;
@@ -4228,7 +4233,7 @@ SensesBit Npc::canSenseNpc(const Tempest::Vec3 pos, bool freeLos, bool isNoisy,
     ret = ret | SensesBit::SENSE_HEAR;
     }
 
-  if((hnpc->senses & int32_t(SensesBit::SENSE_SEE))!=0 && canRayHitPoint(pos, freeLos, extRange)) {
+  if((hnpc->senses & int32_t(SensesBit::SENSE_SEE))!=0 && canRayHitPoint(pos, freeLos, extRange, oth)) {
     ret = ret | SensesBit::SENSE_SEE;
     }
 
@@ -4317,7 +4322,7 @@ void Npc::updateTransform() {
   updateAnimation(0);
   }
 
-void Npc::updateAnimation(uint64_t dt) {
+void Npc::updateAnimation(uint64_t dt, bool sample, size_t maxLayers) {
   const auto camera = Gothic::inst().camera();
   if(isPlayer() && camera!=nullptr && camera->isFree())
     dt = 0;
@@ -4350,7 +4355,7 @@ void Npc::updateAnimation(uint64_t dt) {
     durtyTranform = 0;
     }
 
-  bool syncAtt = visual.updateAnimation(this,owner,dt);
+  bool syncAtt = visual.updateAnimation(this,owner,dt,sample,maxLayers);
   if(syncAtt)
     visual.syncAttaches();
   }
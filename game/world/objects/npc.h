@@ -130,7 +130,7 @@ class Npc final {
     float      qDistTo(const Interactive& p) const;
     float      qDistTo(const Item& p) const;
 
-    void       updateAnimation(uint64_t dt);
+    void       updateAnimation(uint64_t dt, bool sample = true, size_t maxLayers = size_t(-1));
     void       updateTransform();
 
     std::string_view displayName() const;
@@ -377,10 +377,10 @@ class Npc final {
     bool      canSeeNpc(const Tempest::Vec3 pos, bool freeLos) const;
     bool      canSeeItem(const Item& it, bool freeLos) const;
     bool      canSeeSource() const;
-    bool      canRayHitPoint(const Tempest::Vec3 pos, bool freeLos = true, float extRange=0.f) const;
+    bool      canRayHitPoint(const Tempest::Vec3 pos, bool freeLos = true, float extRange=0.f, const Npc* oth=nullptr) const;
 
     auto      canSenseNpc(const Npc& oth, bool freeLos, float extRange=0.f) const -> SensesBit;
-    auto      canSenseNpc(const Tempest::Vec3 pos, bool freeLos, bool isNoisy, float extRange=0.f) const -> SensesBit;
+    auto      canSenseNpc(const Tempest::Vec3 pos, bool freeLos, bool isNoisy, float extRange=0.f, const Npc* oth=nullptr) const -> SensesBit;
 
     void      setTarget(Npc* t);
     Npc*      target() const;
@@ -114,7 +114,7 @@ void Vob::recalculateTransform() {
       case zenkit::VirtualObjectType::oCMobSwitch:
       case zenkit::VirtualObjectType::oCMobLadder:
       case zenkit::VirtualObjectType::oCMobWheel:
-        world.invalidateVobIndex();
+        world.invalidateVobIndex(*this);
         break;
       default:
         break;
@@ -53,7 +53,10 @@ class Vob {
 
     Tempest::Matrix4x4                pos, local;
     Vob*                              parent = nullptr;
+    uint32_t                          indexSlot = uint32_t(-1);
 
     void          recalculateTransform();
+
+  friend class BaseSpaceIndex;
   };
 
@@ -1,132 +1,131 @@
 #include "spaceindex.h"
 
+#include <cmath>
+
 #include "world/objects/vob.h"
 
 void BaseSpaceIndex::clear() {
+  // NOTE: objects might be already deleted - stale indexSlot is rejected by indexOf
   arr.clear();
-  index.clear();
-  dynamic.clear();
-  }
-
-void BaseSpaceIndex::invalidate() {
-  index.clear();
+  ent.clear();
+  cells.clear();
   dynamic.clear();
   }
 
 void BaseSpaceIndex::add(Vob* v) {
+  const uint32_t slot = uint32_t(arr.size());
+  v->indexSlot = slot;
   arr.push_back(v);
-  index.reserve(arr.size());
-  index.clear();
-  dynamic.clear();
+  ent.emplace_back();
+  link(slot);
   }
 
 void BaseSpaceIndex::del(Vob* v) {
-  for(size_t i=0;i<arr.size();++i) {
-    if(arr[i]==v) {
-      arr[i] = arr.back();
-      arr.pop_back();
-      index.clear();
-      dynamic.clear();
-      return;
-      }
+  const uint32_t slot = indexOf(v);
+  if(slot==uint32_t(-1))
+    return;
+
+  unlink(slot);
+  const uint32_t last = uint32_t(arr.size()-1);
+  if(slot!=last) {
+    // move last object into the freed slot
+    const Entry e = ent[last];
+    arr[slot] = arr[last];
+    ent[slot] = e;
+    arr[slot]->indexSlot = slot;
+    if(e.cell==NoCell)
+      dynamic[e.inCell] = slot; else
+      bucket(e.cell)[e.inCell] = slot;
     }
+  arr.pop_back();
+  ent.pop_back();
+  v->indexSlot = uint32_t(-1);
+  }
+
+void BaseSpaceIndex::refit(Vob* v) {
+  const uint32_t slot = indexOf(v);
+  if(slot==uint32_t(-1))
+    return;
+  const uint64_t cell = v->isDynamic() ? NoCell : cellOf(v);
+  if(cell==ent[slot].cell)
+    return;
+  unlink(slot);
+  link(slot);
   }
 
 bool BaseSpaceIndex::hasObject(const Vob* v) const {
+  return indexOf(v)!=uint32_t(-1);
+  }
+
+uint32_t BaseSpaceIndex::indexOf(const Vob* v) const {
   if(v==nullptr)
-    return false;
-  for(size_t i=0;i<arr.size();++i)
-    if(arr[i]==v)
-      return true;
-  return false;
+    return uint32_t(-1);
+  const uint32_t slot = v->indexSlot;
+  if(slot<arr.size() && arr[slot]==v)
+    return slot;
+  return uint32_t(-1);
   }
 
 void BaseSpaceIndex::find(const Tempest::Vec3& p, float R, const void* ctx, void (*func)(const void*, Vob*)) {
-  if(index.size()==0)
-    buildIndex();
-  for(auto& i:dynamic)
-    (*func)(ctx,i);
-  implFind(index.data(),index.size(),0,p,R,ctx,func);
-  }
+  for(auto i:dynamic)
+    (*func)(ctx,arr[i]);
 
-void BaseSpaceIndex::buildIndex() {
-  size_t cnt = 0;
-  index.resize(arr.size());
-  dynamic.clear();
-  for(size_t i=0; i<arr.size(); ++i) {
-    if(arr[i]->isDynamic()) {
-      dynamic.push_back(arr[i]);
-      } else {
-      index[cnt] = arr[i];
-      ++cnt;
+  const float   qR = (R+675.f);//v->extendedSearchRadius());
+  const int32_t x0 = cellCoord(p.x-qR), x1 = cellCoord(p.x+qR);
+  const int32_t z0 = cellCoord(p.z-qR), z1 = cellCoord(p.z+qR);
+
+  for(int32_t z=z0; z<=z1; ++z)
+    for(int32_t x=x0; x<=x1; ++x) {
+      auto b = cells.find(cellKey(x,z));
+      if(b==cells.end())
+        continue;
+      for(auto i:b->second) {
+        Vob* v = arr[i];
+        if((v->position()-p).quadLength()<=qR*qR)
+          func(ctx,v);
+        }
       }
-    }
-  index.resize(cnt);
-  buildIndex(index.data(),index.size(),0);
   }
 
-void BaseSpaceIndex::buildIndex(Vob** v, size_t cnt, uint8_t depth) {
-  depth%=3;
-  sort(v,cnt,depth);
-  size_t mid = cnt/2;
-  if(mid>0) {
-    // [0..mid)
-    buildIndex(v,mid,uint8_t(depth+1u));
-    }
-  if(mid+1<cnt) {
-    // (mid..cnt)
-    buildIndex(v+mid+1,cnt-mid-1,uint8_t(depth+1u));
-    }
+uint64_t BaseSpaceIndex::cellKey(int32_t x, int32_t z) {
+  // biased, so cell (-1,-1) doesn't alias NoCell
+  const uint32_t ux = uint32_t(x)+0x80000000u;
+  const uint32_t uz = uint32_t(z)+0x80000000u;
+  return (uint64_t(ux) << 32) | uint64_t(uz);
   }
 
-void BaseSpaceIndex::sort(Vob** v, size_t cnt, uint8_t component) {
-  bool (*predicate)(const Vob* a, const Vob* b) = nullptr;
-  switch(component) {
-    case 0:
-      predicate = [](const Vob* a, const Vob* b){ return a->position().x < b->position().x; };
-      break;
-    case 1:
-      predicate = [](const Vob* a, const Vob* b){ return a->position().y < b->position().y; };
-      break;
-    case 2:
-      predicate = [](const Vob* a, const Vob* b){ return a->position().z < b->position().z; };
-      break;
-    }
-  std::sort(v,v+cnt,predicate);
+int32_t BaseSpaceIndex::cellCoord(float v) {
+  return int32_t(std::floor(v/CellSize));
   }
 
-void BaseSpaceIndex::implFind(Vob** v, size_t cnt, uint8_t depth,
-                              const Tempest::Vec3& p, float R, const void* ctx, void (*func)(const void*, Vob*)) {
-  if(cnt==0)
-    return;
+uint64_t BaseSpaceIndex::cellOf(const Vob* v) const {
+  auto p = v->position();
+  return cellKey(cellCoord(p.x),cellCoord(p.z));
+  }
 
-  auto mid = cnt/2;
-  auto pos = v[mid]->position();
-  auto qR  = (R+675.0);//v[mid]->extendedSearchRadius());
+std::vector<uint32_t>& BaseSpaceIndex::bucket(uint64_t cell) {
+  return cells[cell];
+  }
 
-  if((pos-p).quadLength()<=qR*qR) {
-    func(ctx,v[mid]);
-    }
+void BaseSpaceIndex::link(uint32_t slot) {
+  auto& e = ent[slot];
+  e.cell  = arr[slot]->isDynamic() ? NoCell : cellOf(arr[slot]);
 
-  depth%=3;
-  switch(depth) {
-    case 0:
-      if(p.x-qR<=pos.x)
-        implFind(v,mid,uint8_t(depth+1u),p,R, ctx,func);
-      if(p.x+qR>=pos.x)
-        implFind(v+mid+1,cnt-mid-1,uint8_t(depth+1u),p,R, ctx,func);
-      break;
-    case 1:
-      if(p.y-qR<=pos.y)
-        implFind(v,mid,uint8_t(depth+1u),p,R, ctx,func);
-      if(p.y+qR>=pos.y)
-        implFind(v+mid+1,cnt-mid-1,uint8_t(depth+1u),p,R, ctx,func);
-      break;
-    case 2:
-      if(p.z-qR<=pos.z)
-        implFind(v,mid,uint8_t(depth+1u),p,R, ctx,func);
-      if(p.z+qR>=pos.z)
-        implFind(v+mid+1,cnt-mid-1,uint8_t(depth+1u),p,R, ctx,func);
-      break;
-    }
+  auto& b = (e.cell==NoCell) ? dynamic : bucket(e.cell);
+  e.inCell = uint32_t(b.size());
+  b.push_back(slot);
+  }
+
+void BaseSpaceIndex::unlink(uint32_t slot) {
+  auto& e  = ent[slot];
+  auto  it = (e.cell==NoCell) ? cells.end() : cells.find(e.cell);
+  auto& b  = (e.cell==NoCell) ? dynamic     : it->second;
+
+  const uint32_t moved = b.back();
+  b[e.inCell] = moved;
+  ent[moved].inCell = e.inCell;
+  b.pop_back();
+  // drop empty cells, so map doesn't keep every cell an object has passed through
+  if(b.empty() && it!=cells.end())
+    cells.erase(it);
   }
@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <array>
 #include <memory>
+#include <unordered_map>
 #include <Tempest/Point>
 
 #include "utils/workers.h"
@@ -15,13 +16,14 @@ class BaseSpaceIndex {
   public:
     void   clear();
     size_t size() const { return arr.size(); }
-    void   invalidate();
+    void   refit(Vob* v);
 
   protected:
     BaseSpaceIndex() = default;
     void               add(Vob* v);
     void               del(Vob* v);
     bool               hasObject(const Vob* v) const;
+    uint32_t           indexOf(const Vob* v) const;
 
     void               find(const Tempest::Vec3& p, float R, const void* ctx, void (*func)(const void*, Vob*));
     template<class Func>
@@ -30,14 +32,26 @@ class BaseSpaceIndex {
     Vob*const*         data() const { return arr.data(); }
 
   private:
-    std::vector<Vob*>  arr;
-    std::vector<Vob*>  index;
-    std::vector<Vob*>  dynamic;
-
-    void               buildIndex();
-    void               buildIndex(Vob** v, size_t cnt, uint8_t depth);
-    void               sort(Vob** v, size_t cnt, uint8_t component);
-    void               implFind(Vob** v, size_t cnt, uint8_t depth, const Tempest::Vec3& p, float R, const void* ctx, void(*func)(const void*, Vob*));
+    // loose grid in xz-plane; objects are bucketed by their pivot
+    static constexpr float    CellSize = 1024.f;
+    static constexpr uint64_t NoCell   = uint64_t(-1);
+
+    struct Entry {
+      uint64_t cell   = NoCell; // NoCell - object is dynamic
+      uint32_t inCell = 0;
+      };
+
+    std::vector<Vob*>                                 arr;
+    std::vector<Entry>                                ent;
+    std::unordered_map<uint64_t,std::vector<uint32_t>> cells;
+    std::vector<uint32_t>                             dynamic;
+
+    static uint64_t    cellKey(int32_t x, int32_t z);
+    static int32_t     cellCoord(float v);
+    uint64_t           cellOf(const Vob* v) const;
+    void               link  (uint32_t slot);
+    void               unlink(uint32_t slot);
+    std::vector<uint32_t>& bucket(uint64_t cell);
   };
 
 template<class Func>
@@ -63,6 +77,10 @@ class SpaceIndex final : public BaseSpaceIndex {
       return BaseSpaceIndex::hasObject(v);
       }
 
+    uint32_t indexOf(const T* v) const {
+      return BaseSpaceIndex::indexOf(v);
+      }
+
     T**       begin()        { return reinterpret_cast<T**>(data()); }
     T**       end()          { return begin()+size();                }
 
@@ -82,4 +100,3 @@ class SpaceIndex final : public BaseSpaceIndex {
       BaseSpaceIndex::parallelFor([&func](Vob* v){ func(*reinterpret_cast<T*>(v)); });
       }
   };
-
@@ -33,7 +33,7 @@ AbstractTrigger::AbstractTrigger(Vob* parent, World &world, const zenkit::Virtua
     fireDelay          = uint64_t(trigger.fire_delay_sec*1000.f);
     retriggerDelay     = uint64_t(trigger.retrigger_delay_sec*1000.f);
     maxActivationCount = (data.type==VirtualObjectType::zCMover && trigger.max_activation_count!=0) ? uint32_t(-1) : uint32_t(trigger.max_activation_count);
-    target             = trigger.target;
+    target             = Symbol(trigger.target);
     disabled           = !trigger.start_enabled;
     sendUntrigger      = trigger.send_untrigger;
     reactToOnTrigger   = trigger.react_to_on_trigger;
@@ -49,7 +49,7 @@ AbstractTrigger::AbstractTrigger(Vob* parent, World &world, const zenkit::Virtua
 AbstractTrigger::~AbstractTrigger() {}
 
 std::string_view AbstractTrigger::name() const {
-  return vobName;
+  return vobName.str();
   }
 
 bool AbstractTrigger::isEnabled() const {
@@ -221,13 +221,16 @@ void AbstractTrigger::Cb::onCollide(DynamicWorld::BulletBody& b) {
   }
 
 void TriggerEvent::save(Serialize& fout) const {
-  fout.write(target,emitter,uint8_t(type),timeBarrier);
+  fout.write(target.str(),emitter.str(),uint8_t(type),timeBarrier);
   if(type==T_Move)
     fout.write(uint8_t(move.msg),move.key);
   }
 
 void TriggerEvent::load(Serialize& fin) {
-  fin.read(target,emitter,reinterpret_cast<uint8_t&>(type),timeBarrier);
+  std::string tg, em;
+  fin.read(tg,em,reinterpret_cast<uint8_t&>(type),timeBarrier);
+  target  = Symbol(tg);
+  emitter = Symbol(em);
   if(type==T_Move)
     fin.read(reinterpret_cast<uint8_t&>(move.msg),move.key);
   }
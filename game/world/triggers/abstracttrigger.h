@@ -7,6 +7,7 @@
 #include "world/objects/vob.h"
 #include "world/collisionzone.h"
 #include "physics/dynamicworld.h"
+#include "utils/symbol.h"
 
 class Npc;
 class World;
@@ -26,15 +27,19 @@ class TriggerEvent final {
       };
 
     TriggerEvent()=default;
-    TriggerEvent(std::string target, std::string emitter, Type type):target(std::move(target)), emitter(std::move(emitter)), type(type){}
-    TriggerEvent(std::string target, std::string emitter, uint64_t t, Type type)
-      :target(std::move(target)), emitter(std::move(emitter)),type(type),timeBarrier(t){}
+    TriggerEvent(Symbol target, Symbol emitter, Type type):target(target), emitter(emitter), type(type){}
+    TriggerEvent(Symbol target, Symbol emitter, uint64_t t, Type type)
+      :target(target), emitter(emitter),type(type),timeBarrier(t){}
+    TriggerEvent(std::string_view target, std::string_view emitter, Type type)
+      :TriggerEvent(Symbol(target),Symbol(emitter),type){}
+    TriggerEvent(std::string_view target, std::string_view emitter, uint64_t t, Type type)
+      :TriggerEvent(Symbol(target),Symbol(emitter),t,type){}
 
     void              save(Serialize& fout) const;
     void              load(Serialize &fin);
 
-    std::string       target;
-    std::string       emitter;
+    Symbol            target;
+    Symbol            emitter;
     Type              type        = T_Trigger;
     uint64_t          timeBarrier = 0;
     struct {
@@ -105,6 +110,6 @@ class AbstractTrigger : public Vob {
     bool                         ticksEnabled = false;
 
   protected:
-    std::string                  vobName;
-    std::string                  target;
+    Symbol                       vobName;
+    Symbol                       target;
   };
@@ -7,14 +7,16 @@
 
 CodeMaster::CodeMaster(Vob* parent, World &world, const zenkit::VCodeMaster& cm, Flags flags)
   :AbstractTrigger(parent,world,cm,flags), keys(cm.slaves.size()) {
-  target              = cm.target;
-  slaves              = cm.slaves;
+  target              = Symbol(cm.target);
   ordered             = cm.ordered;
   firstFalseIsFailure = cm.first_false_is_failure;
-  failureTarget       = cm.failure_target;
+  failureTarget       = Symbol(cm.failure_target);
+  slaves.reserve(cm.slaves.size());
+  for(auto& i:cm.slaves)
+    slaves.emplace_back(i);
   untriggeredCancels  = cm.untriggered_cancels;
   if(untriggeredCancels)
-    Tempest::Log::d("zCCodeMaster::untriggeredCancels is not implemented. Vob: \"", vobName, "\"");
+    Tempest::Log::d("zCCodeMaster::untriggeredCancels is not implemented. Vob: \"", vobName.str(), "\"");
   }
 
 void CodeMaster::onTrigger(const TriggerEvent &evt) {
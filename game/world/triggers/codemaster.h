@@ -19,11 +19,11 @@ class CodeMaster : public AbstractTrigger {
     void zeroState();
 
     std::vector<bool>        keys;
-    std::vector<std::string> slaves;
+    std::vector<Symbol>      slaves;
     uint32_t                 count               = 0;
     bool                     ordered             = false;
     bool                     firstFalseIsFailure = false;
-    std::string              failureTarget;
+    Symbol                   failureTarget;
     bool                     untriggeredCancels  = false;
   };
 
@@ -4,7 +4,7 @@
 
 MessageFilter::MessageFilter(Vob* parent, World &world, const zenkit::VMessageFilter& filt, Flags flags)
   :AbstractTrigger(parent,world,filt,flags) {
-  target = filt.target;
+  target = Symbol(filt.target);
   onUntriggerA = filt.on_untrigger;
   onTriggerA = filt.on_trigger;
   }
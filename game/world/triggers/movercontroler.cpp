@@ -4,7 +4,7 @@
 
 MoverControler::MoverControler(Vob* parent, World &world, const zenkit::VMoverController& ctrl, Flags flags)
   :AbstractTrigger(parent,world,ctrl,flags) {
-  target = ctrl.target;
+  target = Symbol(ctrl.target);
   message = ctrl.message;
   key = uint32_t(ctrl.key);
   }
@@ -9,7 +9,9 @@ using namespace Tempest;
 
 TriggerList::TriggerList(Vob* parent, World &world, const zenkit::VTriggerList& list, Flags flags)
   :AbstractTrigger(parent,world,list,flags) {
-  targets = list.targets;
+  targets.reserve(list.targets.size());
+  for(auto& i:list.targets)
+    targets.push_back({Symbol(i.name),i.delay});
   listProcess = list.mode;
   }
 
@@ -21,7 +21,12 @@ class TriggerList : public AbstractTrigger {
       LP_NEXT = 1,
       LP_RAND = 2
       };
+    struct Target {
+      Symbol name;
+      float  delay = 0;
+      };
+
     uint32_t next=0;
-    std::vector<zenkit::VTriggerList::Target> targets;
+    std::vector<Target>                       targets;
     zenkit::TriggerBatchMode                  listProcess;
   };
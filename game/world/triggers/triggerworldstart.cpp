@@ -7,7 +7,7 @@
 TriggerWorldStart::TriggerWorldStart(Vob* parent, World &world, const zenkit::VTriggerWorldStart& trg, Flags flags)
   :AbstractTrigger(parent,world,trg,flags){
   fireOnlyFirstTime = trg.fire_once;
-  target = trg.target;
+  target = Symbol(trg.target);
   }
 
 void TriggerWorldStart::onTrigger(const TriggerEvent &ev) {
@@ -3,6 +3,7 @@
 #include <Tempest/Log>
 #include <algorithm>
 #include <limits>
+#include <cmath>
 
 #include "utils/dbgpainter.h"
 #include "utils/versioninfo.h"
@@ -26,8 +27,6 @@ WayMatrix::WayMatrix(World &world, const zenkit::WayNet& dat)
     }
 
   edges = dat.edges;
-  stk[0].reserve(256);
-  stk[1].reserve(256);
   }
 
 void WayMatrix::buildIndex() {
@@ -39,12 +38,12 @@ void WayMatrix::buildIndex() {
     return a->name<b->name;
     });
 
-  for(auto& i:freePoints)
-    fpInd.push_back(&i);
-
-  std::sort(fpInd.begin(),fpInd.end(),[](const WayPoint* a,const WayPoint* b){
-    return a->x<b->x;
-    });
+  std::vector<const WayPoint*> pt;
+  pt.reserve(wayPoints.size());
+  for(auto& i:wayPoints)
+    pt.push_back(&i);
+  wayIndex.build(std::move(pt));
+  nextIndex.build(std::vector<const WayPoint*>(indexPoints.begin(),indexPoints.end()));
 
   for(auto& i:edges) {
     if(i.a<wayPoints.size() && i.b<wayPoints.size()) {
@@ -56,47 +55,16 @@ void WayMatrix::buildIndex() {
       }
     }
 
+  buildAdjacency();
   calculateLadderPoints();
-  }
-
-const WayPoint *WayMatrix::findWayPoint(const Vec3& at, const std::function<bool(const WayPoint&)>& filter) const {
-  const WayPoint* ret =nullptr;
-  float           dist=std::numeric_limits<float>::max();
-  for(auto& w:wayPoints) {
-    if(!filter(w))
-      continue;
-    auto  dp0 = at-w.position();
-    float l0  = dp0.quadLength();
-
-    if(l0<dist){
-      ret  = &w;
-      dist = l0;
-      }
-    }
-  return ret;
-  }
-
-const WayPoint *WayMatrix::findFreePoint(const Vec3& at, std::string_view name, const std::function<bool(const WayPoint&)>& filter) const {
-  auto&  index = findFpIndex(name);
-  return findFreePoint(at.x,at.y,at.z,index,filter);
+  invalidatePathCache();
   }
 
 const WayPoint *WayMatrix::findNextPoint(const Vec3& at) const {
-  const WayPoint* ret   = nullptr;
-  float           dist  = distanceThreshold;
-
-  dist*=dist;
-  for(auto pw:indexPoints){
-    auto& w  = *pw;
-    auto  dp = w.position()-at;
-    float l  = dp.quadLength();
-
-    if(l<dist && dp.z*dp.z<300*300 && !w.isLocked()){
-      ret  = &w;
-      dist = l;
-      }
-    }
-  return ret;
+  return nextIndex.findNearest(at,distanceThreshold,[&at](const WayPoint& w){
+    const float dz = w.z-at.z;
+    return dz*dz<300*300 && !w.isLocked();
+    });
   }
 
 void WayMatrix::addFreePoint(const Vec3& pos, const Vec3& dir, std::string_view name) {
@@ -230,64 +198,216 @@ void WayMatrix::calculateLadderPoints() {
   }
 
 const WayMatrix::FpIndex &WayMatrix::findFpIndex(std::string_view name) const {
-  auto it = std::lower_bound(fpIndex.begin(),fpIndex.end(),name,[](FpIndex& l, std::string_view r){
-    return l.key<r;
+  std::lock_guard<std::mutex> guard(fpSync);
+  auto it = std::lower_bound(fpIndex.begin(),fpIndex.end(),name,[](const std::unique_ptr<FpIndex>& l, std::string_view r){
+    return l->key<r;
     });
-  if(it!=fpIndex.end() && it->key==name){
-    return *it;
+  if(it!=fpIndex.end() && (*it)->key==name){
+    return **it;
     }
 
-  FpIndex id;
-  id.key = name;
+  auto id = std::make_unique<FpIndex>();
+  id->key = name;
+  std::vector<const WayPoint*> pt;
   for(auto& w:freePoints){
     if(!w.checkName(name))
       continue;
-    id.index.push_back(&w);
+    pt.push_back(&w);
     }
-  // TODO: good index, not sort by 'x' :)
-  std::sort(id.index.begin(),id.index.end(),[](const WayPoint* a,const WayPoint* b){
-    return a->x<b->x;
-    });
+  id->index.build(std::move(pt));
 
   it = fpIndex.insert(it,std::move(id));
-  return *it;
+  return **it;
   }
 
-const WayPoint *WayMatrix::findFreePoint(float x, float y, float z, const FpIndex& ind,
-                                         const std::function<bool(const WayPoint&)>& filter) const {
-  float R = distanceThreshold;
-  auto b = std::lower_bound(ind.index.begin(),ind.index.end(), x-R ,[](const WayPoint *a, float b){
-    return a->x<b;
-    });
-  auto e = std::upper_bound(ind.index.begin(),ind.index.end(), x+R ,[](float a,const WayPoint *b){
-    return a<b->x;
-    });
+void WayMatrix::buildAdjacency() {
+  adjOffset.resize(wayPoints.size()+1);
+  adjEdges.clear();
+  for(size_t i=0; i<wayPoints.size(); ++i) {
+    auto& w = wayPoints[i];
+    adjOffset[i] = uint32_t(adjEdges.size());
+    for(auto& c:w.connections()) {
+      Edge e;
+      e.to  = pointId(c.point);
+      e.len = (c.point->position()-w.position()).length();
+      adjEdges.push_back(e);
+      }
+    }
+  adjOffset[wayPoints.size()] = uint32_t(adjEdges.size());
+  }
 
-  const WayPoint* ret=nullptr;
-  auto  count = std::distance(b,e);(void) count;
-  float dist  = R*R;
-  for(auto i=b;i!=e;++i){
-    auto& w  = **i;
-    float dx = w.x-x;
-    float dy = w.y-y;
-    float dz = w.z-z;
-    float l  = dx*dx+dy*dy+dz*dz;
-    if(l>dist || dz*dz>300*300)
-      continue;
-    if(!filter(w))
-      continue;
-    ret  = &w;
-    dist = l;
+uint32_t WayMatrix::pointId(const WayPoint* p) const {
+  if(wayPoints.empty())
+    return uint32_t(-1);
+  intptr_t id = std::distance<const WayPoint*>(&wayPoints[0],p);
+  if(id<0 || size_t(id)>=wayPoints.size())
+    return uint32_t(-1);
+  return uint32_t(id);
+  }
+
+void WayMatrix::invalidatePathCache() {
+  std::lock_guard<std::mutex> guard(cacheSync);
+  cacheLru.clear();
+  cacheMap.clear();
+  }
+
+uint64_t WayMatrix::pathKey(uint32_t begin, uint32_t end) {
+  return (uint64_t(begin) << 32) | uint64_t(end);
+  }
+
+uint64_t WayMatrix::pathKey(const uint32_t* begin, size_t beginSz, const int32_t* at, uint32_t end) {
+  // FNV-1a; collisions are resolved by comparing the stored candidate set and start cell
+  uint64_t h = 0xcbf29ce484222325ull ^ end;
+  for(size_t i=0; i<beginSz; ++i) {
+    h ^= begin[i];
+    h *= 0x100000001b3ull;
     }
-  return ret;
+  for(size_t i=0; i<3; ++i) {
+    h ^= uint32_t(at[i]);
+    h *= 0x100000001b3ull;
+    }
+  return h;
+  }
+
+bool WayMatrix::findCached(uint64_t key, const uint32_t* begin, size_t beginSz, const int32_t* at, CachedPath& out) const {
+  static const int32_t zero[3] = {};
+  if(at==nullptr)
+    at = zero;
+
+  std::lock_guard<std::mutex> guard(cacheSync);
+  auto it = cacheMap.find(key);
+  if(it==cacheMap.end())
+    return false;
+  auto& c = *it->second;
+  if(c.begin.size()!=beginSz || !std::equal(c.begin.begin(),c.begin.end(),begin) ||
+     !std::equal(c.at,c.at+3,at))
+    return false;
+  cacheLru.splice(cacheLru.begin(),cacheLru,it->second);
+  out = c;
+  return true;
+  }
+
+void WayMatrix::storeCached(uint64_t key, const uint32_t* begin, size_t beginSz, const int32_t* at,
+                            float len, const std::vector<uint32_t>& nodes) const {
+  std::lock_guard<std::mutex> guard(cacheSync);
+  if(auto it = cacheMap.find(key); it!=cacheMap.end()) {
+    // replace colliding entry
+    cacheLru.erase(it->second);
+    cacheMap.erase(it);
+    }
+  if(cacheLru.size()>=PathCacheSize) {
+    cacheMap.erase(cacheLru.back().key);
+    cacheLru.pop_back();
+    }
+  CachedPath c;
+  c.key   = key;
+  c.len   = len;
+  c.begin = std::vector<uint32_t>(begin,begin+beginSz);
+  c.nodes = nodes;
+  if(at!=nullptr)
+    std::copy(at,at+3,c.at);
+  cacheLru.push_front(std::move(c));
+  cacheMap[key] = cacheLru.begin();
+  }
+
+bool WayMatrix::findPath(const uint32_t* begin, size_t beginSz, const Tempest::Vec3& exactBegin, uint32_t end,
+                         float bound, std::vector<uint32_t>& nodes, float& len) const {
+  // A* from 'end' towards exactBegin, where each of begin points is connected to exactBegin by straight line.
+  // Heuristic is distance to exactBegin; edge costs are euclidean, so it's consistent.
+  // Only paths shorter than bound are reported.
+  struct Node {
+    float    f   = 0;
+    uint32_t id  = 0;
+    bool operator < (const Node& other) const { return f>other.f; }
+    };
+
+  struct Scratch {
+    std::vector<float>    g;
+    std::vector<uint32_t> parent;
+    std::vector<uint32_t> gen;
+    std::vector<uint32_t> goal;
+    std::vector<Node>     open;
+    uint32_t              curGen = 0;
+    };
+  static thread_local Scratch scratch;
+
+  auto& sc = scratch;
+  if(sc.g.size()<wayPoints.size()) {
+    sc.g     .resize(wayPoints.size());
+    sc.parent.resize(wayPoints.size());
+    sc.gen   .resize(wayPoints.size(),0);
+    sc.goal  .resize(wayPoints.size(),0);
+    }
+  sc.curGen++;
+  if(sc.curGen==0) {
+    std::fill(sc.gen .begin(),sc.gen .end(),0);
+    std::fill(sc.goal.begin(),sc.goal.end(),0);
+    sc.curGen = 1;
+    }
+  const uint32_t gen = sc.curGen;
+  for(size_t i=0; i<beginSz; ++i)
+    sc.goal[begin[i]] = gen;
+
+  auto heuristic = [&](uint32_t id) {
+    return (wayPoints[id].position()-exactBegin).length();
+    };
+
+  sc.open.clear();
+  sc.g[end]      = 0;
+  sc.parent[end] = uint32_t(-1);
+  sc.gen[end]    = gen;
+  sc.open.push_back(Node{heuristic(end),end});
+
+  float    bestLen = bound;
+  uint32_t best    = uint32_t(-1);
+  while(!sc.open.empty()) {
+    std::pop_heap(sc.open.begin(),sc.open.end());
+    const Node n = sc.open.back();
+    sc.open.pop_back();
+    if(n.f>=bestLen)
+      break;
+
+    const float g = sc.g[n.id];
+    if(n.f>g+heuristic(n.id))
+      continue; // stale entry
+
+    if(sc.goal[n.id]==gen) {
+      const float total = g+heuristic(n.id);
+      if(total<bestLen) {
+        bestLen = total;
+        best    = n.id;
+        }
+      }
+
+    for(uint32_t i=adjOffset[n.id]; i<adjOffset[n.id+1]; ++i) {
+      auto&       e  = adjEdges[i];
+      const float g1 = g+e.len;
+      if(sc.gen[e.to]==gen && sc.g[e.to]<=g1)
+        continue;
+      sc.g[e.to]      = g1;
+      sc.parent[e.to] = n.id;
+      sc.gen[e.to]    = gen;
+      sc.open.push_back(Node{g1+heuristic(e.to),e.to});
+      std::push_heap(sc.open.begin(),sc.open.end());
+      }
+    }
+
+  if(best==uint32_t(-1))
+    return false;
+
+  nodes.clear();
+  for(uint32_t i=best; i!=uint32_t(-1); i=sc.parent[i])
+    nodes.push_back(i);
+  len = sc.g[best];
+  return true;
   }
 
 WayPath WayMatrix::wayTo(const WayPoint** begin, size_t beginSz, const Tempest::Vec3 exactBegin, const WayPoint& end) const {
   if(beginSz==0)
     return WayPath();
 
-  intptr_t endId = std::distance<const WayPoint*>(&wayPoints[0],&end);
-  if(endId<0 || size_t(endId)>=wayPoints.size()){
+  const uint32_t endId = pointId(&end);
+  if(endId==uint32_t(-1)) {
     if(end.name.find("FP_")==0) {
       WayPath ret;
       ret.add(end);
@@ -296,75 +416,72 @@ WayPath WayMatrix::wayTo(const WayPoint** begin, size_t beginSz, const Tempest::
     return WayPath();
     }
 
-  pathGen++;
-  if(pathGen==1){
-    // new cycle
-    for(auto& i:wayPoints)
-      i.pathGen=0;
+  uint32_t  beginStk[16] = {};
+  std::vector<uint32_t> beginHeap;
+  uint32_t* beginId = beginStk;
+  if(beginSz>std::size(beginStk)) {
+    beginHeap.resize(beginSz);
+    beginId = beginHeap.data();
     }
+  size_t beginCnt = 0;
+  for(size_t i=0; i<beginSz; ++i) {
+    auto id = pointId(begin[i]);
+    if(id!=uint32_t(-1))
+      beginId[beginCnt++] = id;
+    }
+  if(beginCnt==0)
+    return WayPath();
 
-  std::vector<const WayPoint*> *front=&stk[0], *back=&stk[1];
-  stk[0].clear();
-  stk[1].clear();
-
-  end.pathLen = 0;
-  end.pathGen = pathGen;
-  front->push_back(&end);
-
-  while(front->size()>0) {
-    bool done = true;
-    for(size_t i=0; i<beginSz; ++i)
-      if(begin[i]->pathGen!=pathGen) {
-        done = false;
-        break;
+  // best start depends on exact position: key by candidate set and start cell
+  const int32_t at[3] = {
+    int32_t(std::floor(exactBegin.x/PathCacheQuant)),
+    int32_t(std::floor(exactBegin.y/PathCacheQuant)),
+    int32_t(std::floor(exactBegin.z/PathCacheQuant)),
+    };
+  std::sort(beginId,beginId+beginCnt);
+  const uint64_t setKey = pathKey(beginId,beginCnt,at,endId);
+
+  CachedPath            cached;
+  std::vector<uint32_t> nodes;
+  if(findCached(setKey,beginId,beginCnt,at,cached)) {
+    nodes = std::move(cached.nodes);
+    } else {
+    const std::vector<uint32_t> beginSet(beginId,beginId+beginCnt);
+
+    // exact path length is known for cached candidates; A* runs only over the rest
+    float  bestLen  = std::numeric_limits<float>::max();
+    float  graphLen = 0;
+    size_t uncached = 0;
+    for(size_t i=0; i<beginCnt; ++i) {
+      const uint32_t id = beginId[i];
+      if(!findCached(pathKey(id,endId),nullptr,0,nullptr,cached)) {
+        beginId[uncached++] = id;
+        continue;
         }
-    if(done)
-      break;
-
-    for(auto& wp:*front) {
-      int32_t l0 = wp->pathLen;
-
-      for(auto i:wp->connections()){
-        auto& w  = *i.point;
-        int32_t l1 = l0+i.len;
-        if(w.pathGen!=pathGen || w.pathLen>l1){
-          w.pathLen = l1;
-          w.pathGen = pathGen;
-          back->push_back(&w);
-          }
+      const float total = cached.len + (exactBegin-wayPoints[id].position()).length();
+      if(total<bestLen) {
+        bestLen  = total;
+        graphLen = cached.len;
+        nodes    = std::move(cached.nodes);
         }
       }
-    std::swap(front,back);
-    back->clear();
-    }
-
-  const WayPoint* first = begin[0];
-  for(size_t i=0; i<beginSz; ++i) {
-    int32_t iLen = begin[i]->pathLen + int((exactBegin - begin[i]->position()).length());
-    int32_t fLen = first   ->pathLen + int((exactBegin - first   ->position()).length());
-    if(iLen<fLen)
-      first = begin[i];
-    }
 
-  WayPath ret;
-  ret.add(*first);
-  const WayPoint* current = first;
-  while(current!=&end) {
-    int32_t l0 = current->pathLen, l1=l0;
-
-    const WayPoint* next=nullptr;
-    for(auto i:current->connections()){
-      if(i.point->pathGen==pathGen && i.point->pathLen+i.len<=l0 && i.point->pathLen<l1){
-        next = i.point;
-        l1   = i.point->pathLen;
-        }
+    std::vector<uint32_t> found;
+    float                 len = 0;
+    if(uncached>0 && findPath(beginId,uncached,exactBegin,endId,bestLen,found,len)) {
+      storeCached(pathKey(found.front(),endId),nullptr,0,nullptr,len,found);
+      nodes    = std::move(found);
+      graphLen = len;
       }
-    if(next==nullptr)
+    if(nodes.empty())
       return WayPath();
-    ret.add(*next);
-    current=next;
+
+    storeCached(setKey,beginSet.data(),beginSet.size(),at,graphLen,nodes);
     }
 
+  WayPath ret;
+  for(auto i:nodes)
+    ret.add(wayPoints[i]);
   ret.reverse();
   return ret;
   }
@@ -7,9 +7,15 @@
 
 #include <vector>
 #include <functional>
+#include <unordered_map>
+#include <list>
+#include <mutex>
+#include <memory>
+#include <limits>
 
 #include "waypath.h"
 #include "waypoint.h"
+#include "waypointindex.h"
 
 class World;
 class DbgPainter;
@@ -18,8 +24,12 @@ class WayMatrix final {
   public:
     WayMatrix(World& owner, const zenkit::WayNet& dat);
 
-    const WayPoint* findWayPoint (const Tempest::Vec3& at, const std::function<bool(const WayPoint&)>& filter) const;
-    const WayPoint* findFreePoint(const Tempest::Vec3& at, std::string_view name, const std::function<bool(const WayPoint&)>& filter) const;
+    template<class F>
+    const WayPoint* findWayPoint (const Tempest::Vec3& at, const F& filter) const;
+    template<class F>
+    const WayPoint* findWayPoint (const Tempest::Vec3& at, float maxDist, const F& filter) const;
+    template<class F>
+    const WayPoint* findFreePoint(const Tempest::Vec3& at, std::string_view name, const F& filter) const;
     const WayPoint* findNextPoint(const Tempest::Vec3& at) const;
 
     void            addFreePoint (const Tempest::Vec3& pos, const Tempest::Vec3& dir, std::string_view name);
@@ -33,8 +43,26 @@ class WayMatrix final {
     void            marchPoints(DbgPainter& p) const;
 
     WayPath         wayTo(const WayPoint** begin, size_t beginSz, const Tempest::Vec3 exactBegin, const WayPoint& end) const;
+    void            invalidatePathCache();
 
   private:
+    struct Edge {
+      uint32_t to  = 0;
+      float    len = 0;
+      };
+
+    struct CachedPath {
+      uint64_t              key = 0;
+      float                 len = 0;
+      std::vector<uint32_t> begin; // sorted candidate set; empty for single-point entries
+      int32_t               at[3] = {}; // quantized exact start of candidate-set entries
+      std::vector<uint32_t> nodes; // begin..end
+      };
+    using CacheIterator = std::list<CachedPath>::iterator;
+
+    static constexpr size_t PathCacheSize = 1024;
+    static constexpr float  PathCacheQuant = 100.f; // centimeters
+
     World&                 world;
     float                  distanceThreshold = 20.f*100.f;
 
@@ -44,21 +72,57 @@ class WayMatrix final {
     std::vector<WayPoint>  freePoints, startPoints;
     std::vector<WayPoint*> indexPoints;
 
-    std::vector<WayPoint*> fpInd;
+    WayPointIndex          wayIndex;  // wayPoints only
+    WayPointIndex          nextIndex; // wayPoints, freePoints and startPoints
 
     struct FpIndex {
       std::string                  key;
-      std::vector<const WayPoint*> index;
+      WayPointIndex                index;
       };
-    mutable std::vector<FpIndex>          fpIndex;
+    mutable std::mutex                            fpSync;
+    mutable std::vector<std::unique_ptr<FpIndex>> fpIndex;
+
+    // waynet graph in CSR form: edges of point i are adjEdges[adjOffset[i]..adjOffset[i+1])
+    std::vector<uint32_t>  adjOffset;
+    std::vector<Edge>      adjEdges;
 
-    mutable uint16_t                      pathGen=0;
-    mutable std::vector<const WayPoint*>  stk[2];
+    mutable std::mutex                                  cacheSync;
+    mutable std::list<CachedPath>                       cacheLru;
+    mutable std::unordered_map<uint64_t,CacheIterator>  cacheMap;
 
     void                   adjustWaypoints(std::vector<WayPoint> &wp);
     void                   calculateLadderPoints();
+    void                   buildAdjacency();
+
+    uint32_t               pointId(const WayPoint* p) const;
+    static uint64_t        pathKey(uint32_t begin, uint32_t end);
+    static uint64_t        pathKey(const uint32_t* begin, size_t beginSz, const int32_t* at, uint32_t end);
+    bool                   findCached(uint64_t key, const uint32_t* begin, size_t beginSz, const int32_t* at, CachedPath& out) const;
+    void                   storeCached(uint64_t key, const uint32_t* begin, size_t beginSz, const int32_t* at,
+                                       float len, const std::vector<uint32_t>& nodes) const;
+    bool                   findPath(const uint32_t* begin, size_t beginSz, const Tempest::Vec3& exactBegin, uint32_t end,
+                                    float bound, std::vector<uint32_t>& nodes, float& len) const;
 
     const FpIndex&         findFpIndex(std::string_view name) const;
-    const WayPoint*        findFreePoint(float x, float y, float z, const FpIndex &ind,
-                                         const std::function<bool(const WayPoint&)>& filter) const;
   };
+
+template<class F>
+const WayPoint* WayMatrix::findWayPoint(const Tempest::Vec3& at, const F& filter) const {
+  return wayIndex.findNearest(at,std::numeric_limits<float>::max(),filter);
+  }
+
+template<class F>
+const WayPoint* WayMatrix::findWayPoint(const Tempest::Vec3& at, float maxDist, const F& filter) const {
+  return wayIndex.findNearest(at,maxDist,filter);
+  }
+
+template<class F>
+const WayPoint* WayMatrix::findFreePoint(const Tempest::Vec3& at, std::string_view name, const F& filter) const {
+  auto& ind = findFpIndex(name);
+  return ind.index.findNearest(at,distanceThreshold,[&at,&filter](const WayPoint& wp) {
+    const float dz = wp.z-at.z;
+    if(dz*dz>300*300)
+      return false;
+    return bool(filter(wp));
+    });
+  }
@@ -0,0 +1,91 @@
+#include "waypointindex.h"
+
+#include <algorithm>
+
+#include "waypoint.h"
+
+static float component(const WayPoint& wp, uint8_t axis) {
+  switch(axis) {
+    case 0:  return wp.x;
+    case 1:  return wp.y;
+    default: return wp.z;
+    }
+  }
+
+static float component(const Tempest::Vec3& v, uint8_t axis) {
+  switch(axis) {
+    case 0:  return v.x;
+    case 1:  return v.y;
+    default: return v.z;
+    }
+  }
+
+void WayPointIndex::build(std::vector<const WayPoint*> points) {
+  tree = std::move(points);
+  build(tree.data(),tree.size(),0);
+  }
+
+void WayPointIndex::build(const WayPoint** v, size_t cnt, uint8_t depth) {
+  if(cnt<=1)
+    return;
+  const uint8_t axis = uint8_t(depth%3);
+  const size_t  mid  = cnt/2;
+  std::nth_element(v,v+mid,v+cnt,[axis](const WayPoint* a, const WayPoint* b){
+    return component(*a,axis)<component(*b,axis);
+    });
+  build(v,       mid,       uint8_t(depth+1u));
+  build(v+mid+1, cnt-mid-1, uint8_t(depth+1u));
+  }
+
+const WayPoint* WayPointIndex::implFindNearest(const Tempest::Vec3& at, float R, const void* ctx,
+                                               bool (*filter)(const void*, const WayPoint&)) const {
+  struct Item {
+    float    dist  = 0; // point distance or lower bound of subtree distance
+    uint32_t begin = 0;
+    uint32_t end   = 0; // end==0: item is a single point at 'begin'
+    uint8_t  depth = 0;
+    bool operator < (const Item& other) const { return dist>other.dist; }
+    };
+
+  const float       maxDist = R*R;
+  std::vector<Item> heap;
+  heap.reserve(64);
+  if(!tree.empty())
+    heap.push_back(Item{0,0,uint32_t(tree.size()),0});
+
+  while(!heap.empty()) {
+    std::pop_heap(heap.begin(),heap.end());
+    const Item it = heap.back();
+    heap.pop_back();
+    if(it.dist>maxDist)
+      break;
+
+    if(it.end==0) {
+      auto& wp = *tree[it.begin];
+      if(filter(ctx,wp))
+        return &wp;
+      continue;
+      }
+
+    const uint32_t mid  = (it.end-it.begin)/2 + it.begin;
+    auto&          wp   = *tree[mid];
+    const uint8_t  axis = uint8_t(it.depth%3);
+    const float    d    = (wp.position()-at).quadLength();
+    if(d<=maxDist) {
+      heap.push_back(Item{d,mid,0,0});
+      std::push_heap(heap.begin(),heap.end());
+      }
+
+    const float plane = component(at,axis)-component(wp,axis);
+    const float lower = std::max(it.dist, plane*plane);
+    if(it.begin<mid) {
+      heap.push_back(Item{plane<0 ? it.dist : lower, it.begin, mid, uint8_t(it.depth+1u)});
+      std::push_heap(heap.begin(),heap.end());
+      }
+    if(mid+1<it.end) {
+      heap.push_back(Item{plane>0 ? it.dist : lower, mid+1, it.end, uint8_t(it.depth+1u)});
+      std::push_heap(heap.begin(),heap.end());
+      }
+    }
+  return nullptr;
+  }
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <Tempest/Vec>
+
+class WayPoint;
+
+// Static k-d tree over waypoints.
+// Queries are best-first: filter is tested in order of increasing distance, so expensive filters
+// (ray-tests) are evaluated only for a few nearest candidates.
+class WayPointIndex final {
+  public:
+    WayPointIndex() = default;
+
+    void   build(std::vector<const WayPoint*> points);
+    size_t size() const { return tree.size(); }
+
+    template<class F>
+    const WayPoint* findNearest(const Tempest::Vec3& at, float R, const F& filter) const {
+      return implFindNearest(at,R,&filter,[](const void* ctx, const WayPoint& wp) -> bool {
+        auto& f = *reinterpret_cast<const F*>(ctx);
+        return f(wp);
+        });
+      }
+
+  private:
+    std::vector<const WayPoint*> tree;
+
+    void            build(const WayPoint** v, size_t cnt, uint8_t depth);
+    const WayPoint* implFindNearest(const Tempest::Vec3& at, float R, const void* ctx,
+                                    bool (*filter)(const void*, const WayPoint&)) const;
+  };
@@ -8,6 +8,7 @@
 #include <Tempest/Painter>
 
 #include "graphics/mesh/submesh/packedmesh.h"
+#include "world/landcache.h"
 #include "graphics/visualfx.h"
 #include "world/objects/globalfx.h"
 #include "world/objects/npc.h"
@@ -78,14 +79,15 @@ World::World(GameSession& game, std::string_view file, bool startup, std::functi
                                                                : zenkit::GameVersion::GOTHIC_2);
     loadProgress(20);
     auto& worldMesh = world.world_mesh;
+    LandCache cache(wname,*entry->open_read());
 
     auto wdynamicFut = std::async(std::launch::async, [&]() {
       Workers::setThreadName("Loading: BVH thread");
-      return std::unique_ptr<DynamicWorld>(new DynamicWorld(*this,worldMesh));
+      return std::unique_ptr<DynamicWorld>(new DynamicWorld(*this,worldMesh,cache));
       });
     auto wviewFut = std::async(std::launch::async, [&]() {
       Workers::setThreadName("Loading: PackedMesh thread");
-      PackedMesh vmesh(worldMesh,PackedMesh::PK_VisualLnd);
+      PackedMesh vmesh(worldMesh,PackedMesh::PK_VisualLnd,cache);
       return std::unique_ptr<WorldView>(new WorldView(*this,vmesh));
       });
 
@@ -497,7 +499,7 @@ void World::execTriggerEvent(const TriggerEvent& e) {
        e.target=="EVT_RIGHT_ROOM_01_SPAWN_ROT_02_SOUND" ||
        e.target=="NULL")
       return; // known problem on dragonisland.zen, skip for now
-    Tempest::Log::d("unable to process trigger: \"",e.target,"\"");
+    Tempest::Log::d("unable to process trigger: \"",e.target.str(),"\"");
     }
   }
 
@@ -793,8 +795,8 @@ void World::addSound(const zenkit::VirtualObject& vob) {
     }
   }
 
-void World::invalidateVobIndex() {
-  wobj.invalidateVobIndex();
+void World::invalidateVobIndex(Vob& v) {
+  wobj.invalidateVobIndex(v);
   }
 
 const zenkit::IFocus& World::searchPolicy(const Npc& pl, TargetCollect& coll, WorldObjects::SearchFlg& opt) const {
@@ -838,10 +840,6 @@ const WayPoint* World::findWayPoint(const Tempest::Vec3& pos) const {
   return wmatrix->findWayPoint(pos,[](const WayPoint&){ return true; });
   }
 
-const WayPoint* World::findWayPoint(const Tempest::Vec3& pos, const std::function<bool(const WayPoint&)>& f) const {
-  return wmatrix->findWayPoint(pos,f);
-  }
-
 const WayPoint *World::findFreePoint(const Npc &npc, std::string_view name) const {
   if(auto p = npc.currentWayPoint()){
     if(p->isFreePoint() && p->checkName(name)) {
@@ -908,6 +906,10 @@ void World::detectItem(const Tempest::Vec3& p, const float r, const std::functio
   wobj.detectItem(p.x,p.y,p.z,r,f);
   }
 
+Npc* World::findNearestNpc(const Tempest::Vec3& p, const float r, const std::function<bool(Npc&)>& pred) {
+  return wobj.findNearestNpc(p,r,pred);
+  }
+
 WayPath World::wayTo(const Npc &npc, const WayPoint &end) const {
   auto p     = npc.position();
 
@@ -56,7 +56,10 @@ class World final {
 
     const WayPoint*      findPoint(std::string_view name, bool inexact=true) const;
     const WayPoint*      findWayPoint(const Tempest::Vec3& pos) const;
-    const WayPoint*      findWayPoint(const Tempest::Vec3& pos, const std::function<bool(const WayPoint&)>& f) const;
+    template<class F>
+    const WayPoint*      findWayPoint(const Tempest::Vec3& pos, const F& f) const { return wmatrix->findWayPoint(pos,f); }
+    template<class F>
+    const WayPoint*      findWayPoint(const Tempest::Vec3& pos, float maxDist, const F& f) const { return wmatrix->findWayPoint(pos,maxDist,f); }
 
     const WayPoint*      findFreePoint(const Npc& pos,           std::string_view name) const;
     const WayPoint*      findFreePoint(const Tempest::Vec3& pos, std::string_view name) const;
@@ -70,6 +73,8 @@ class World final {
     void                 detectNpcNear(std::function<void(Npc&)> f);
     void                 detectNpc (const Tempest::Vec3& p, const float r, const std::function<void(Npc&)>& f);
     void                 detectItem(const Tempest::Vec3& p, const float r, const std::function<void(Item&)>& f);
+    Npc*                 findNearestNpc(const Tempest::Vec3& p, const float r, const std::function<bool(Npc&)>& pred);
+    void                 invalidateNpcIndex() { wobj.invalidateNpcIndex(); }
 
     WayPath              wayTo(const Npc& pos,const WayPoint& end) const;
 
@@ -100,6 +105,7 @@ class World final {
     MeshObjects::Mesh    addDecalView (const zenkit::VirtualObject& vob);
 
     void                 updateAnimation(uint64_t dt);
+    auto                 animationStats() const -> const WorldObjects::AnimStats& { return wobj.animationStats(); }
     void                 resetPositionToTA();
 
     auto                 takeHero() -> std::unique_ptr<Npc>;
@@ -177,7 +183,7 @@ class World final {
     void                 addFreePoint  (const Tempest::Vec3& pos, const Tempest::Vec3& dir, std::string_view name);
     void                 addSound      (const zenkit::VirtualObject& vob);
 
-    void                 invalidateVobIndex();
+    void                 invalidateVobIndex(Vob& v);
 
   private:
     const zenkit::IFocus& searchPolicy(const Npc& pl, TargetCollect& coll, WorldObjects::SearchFlg& opt) const;
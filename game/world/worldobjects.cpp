@@ -1,6 +1,7 @@
 #include "worldobjects.h"
 
 #include "game/serialize.h"
+#include "game/inventory.h"
 #include "world/objects/itemtorchburning.h"
 #include "world/objects/item.h"
 #include "world/objects/npc.h"
@@ -11,18 +12,30 @@
 #include "world/triggers/triggerworldstart.h"
 #include "world/triggers/abstracttrigger.h"
 #include "world.h"
+#include "graphics/worldview.h"
 #include "utils/workers.h"
 #include "utils/dbgpainter.h"
 #include "gothic.h"
+#include "resources.h"
 
 #include <Tempest/Painter>
 #include <Tempest/Application>
 #include <Tempest/Log>
 
 #include <glm/gtc/type_ptr.hpp>
+#include <atomic>
 
 using namespace Tempest;
 
+// warm up resource caches: equip, drop or weapon-draw of inventory item would load visual synchronously
+static void prefetchVisuals(const Npc& npc, Resources::Priority p) {
+  for(auto it=npc.inventory().iterator(Inventory::T_Inventory); it.isValid(); ++it) {
+    auto& h = it->handle();
+    Resources::prefetch(h.visual,p);
+    Resources::prefetch(h.visual_change,p);
+    }
+  }
+
 int32_t WorldObjects::MobStates::stateByTime(gtime t) const {
   t = t.timeInDay();
   for(size_t i=routines.size(); i>0; ) {
@@ -74,11 +87,14 @@ void WorldObjects::load(Serialize &fin) {
   }
   itemArr.clear();
   items.clear();
+  itmIds.invalidate();
 
   fin.setEntry("worlds/",fin.worldName(),"/npcs");
   uint32_t sz = 0;
   fin.read(sz);
   npcArr.resize(sz);
+  npcIndex.invalidate();
+  npcIds.invalidate();
   for(size_t i=0; i<sz; ++i)
     npcArr[i] = std::make_unique<Npc>(owner,size_t(-1),"");
   for(size_t i=0; i<npcArr.size(); ++i) {
@@ -168,6 +184,7 @@ void WorldObjects::tick(uint64_t dt, uint64_t dtPlayer) {
     std::sort(npcArr.begin(),npcArr.end(),[](std::unique_ptr<Npc>& a, std::unique_ptr<Npc>& b){
       return a->handle().id<b->handle().id;
       });
+    npcIds.invalidate();
     }
 
   auto       camera  = Gothic::inst().camera();
@@ -180,6 +197,7 @@ void WorldObjects::tick(uint64_t dt, uint64_t dtPlayer) {
       continue;
     npc.tick(d);
     }
+  npcIndex.build(npcArr.data(),npcArr.size());
 
   for(auto& i:routines) {
     auto s = i.stateByTime(owner.time());
@@ -223,6 +241,8 @@ void WorldObjects::tick(uint64_t dt, uint64_t dtPlayer) {
     float dist = (i->position()-plPos).quadLength();
     if(dist<nearDist){
       npcNear.push_back(i.get());
+      if(i.get()!=pl && i->processPolicy()!=Npc::ProcessPolicy::AiNormal)
+        prefetchVisuals(*i,Resources::Priority::High);
       if(i.get()!=pl)
         i->setProcessPolicy(Npc::ProcessPolicy::AiNormal);
       } else
@@ -257,27 +277,17 @@ void WorldObjects::tick(uint64_t dt, uint64_t dtPlayer) {
 uint32_t WorldObjects::npcId(const Npc *ptr) const {
   if(ptr==nullptr)
     return uint32_t(-1);
-  for(size_t i=0;i<npcArr.size();++i)
-    if(npcArr[i].get()==ptr)
-      return uint32_t(i);
-  return uint32_t(-1);
+  return npcIds.find(npcArr,ptr,[](const Npc& n) -> const void* { return &n; });
   }
 
 uint32_t WorldObjects::itmId(const void *ptr) const {
-  for(size_t i=0;i<itemArr.size();++i)
-    if(&itemArr[i]->handle()==ptr)
-      return uint32_t(i);
-  return uint32_t(-1);
+  if(ptr==nullptr)
+    return uint32_t(-1);
+  return itmIds.find(itemArr,ptr,[](const Item& i) -> const void* { return &i.handle(); });
   }
 
 uint32_t WorldObjects::mobsiId(const void* ptr) const {
-  uint32_t ret=0;
-  for(auto& i:interactiveObj) {
-    if(i==ptr)
-      return ret;
-    ++ret;
-    }
-  return uint32_t(-1);
+  return interactiveObj.indexOf(static_cast<const Interactive*>(ptr));
   }
 
 Npc* WorldObjects::addNpc(size_t npcInstance, std::string_view at) {
@@ -286,6 +296,7 @@ Npc* WorldObjects::addNpc(size_t npcInstance, std::string_view at) {
     Log::e("addNpc: invalid waypoint");
 
   Npc* npc = new Npc(owner,npcInstance,at);
+  prefetchVisuals(*npc,Resources::Priority::Low);
   if(pos!=nullptr && pos->isLocked()){
     auto p = owner.findNextPoint(*pos);
     if(p)
@@ -310,6 +321,8 @@ Npc* WorldObjects::addNpc(size_t npcInstance, std::string_view at) {
     npc->attachToPoint(pos);
     npc->updateTransform();
     npcArr.emplace_back(npc);
+    npcIndex.invalidate();
+    npcIds.invalidate();
     } else {
     auto& point = owner.deadPoint();
     npc->attachToPoint(nullptr);
@@ -323,11 +336,14 @@ Npc* WorldObjects::addNpc(size_t npcInstance, std::string_view at) {
 
 Npc* WorldObjects::addNpc(size_t npcInstance, const Vec3& pos) {
   Npc* npc = new Npc(owner,npcInstance,"");
+  prefetchVisuals(*npc,Resources::Priority::Low);
   npc->setPosition  (pos.x,pos.y,pos.z);
   //npc->setDirection (pos->dirX,pos->dirY,pos->dirZ);
   npc->updateTransform();
 
   npcArr.emplace_back(npc);
+  npcIndex.invalidate();
+  npcIds.invalidate();
   return npc;
   }
 
@@ -349,6 +365,8 @@ Npc* WorldObjects::insertPlayer(std::unique_ptr<Npc> &&npc, std::string_view at)
   npc->attachToPoint(pos);
   npc->updateTransform();
   npcArr.emplace_back(std::move(npc));
+  npcIndex.invalidate();
+  npcIds.invalidate();
   return npcArr.back().get();
   }
 
@@ -359,6 +377,8 @@ std::unique_ptr<Npc> WorldObjects::takeNpc(const Npc* ptr) {
       auto ret=std::move(npcArr[i]);
       npcArr[i] = std::move(npcArr.back());
       npcArr.pop_back();
+      npcIndex.invalidate();
+      npcIds.invalidate();
       return ret;
       }
     }
@@ -366,11 +386,13 @@ std::unique_ptr<Npc> WorldObjects::takeNpc(const Npc* ptr) {
   }
 
 void WorldObjects::tickNear(uint64_t /*dt*/) {
+  zoneIndex.update(collisionZn.data(),collisionZn.size());
   for(Npc* i:npcNear) {
     auto pos = i->position() + Vec3(0,i->translateY(),0);
-    for(CollisionZone* z:collisionZn)
-      if(z->checkPos(pos))
-        z->onIntersect(*i);
+    zoneIndex.find(pos,[i,&pos](CollisionZone& z){
+      if(z.checkPos(pos))
+        z.onIntersect(*i);
+      });
     }
   }
 
@@ -399,13 +421,13 @@ void WorldObjects::execDelayedEvents() {
   }
 
 bool WorldObjects::execTriggerEvent(const TriggerEvent& e) {
-  bool emitted=false;
+  auto it = triggersByName.find(e.target);
+  if(it==triggersByName.end())
+    return false;
 
-  for(auto& i:triggers) {
+  bool emitted=false;
+  for(auto i:it->second) {
     auto& t = *i;
-    if(t.name()!=e.target)
-      continue; // NOTE: trigger name is not unique - more then one trigger can be activated
-
     const bool hadDelayedEvt = t.hasDelayedEvents();
     t.processEvent(e);
     if(!hadDelayedEvt && t.hasDelayedEvents())
@@ -418,16 +440,81 @@ bool WorldObjects::execTriggerEvent(const TriggerEvent& e) {
 
 void WorldObjects::updateAnimation(uint64_t dt) {
   static bool doAnim=true;
+  static bool doLod =true;
   if(!doAnim)
     return;
   if(dt==0)
     return;
-  Workers::parallelTasks(npcArr,[dt](std::unique_ptr<Npc>& i){
-    i->updateAnimation(dt);
+
+  // frustum of previous frame is good enough for lod selection
+  const Frustrum* fr = nullptr;
+  if(auto view = owner.view()) {
+    fr = &view->sceneGlobals().frustrum[SceneGlobals::V_Main];
+    if(fr->width==0 || fr->height==0)
+      fr = nullptr;
+    }
+
+  const uint64_t        frame = animFrame++;
+  const Npc*            pl    = owner.player();
+  std::atomic<uint32_t> sampled{0};
+  Workers::parallelTasks(npcArr.size(),[this,dt,fr,pl,frame,&sampled](size_t id){
+    auto&          npc    = *npcArr[id];
+    const uint32_t period = doLod ? animationPeriod(npc,pl,fr) : 1;
+    // stagger updates by npc, to spread the work over frames
+    const bool     sample = ((frame+id)%period)==0;
+    const size_t   layers = period>=4 ? 2 : size_t(-1);
+    if(sample)
+      sampled.fetch_add(1,std::memory_order_relaxed);
+    npc.updateAnimation(dt,sample,layers);
     });
-  interactiveObj.parallelFor([dt](Interactive& i){
-    i.updateAnimation(dt);
+  auto mobsi = interactiveObj.begin();
+  Workers::parallelTasks(interactiveObj.size(),[mobsi,dt,fr,frame,&sampled](size_t id){
+    auto&      i      = *mobsi[id];
+    // not visible objects are updated once in 8 frames
+    const bool sample = !doLod || fr==nullptr || fr->testPoint(i.position(),500.f) || ((frame+id)%8)==0;
+    if(sample)
+      sampled.fetch_add(1,std::memory_order_relaxed);
+    i.updateAnimation(dt,sample);
     });
+
+  animStats.total   = uint32_t(npcArr.size()+interactiveObj.size());
+  animStats.sampled = sampled.load();
+  }
+
+uint32_t WorldObjects::animationPeriod(const Npc& npc, const Npc* pl, const Frustrum* fr) {
+  if(npc.processPolicy()==Npc::ProcessPolicy::Player)
+    return 1;
+  // fights and npc around player are visible in shadows, even from behind the camera
+  const float nearR = 1500.f;
+  if(npc.weaponState()!=WeaponState::NoWeapon || npc.isAttack())
+    return 1;
+  if(pl!=nullptr && (npc.position()-pl->position()).quadLength()<nearR*nearR)
+    return 1;
+
+  uint32_t period = 1;
+  switch(npc.processPolicy()) {
+    case Npc::ProcessPolicy::Player:
+    case Npc::ProcessPolicy::AiNormal:
+      period = 1;
+      break;
+    case Npc::ProcessPolicy::AiFar:
+      period = 2;
+      break;
+    case Npc::ProcessPolicy::AiFar2:
+      period = 4;
+      break;
+    }
+
+  if(fr==nullptr)
+    return period;
+
+  float dist = 0;
+  if(!fr->testPoint(npc.position(),250.f,dist))
+    return period*4;
+  // far from camera: half rate at least
+  if(dist>4000.f)
+    period = std::max<uint32_t>(period,2);
+  return period;
   }
 
 bool WorldObjects::isTargeted(Npc& dst) {
@@ -471,28 +558,35 @@ void WorldObjects::detectNpcNear(const std::function<void(Npc&)>& f) {
 
 void WorldObjects::detectNpc(const float x, const float y, const float z,
                              const float r, const std::function<void(Npc&)>& f) {
-  float maxDist=r*r;
-  for(auto& i:npcArr) {
-    auto qDist = (i->position()-Vec3(x,y,z)).quadLength();
-    if(qDist<maxDist)
-      f(*i);
-    }
+  validNpcIndex().find(Vec3(x,y,z),r,f);
   }
 
 void WorldObjects::detectItem(const float x, const float y, const float z,
                               const float r, const std::function<void(Item&)>& f) {
-  float maxDist=r*r;
-  for(auto& i:itemArr) {
-    auto qDist = (i->position()-Vec3(x,y,z)).quadLength();
+  const Vec3  pos     = Vec3(x,y,z);
+  const float maxDist = r*r;
+  items.find(pos,r,[&](Item& i){
+    auto qDist = (i.position()-pos).quadLength();
     if(qDist<maxDist)
-      f(*i);
-    }
+      f(i);
+    });
+  }
+
+Npc* WorldObjects::findNearestNpc(const Vec3& p, const float r, const std::function<bool(Npc&)>& pred) {
+  return validNpcIndex().findNearest(p,r,pred);
+  }
+
+const NpcIndex& WorldObjects::validNpcIndex() {
+  if(!npcIndex.isValid())
+    npcIndex.build(npcArr.data(),npcArr.size());
+  return npcIndex;
   }
 
 void WorldObjects::addTrigger(AbstractTrigger* tg) {
   if(tg->hasVolume())
     triggersZn.emplace_back(tg);
   triggers.emplace_back(tg);
+  triggersByName[Symbol(tg->name())].push_back(tg);
   }
 
 bool WorldObjects::triggerOnStart(bool firstTime) {
@@ -533,9 +627,14 @@ CsCamera* WorldObjects::currentCs() const {
 
 void WorldObjects::enableCollizionZone(CollisionZone& z) {
   collisionZn.push_back(&z);
+  if(!z.isDynamic())
+    zoneIndex.invalidate();
   }
 
 void WorldObjects::disableCollizionZone(CollisionZone& z) {
+  // dynamic tree is rebuilt every tick anyway
+  if(!z.isDynamic())
+    zoneIndex.invalidate();
   for(auto& i:collisionZn)
     if(i==&z) {
       i = collisionZn.back();
@@ -578,6 +677,7 @@ std::unique_ptr<Item> WorldObjects::takeItem(Item &it) {
       auto ret=std::move(i);
       i = std::move(itemArr.back());
       itemArr.pop_back();
+      itmIds.invalidate();
       items.del(ret.get());
       ret->setPhysicsDisable();
       onItemRemoved(*ret);
@@ -645,6 +745,7 @@ Item* WorldObjects::addItem(size_t itemInstance, const Tempest::Vec3& pos, const
   auto* it=ptr.get();
   itemArr.emplace_back(std::move(ptr));
   items.add(itemArr.back().get());
+  itmIds.invalidate();
 
   it->setPosition (pos.x, pos.y, pos.z);
   it->setDirection(dir.x, dir.y, dir.z);
@@ -668,6 +769,7 @@ Item* WorldObjects::addItemDyn(size_t itemInstance, const Tempest::Matrix4x4& po
   it->handle().owner = ownerNpc==size_t(-1) ? 0 : int32_t(ownerNpc);
   itemArr.emplace_back(std::move(ptr));
   items.add(itemArr.back().get());
+  itmIds.invalidate();
 
   it->setObjMatrix(pos);
 
@@ -689,9 +791,10 @@ void WorldObjects::addRoot(const std::shared_ptr<zenkit::VirtualObject>& vob, bo
   rootVobs.emplace_back(std::move(p));
   }
 
-void WorldObjects::invalidateVobIndex() {
-  items.invalidate();
-  interactiveObj.invalidate();
+void WorldObjects::invalidateVobIndex(Vob& v) {
+  // NOTE: vob is a member of at most one index; refit is no-op for the other
+  items.refit(&v);
+  interactiveObj.refit(&v);
   }
 
 Interactive* WorldObjects::validateInteractive(Interactive *def) {
@@ -936,6 +1039,9 @@ void WorldObjects::resetPositionToTA() {
       npc.updateTransform();
       }
     }
+  npcIndex.invalidate();
+  npcIds.invalidate();
+
   for(auto& i:routines) {
     auto s = i.stateByTime(owner.time());
     i.curState = s;
@@ -2,14 +2,19 @@
 
 #include <vector>
 #include <memory>
+#include <unordered_map>
 
 #include <zenkit/vobs/Misc.hh>
 
 #include "bullet.h"
 #include "spaceindex.h"
+#include "npcindex.h"
+#include "idtable.h"
+#include "zoneindex.h"
 #include "game/gametime.h"
 #include "game/perceptionmsg.h"
 #include "game/constants.h"
+#include "utils/symbol.h"
 
 class Npc;
 class Item;
@@ -22,6 +27,7 @@ class TriggerEvent;
 class AbstractTrigger;
 class CsCamera;
 class CollisionZone;
+class Frustrum;
 
 class WorldObjects final {
   public:
@@ -56,7 +62,13 @@ class WorldObjects final {
     Npc*           insertPlayer(std::unique_ptr<Npc>&& npc, std::string_view at);
     auto           takeNpc(const Npc* npc) -> std::unique_ptr<Npc>;
 
+    struct AnimStats final {
+      uint32_t total   = 0; // animated objects
+      uint32_t sampled = 0; // skeletons evaluated in last frame
+      };
+
     void           updateAnimation(uint64_t dt);
+    auto           animationStats() const -> const AnimStats& { return animStats; }
 
     bool           isTargeted(Npc& npc);
     Npc*           findHero();
@@ -64,6 +76,8 @@ class WorldObjects final {
     void           detectNpcNear(const std::function<void(Npc&)>& f);
     void           detectNpc (const float x, const float y, const float z, const float r, const std::function<void(Npc&)>&  f);
     void           detectItem(const float x, const float y, const float z, const float r, const std::function<void(Item&)>& f);
+    Npc*           findNearestNpc(const Tempest::Vec3& p, const float r, const std::function<bool(Npc&)>& pred);
+    void           invalidateNpcIndex() { npcIndex.invalidate(); }
 
     uint32_t       npcId(const Npc *ptr) const;
     size_t         npcCount()    const { return npcArr.size(); }
@@ -109,7 +123,7 @@ class WorldObjects final {
     void           addInteractive(Interactive*         obj);
     void           addStatic     (StaticObj*           obj);
     void           addRoot       (const std::shared_ptr<zenkit::VirtualObject>& vob, bool startup);
-    void           invalidateVobIndex();
+    void           invalidateVobIndex(Vob& v);
 
     Interactive*   validateInteractive(Interactive *def);
     Npc*           validateNpc        (Npc         *def);
@@ -154,6 +168,7 @@ class WorldObjects final {
     World&                             owner;
 
     std::vector<CollisionZone*>        collisionZn;
+    ZoneIndex                          zoneIndex;
     std::vector<std::unique_ptr<Vob>>  rootVobs;
 
     SpaceIndex<Interactive>            interactiveObj;
@@ -168,9 +183,14 @@ class WorldObjects final {
 
     std::vector<std::unique_ptr<Npc>>  npcArr;
     std::vector<std::unique_ptr<Npc>>  npcInvalid;
+    // object -> index in npcArr/itemArr, for save
+    mutable IdTable                    npcIds, itmIds;
     std::vector<Npc*>                  npcNear;
+    NpcIndex                           npcIndex;
 
     std::vector<AbstractTrigger*>      triggers;
+    // NOTE: trigger name is not unique - more then one trigger can be activated
+    std::unordered_map<Symbol,std::vector<AbstractTrigger*>,Symbol::Hash> triggersByName;
     std::vector<AbstractTrigger*>      triggersZn;
     std::vector<AbstractTrigger*>      triggersTk;
     std::vector<AbstractTrigger*>      triggersDef;
@@ -178,6 +198,9 @@ class WorldObjects final {
     std::vector<TriggerEvent>          triggerEvents;
     CsCamera*                          currentCsCamera = nullptr;
 
+    uint64_t                           animFrame = 0;
+    AnimStats                          animStats;
+
     template<class T>
     auto findObj(T &src, const Npc &pl, const SearchOpt& opt) -> typename std::remove_reference<decltype(src[0])>::type;
 
@@ -189,6 +212,8 @@ class WorldObjects final {
     void             setMobState(std::string_view scheme, int32_t st);
     void             passivePerceptionProcess(PerceptionMsg& msg, Npc& npc, Npc& pl);
 
+    const NpcIndex&  validNpcIndex();
+    static uint32_t  animationPeriod(const Npc& npc, const Npc* pl, const Frustrum* fr);
     void             tickNear(uint64_t dt);
     void             tickTriggers(uint64_t dt);
     static bool      isTargetedBy(Npc& npc,Npc& by);
@@ -23,7 +23,6 @@ struct WorldSound::WSound final {
   const SoundFx* eff0 = nullptr;
   const SoundFx* eff1 = nullptr;
 
-  std::string    vobName;
   Tempest::Vec3  pos;
   float          sndRadius      = 2500;
 
@@ -85,7 +84,6 @@ void WorldSound::addZone(const zenkit::VZoneMusic &vob) {
 
 void WorldSound::addSound(const zenkit::VSound &vob) {
   WSound s;
-  s.vobName   = vob.vob_name;
   s.loop      = vob.mode==zenkit::SoundMode::LOOP;
   s.active    = vob.initially_playing;
   s.delay     = uint64_t(vob.random_delay * 1000);
@@ -108,6 +106,7 @@ void WorldSound::addSound(const zenkit::VSound &vob) {
     s.sndEnd   = gtime(24,0);
     }
 
+  worldEffByName[Symbol(vob.vob_name)].push_back(worldEff.size());
   worldEff.emplace_back(std::move(s));
   }
 
@@ -203,17 +202,17 @@ void WorldSound::tick(Npc& player) {
   tickSlot(effect3d);
   for(auto& i:freeSlot)
     tickSlot(*i.second);
+  tickOcclusion();
   tickSoundZone(player);
   }
 
 bool WorldSound::execTriggerEvent(const TriggerEvent& e) {
-  bool emitted=false;
-  for(auto& i:worldEff)
-    if(i.vobName==e.target) {
-      i.active = true;
-      emitted = true;
-      }
-  return emitted;
+  auto it = worldEffByName.find(e.target);
+  if(it==worldEffByName.end())
+    return false;
+  for(auto i:it->second)
+    worldEff[i].active = true;
+  return !it->second.empty();
   }
 
 void WorldSound::tickSoundZone(Npc& player) {
@@ -267,8 +266,10 @@ void WorldSound::tickSoundZone(Npc& player) {
           tag = tag+sep+1;
 
         tags = GameMusic::mkTags(day,mode);
-        if(setMusic(tag,tags))
+        if(setMusic(tag,tags)) {
+          prefetchMusic(tag,tags);
           return;
+          }
         }
   }
 
@@ -296,16 +297,29 @@ void WorldSound::tickSlot(Effect& slot) {
 
   if(slot.ambient) {
     slot.setOcclusion(1.f);
-    } else {
-    auto  dyn  = owner.physic();
-    auto  head = plPos;
-    auto  pos  = slot.pos;
-    float occ  = 1;
-
-    if((pos-head).quadLength()<slot.maxDist*slot.maxDist)
-      occ = dyn->soundOclusion(head, pos);
-    slot.setOcclusion(std::max(0.f,1.f-occ));
+    return;
+    }
+
+  if((slot.pos-plPos).quadLength()>=slot.maxDist*slot.maxDist) {
+    slot.setOcclusion(0.f);
+    return;
     }
+
+  DynamicWorld::RaySegment ray;
+  ray.from = plPos;
+  ray.to   = slot.pos;
+  ray.mask = DynamicWorld::RM_Landscape | DynamicWorld::RM_Water | DynamicWorld::RM_Object | DynamicWorld::RM_Occlusion;
+  occRay .push_back(ray);
+  occSlot.push_back(&slot);
+  }
+
+void WorldSound::tickOcclusion() {
+  occHit.resize(occRay.size());
+  owner.physic()->rayBatch(occRay.data(),occRay.size(),occHit.data());
+  for(size_t i=0; i<occSlot.size(); ++i)
+    occSlot[i]->setOcclusion(std::max(0.f,1.f-occHit[i].occlusion));
+  occSlot.clear();
+  occRay .clear();
   }
 
 void WorldSound::initSlot(WorldSound::Effect& slot) {
@@ -316,6 +330,27 @@ void WorldSound::initSlot(WorldSound::Effect& slot) {
   }
 
 bool WorldSound::setMusic(std::string_view zone, GameMusic::Tags tags) {
+  if(auto* theme = musicTheme(zone,tags)) {
+    GameMusic::inst().setMusic(*theme,tags);
+    return true;
+    }
+  return false;
+  }
+
+void WorldSound::prefetchMusic(std::string_view zone, GameMusic::Tags tags) {
+  // fight/threat themes of current zone are most likely to be requested next
+  const GameMusic::Tags day    = GameMusic::Tags(tags&GameMusic::Ngt);
+  const GameMusic::Tags mode[] = {GameMusic::Std, GameMusic::Thr, GameMusic::Fgt};
+  for(auto m:mode) {
+    auto t = GameMusic::mkTags(day,m);
+    if(t==tags)
+      continue;
+    if(auto* theme = musicTheme(zone,t))
+      GameMusic::inst().prefetch(*theme);
+    }
+  }
+
+const zenkit::IMusicTheme* WorldSound::musicTheme(std::string_view zone, GameMusic::Tags tags) const {
   bool             isDay = (tags&GameMusic::Ngt)==0;
   std::string_view smode = "STD";
   if(tags&GameMusic::Thr)
@@ -324,11 +359,7 @@ bool WorldSound::setMusic(std::string_view zone, GameMusic::Tags tags) {
     smode = "FGT";
 
   string_frm name(zone,'_',(isDay ? "DAY" : "NGT"),'_',smode);
-  if(auto* theme = Gothic::musicDef()[name]) {
-    GameMusic::inst().setMusic(*theme,tags);
-    return true;
-    }
-  return false;
+  return Gothic::musicDef()[name];
   }
 
 bool WorldSound::isInListenerRange(const Tempest::Vec3& pos, float sndRgn) const {
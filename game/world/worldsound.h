@@ -10,6 +10,8 @@
 #include <mutex>
 
 #include "gamemusic.h"
+#include "physics/dynamicworld.h"
+#include "utils/symbol.h"
 
 class GameSession;
 class TriggerEvent;
@@ -62,8 +64,11 @@ class WorldSound final {
     void    tickSoundZone(Npc& player);
     void    tickSlot(std::vector<PEffect>& eff);
     void    tickSlot(Effect& slot);
+    void    tickOcclusion();
     void    initSlot(Effect& slot);
     bool    setMusic(std::string_view zone, GameMusic::Tags tags);
+    void    prefetchMusic(std::string_view zone, GameMusic::Tags tags);
+    auto    musicTheme(std::string_view zone, GameMusic::Tags tags) const -> const zenkit::IMusicTheme*;
 
     Sound   implAddSound(const SoundFx& s, const Tempest::Vec3& pos, float rangeMax);
     Sound   implAddSound(Tempest::SoundEffect&& s, const Tempest::Vec3& pos, float rangeMax);
@@ -84,6 +89,12 @@ class WorldSound final {
     std::vector<PEffect>                    effect;
     std::vector<PEffect>                    effect3d; // snd_play3d
     std::vector<WSound>                     worldEff;
+    std::unordered_map<Symbol,std::vector<size_t>,Symbol::Hash> worldEffByName;
+
+    // occlusion rays of current tick, executed as one batch
+    std::vector<Effect*>                        occSlot;
+    std::vector<DynamicWorld::RaySegment>       occRay;
+    std::vector<DynamicWorld::RayBatchResult>   occHit;
 
     std::mutex                              sync;
 
@@ -0,0 +1,86 @@
+#include "zoneindex.h"
+
+#include <algorithm>
+
+#include "collisionzone.h"
+
+using namespace Tempest;
+
+static float component(const Vec3& v, int axis) {
+  return axis==0 ? v.x : (axis==1 ? v.y : v.z);
+  }
+
+void ZoneIndex::update(CollisionZone*const* zones, size_t count) {
+  // NOTE: zone can only turn from static into dynamic, so it's enough to compare the count
+  tmp.clear();
+  for(size_t i=0; i<count; ++i)
+    if(zones[i]->isDynamic())
+      tmp.push_back(zones[i]);
+  dyn.build(tmp.data(),tmp.size());
+
+  if(valid && stat.size()==count-tmp.size())
+    return;
+
+  tmp.clear();
+  for(size_t i=0; i<count; ++i)
+    if(!zones[i]->isDynamic())
+      tmp.push_back(zones[i]);
+  stat.build(tmp.data(),tmp.size());
+  valid = true;
+  }
+
+void ZoneIndex::Tree::build(CollisionZone*const* zones, size_t count) {
+  nodes.clear();
+  leaf.resize(count);
+  if(count==0)
+    return;
+
+  for(size_t i=0; i<count; ++i) {
+    auto  bb = zones[i]->bbox();
+    auto& l  = leaf[i];
+    l.zone    = zones[i];
+    l.bbox[0] = bb.first;
+    l.bbox[1] = bb.second;
+    l.center  = (bb.first+bb.second)*0.5f;
+    }
+
+  nodes.reserve(2*(count+LeafSize-1)/LeafSize);
+  nodes.emplace_back();
+  split(0,0,uint32_t(count));
+  }
+
+void ZoneIndex::Tree::split(uint32_t node, uint32_t begin, uint32_t end) {
+  Vec3 bmin = leaf[begin].bbox[0], bmax = leaf[begin].bbox[1];
+  Vec3 cmin = leaf[begin].center,  cmax = leaf[begin].center;
+  for(uint32_t i=begin+1; i<end; ++i) {
+    auto& l = leaf[i];
+    bmin = Vec3(std::min(bmin.x,l.bbox[0].x), std::min(bmin.y,l.bbox[0].y), std::min(bmin.z,l.bbox[0].z));
+    bmax = Vec3(std::max(bmax.x,l.bbox[1].x), std::max(bmax.y,l.bbox[1].y), std::max(bmax.z,l.bbox[1].z));
+    cmin = Vec3(std::min(cmin.x,l.center.x),  std::min(cmin.y,l.center.y),  std::min(cmin.z,l.center.z));
+    cmax = Vec3(std::max(cmax.x,l.center.x),  std::max(cmax.y,l.center.y),  std::max(cmax.z,l.center.z));
+    }
+  nodes[node].bbox[0] = bmin;
+  nodes[node].bbox[1] = bmax;
+
+  if(end-begin<=LeafSize) {
+    nodes[node].first = begin;
+    nodes[node].count = end-begin;
+    return;
+    }
+
+  // median split along the longest axis of centers
+  const Vec3 ext  = cmax-cmin;
+  const int  axis = (ext.x>=ext.y && ext.x>=ext.z) ? 0 : (ext.y>=ext.z ? 1 : 2);
+  const uint32_t mid = begin+(end-begin)/2;
+  std::nth_element(leaf.begin()+begin, leaf.begin()+mid, leaf.begin()+end, [axis](const Leaf& a, const Leaf& b){
+    return component(a.center,axis)<component(b.center,axis);
+    });
+
+  const uint32_t left = uint32_t(nodes.size());
+  nodes.emplace_back();
+  nodes.emplace_back();
+  nodes[node].first = left;
+  nodes[node].count = 0;
+  split(left,  begin,mid);
+  split(left+1,mid,  end);
+  }
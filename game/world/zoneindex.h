@@ -0,0 +1,80 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <Tempest/Vec>
+
+class CollisionZone;
+
+// Bounding volume hierarchy over collision zones.
+// Zones that never moved live in a static tree, rebuilt only when zones are added or removed.
+// Moving and growing zones go to a dynamic tree, rebuilt on every update.
+class ZoneIndex final {
+  public:
+    ZoneIndex() = default;
+
+    void   update(CollisionZone*const* zones, size_t count);
+    void   invalidate() { valid = false; }
+
+    // f is invoked for each zone, that contains p
+    template<class F>
+    void   find(const Tempest::Vec3& p, const F& f) const {
+      stat.find(p,f);
+      dyn .find(p,f);
+      }
+
+  private:
+    struct Node {
+      Tempest::Vec3 bbox[2];
+      uint32_t      first = 0; // leaf: first zone; inner: left child, right child is first+1
+      uint32_t      count = 0; // 0 for inner nodes
+      };
+
+    struct Leaf {
+      CollisionZone* zone = nullptr;
+      Tempest::Vec3  bbox[2];
+      Tempest::Vec3  center;
+      };
+
+    struct Tree {
+      std::vector<Node> nodes;
+      std::vector<Leaf> leaf;
+
+      void     build(CollisionZone*const* zones, size_t count);
+      void     split(uint32_t node, uint32_t begin, uint32_t end);
+      size_t   size() const { return leaf.size(); }
+
+      template<class F>
+      void     find(const Tempest::Vec3& p, const F& f) const;
+      };
+
+    static constexpr uint32_t LeafSize = 4;
+
+    Tree                        stat, dyn;
+    std::vector<CollisionZone*> tmp;
+    bool                        valid = false;
+  };
+
+template<class F>
+void ZoneIndex::Tree::find(const Tempest::Vec3& p, const F& f) const {
+  if(nodes.empty())
+    return;
+
+  uint32_t stk[64];
+  uint32_t sp = 0;
+  stk[sp++] = 0;
+  while(sp>0) {
+    auto& n = nodes[stk[--sp]];
+    if(p.x<n.bbox[0].x || p.y<n.bbox[0].y || p.z<n.bbox[0].z ||
+       p.x>n.bbox[1].x || p.y>n.bbox[1].y || p.z>n.bbox[1].z)
+      continue;
+    if(n.count==0) {
+      stk[sp++] = n.first;
+      stk[sp++] = n.first+1;
+      continue;
+      }
+    for(uint32_t i=n.first; i<n.first+n.count; ++i)
+      f(*leaf[i].zone);
+    }
+  }